@@ -0,0 +1,57 @@
+/* Measures how many 7-card hands the bestHand evaluator ranks per second.
+ * A fixed set of random hands is generated up front, so the timed loop only
+ * contains evaluations.
+ * Usage: bestHand_bench [amount of evaluations]
+ */
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+import cards;
+import bestHand;
+
+constexpr std::size_t DISTINCT_HANDS = 1 << 16;
+constexpr std::size_t CARDS_PER_HAND = 7;
+
+int main(int argc, char **argv) {
+  std::size_t evaluations = 50'000'000;
+  if (argc > 1) {
+    evaluations = std::strtoull(argv[1], nullptr, 10);
+  }
+
+  std::mt19937_64 rng(2024);
+  std::vector<Card> hands;
+  hands.reserve(DISTINCT_HANDS * CARDS_PER_HAND);
+  for (std::size_t h = 0; h < DISTINCT_HANDS; h++) {
+    Deck deck;
+    for (std::size_t c = 0; c < CARDS_PER_HAND; c++) {
+      std::uniform_int_distribution<std::size_t> pick(0, deck.size() - 1);
+      std::size_t index = pick(rng);
+      hands.push_back(deck[index]);
+      std::swap(deck[index], deck[deck.size() - 1]);
+      deck.dealCard();
+    }
+  }
+
+  // Warm up the lookup tables before timing.
+  std::uint64_t checksum = evaluateHand(hands.data(), CARDS_PER_HAND);
+
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < evaluations; i++) {
+    const Card *hand = &hands[(i % DISTINCT_HANDS) * CARDS_PER_HAND];
+    checksum += evaluateHand(hand, CARDS_PER_HAND);
+  }
+  auto stop = std::chrono::steady_clock::now();
+
+  double seconds = std::chrono::duration<double>(stop - start).count();
+  std::cout << "Evaluated " << evaluations << " hands in " << seconds
+            << " s\n";
+  std::cout << "Evaluations/sec: " << static_cast<double>(evaluations) / seconds
+            << "\n";
+  std::cout << "Checksum: " << checksum << std::endl;
+  return 0;
+}
@@ -0,0 +1,93 @@
+/* Measures Monte Carlo equity throughput for 1, 2, 4, ... threads up to the
+ * amount of hardware threads, to check that sampling scales with cores.
+ * Afterwards it times single threaded exact equity for heads-up spots on the
+ * flop, turn and river, and range against range equity of every combo on a
+ * flop with 1 and all hardware threads.
+ * Usage: equity_bench [samples per run]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+import cards;
+import threadPool;
+import equity;
+import rangeEquity;
+
+int main(int argc, char **argv) {
+  std::uint64_t samples = 20'000'000;
+  if (argc > 1) {
+    samples = std::strtoull(argv[1], nullptr, 10);
+  }
+
+  std::vector<std::vector<Card>> hands = {
+      {Card(Suit::Hearts, Rank::Ace), Card(Suit::Spades, Rank::King)},
+      {Card(Suit::Clubs, Rank::Queen), Card(Suit::Diamonds, Rank::Queen)},
+      {Card(Suit::Hearts, Rank::Eight), Card(Suit::Hearts, Rank::Nine)}};
+
+  unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+  double singleThreaded = 0;
+  for (unsigned threads = 1;; threads = std::min(threads * 2, hardware)) {
+    ThreadPool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+    EquityResult result = monteCarloEquity(hands, {}, samples, pool, 1);
+    auto stop = std::chrono::steady_clock::now();
+
+    double perSecond = static_cast<double>(samples) /
+                       std::chrono::duration<double>(stop - start).count();
+    if (threads == 1) {
+      singleThreaded = perSecond;
+    }
+    std::cout << threads << " threads: " << perSecond << " samples/sec, "
+              << perSecond / singleThreaded << "x, equity "
+              << result.equity[0] << " / " << result.equity[1] << " / "
+              << result.equity[2] << std::endl;
+    if (threads == hardware) {
+      break;
+    }
+  }
+
+  std::vector<std::vector<Card>> headsUp(hands.begin(), hands.begin() + 2);
+  std::vector<Card> board = {
+      Card(Suit::Spades, Rank::Two), Card(Suit::Hearts, Rank::Seven),
+      Card(Suit::Diamonds, Rank::Jack), Card(Suit::Clubs, Rank::Four),
+      Card(Suit::Spades, Rank::Nine)};
+  const char *streets[] = {"flop", "turn", "river"};
+  for (std::size_t dealt = 3; dealt <= 5; dealt++) {
+    std::vector<Card> partial(board.begin(), board.begin() + dealt);
+    constexpr int repetitions = 200;
+    auto start = std::chrono::steady_clock::now();
+    EquityResult result;
+    for (int r = 0; r < repetitions; r++) {
+      result = exactEquity(headsUp, partial);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    double micros =
+        std::chrono::duration<double, std::micro>(stop - start).count() /
+        repetitions;
+    std::cout << "exact " << streets[dealt - 3] << ": " << micros
+              << " us per call, " << result.samples << " runouts, equity "
+              << result.equity[0] << std::endl;
+  }
+
+  // Range against range on the flop, every combo against every combo.
+  const Range everything = Range::full();
+  const std::vector<Card> flop(board.begin(), board.begin() + 3);
+  for (unsigned threads : {1u, hardware}) {
+    ThreadPool pool(threads);
+    auto start = std::chrono::steady_clock::now();
+    RangeEquityResult result = rangeEquity(everything, everything, flop, pool);
+    auto stop = std::chrono::steady_clock::now();
+    std::cout << "range vs range flop, " << threads << " threads: "
+              << std::chrono::duration<double, std::milli>(stop - start).count()
+              << " ms, " << result.runouts << " runouts, equity "
+              << result.equity << std::endl;
+    if (hardware == 1) {
+      break;
+    }
+  }
+  return 0;
+}
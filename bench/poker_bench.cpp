@@ -0,0 +1,530 @@
+/* Google Benchmark suite for the hot paths of the engine: dealing, hand
+ * evaluation, hand indexing, the valid action and next player lookups of a
+ * game, action dispatch, a full headless hand in a new or a reused game, the
+ * same hand with every decision policy of a game, a random rollout of a
+ * GameState, an MCTS search, a RuleBot decision, a round trip through a bot
+ * process and queueing a log record.
+ * Every benchmark reports allocs/op next to the time per operation, counted
+ * by replacing the global operator new.
+ * Usage: poker_bench [--benchmark_format=json]
+ *        poker_bench --benchmark_out=poker_bench.json
+ *                    --benchmark_out_format=json
+ * The poker_bench_json target runs the second form in the build directory.
+ */
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <span>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include "../tests/testHelpers.hpp"
+import cards;
+import player;
+import bestHand;
+import game;
+import decisionSource;
+import botProtocol;
+import prng;
+import logger;
+import mctsBot;
+import ruleBot;
+
+static std::atomic<std::uint64_t> allocations{0};
+
+// Not inlined, otherwise GCC pairs the malloc with the sized delete calls
+// and warns about mismatched allocation functions.
+[[gnu::noinline]] void *operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+// The default operator delete of libstdc++ releases with std::free, which
+// matches the malloc above, so it doesn't need to be replaced.
+
+/* Reports the allocations made between construction and destruction per
+ * iteration of state.
+ */
+class AllocationCounter {
+private:
+  benchmark::State &state;
+  std::uint64_t start;
+
+public:
+  explicit AllocationCounter(benchmark::State &state)
+      : state(state), start(allocations.load(std::memory_order_relaxed)) {}
+  ~AllocationCounter() {
+    state.counters["allocs/op"] = benchmark::Counter(
+        static_cast<double>(allocations.load(std::memory_order_relaxed) -
+                            start),
+        benchmark::Counter::kAvgIterations);
+  }
+};
+
+static void BM_DeckShuffle(benchmark::State &state) {
+  Deck deck;
+  Xoshiro256 rng(1);
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    deck.resetDeck();
+    deck.shuffleDeck(rng);
+    benchmark::DoNotOptimize(deck[0]);
+  }
+}
+BENCHMARK(BM_DeckShuffle);
+
+// Deals what a six handed hand needs: 12 hole cards, 3 burns and 5 cards.
+static void BM_DeckDealHand(benchmark::State &state) {
+  Deck deck;
+  Xoshiro256 rng(1);
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    deck.resetDeck();
+    for (int i = 0; i < 12; i++) {
+      benchmark::DoNotOptimize(deck.dealCard(rng));
+    }
+    for (int street = 0; street < 3; street++) {
+      deck.burnCard(rng);
+      for (int i = 0; i < (street == 0 ? 3 : 1); i++) {
+        benchmark::DoNotOptimize(deck.dealCard(rng));
+      }
+    }
+  }
+}
+BENCHMARK(BM_DeckDealHand);
+
+static void BM_EvaluateSevenCards(benchmark::State &state) {
+  Xoshiro256 rng(2);
+  std::vector<CardSet> hands;
+  for (int i = 0; i < 1024; i++) {
+    Deck deck;
+    CardSet hand;
+    for (int c = 0; c < 7; c++) {
+      hand.add(deck.dealCard(rng));
+    }
+    hands.push_back(hand);
+  }
+  std::size_t next = 0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(evaluateHand(hands[next++ & 1023]));
+  }
+}
+BENCHMARK(BM_EvaluateSevenCards);
+
+// Indexes random hands of the round given as argument, 0 preflop to 3 river.
+static void BM_HandIndex(benchmark::State &state) {
+  const int round = static_cast<int>(state.range(0));
+  HandIndexer indexer;
+  Xoshiro256 rng(3);
+  std::vector<std::array<Card, 7>> hands(1024);
+  for (auto &hand : hands) {
+    Deck deck;
+    for (Card &card : hand) {
+      card = deck.dealCard(rng);
+    }
+  }
+  std::size_t next = 0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(indexer.index(hands[next++ & 1023].data(), round));
+  }
+}
+BENCHMARK(BM_HandIndex)->DenseRange(0, 3);
+
+// Showdown between state.range(0) players.
+static void BM_DetermineBestHand(benchmark::State &state) {
+  const std::size_t seats = static_cast<std::size_t>(state.range(0));
+  playersPool pool = makePlayers(static_cast<int>(seats));
+  std::vector<std::shared_ptr<Player>> players(pool.begin(), pool.end());
+  Deck deck;
+  Xoshiro256 rng(3);
+  for (auto &player : players) {
+    player->receiveCards(deck.dealCard(rng));
+    player->receiveCards(deck.dealCard(rng));
+  }
+  std::vector<Card> board;
+  for (int i = 0; i < 5; i++) {
+    board.push_back(deck.dealCard(rng));
+  }
+  determineBestHand showdown(players, board);
+
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(showdown.determineWinnerByHandRank());
+  }
+}
+BENCHMARK(BM_DetermineBestHand)->Arg(2)->Arg(6);
+
+static void BM_AllValidAction(benchmark::State &state) {
+  playersPool players = makePlayers(6);
+  gameSettings settings;
+  positions pos{0, 2, 1};
+  HeadlessGame game(players, settings, pos, 4);
+  GameInternals::startHand(game);
+
+  position seat = 0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(GameInternals::allValidAction(game, seat));
+    seat = (seat + 1) % 6;
+  }
+}
+BENCHMARK(BM_AllValidAction);
+
+static void BM_GetNextPlayerInSequence(benchmark::State &state) {
+  playersPool players = makePlayers(6);
+  players[3]->setIsActive(false);
+  gameSettings settings;
+  positions pos{0, 2, 1};
+  HeadlessGame game(players, settings, pos, 5);
+  GameInternals::startHand(game);
+  // Without an action taker every call just looks up the next seat.
+  game.currentPlays.ActionTaker = -1;
+
+  position seat = 0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    game.currentPlays.LastTurnPlayer = seat;
+    benchmark::DoNotOptimize(GameInternals::getNextPlayerInSequence(game));
+    seat = (seat + 1) % 6;
+  }
+}
+BENCHMARK(BM_GetNextPlayerInSequence);
+
+/* Dispatch of one action the way the game did before, a hashed lookup of
+ * actions in a map of std::function that is copied out and called, against
+ * the compile time dispatch of GameInternals::performAction. Both end in
+ * the same handler, checks so the game state doesn't change.
+ */
+static void BM_PerformActionFunctionMap(benchmark::State &state) {
+  playersPool players = makePlayers(6);
+  gameSettings settings;
+  positions pos{0, 2, 1};
+  HeadlessGame game(players, settings, pos, 7);
+  GameInternals::startHand(game);
+  using actionHandler = std::function<void(HeadlessGame *, position, Action)>;
+  std::unordered_map<actions, actionHandler> actionToFunction = {
+      {actions::fold,
+       [](HeadlessGame *g, position seat, Action action) {
+         GameInternals::perform<actions::fold>(*g, seat, action);
+       }},
+      {actions::check,
+       [](HeadlessGame *g, position seat, Action action) {
+         GameInternals::perform<actions::check>(*g, seat, action);
+       }},
+      {actions::call,
+       [](HeadlessGame *g, position seat, Action action) {
+         GameInternals::perform<actions::call>(*g, seat, action);
+       }},
+      {actions::raise,
+       [](HeadlessGame *g, position seat, Action action) {
+         GameInternals::perform<actions::raise>(*g, seat, action);
+       }},
+      {actions::allIn,
+       [](HeadlessGame *g, position seat, Action action) {
+         GameInternals::perform<actions::allIn>(*g, seat, action);
+       }},
+      {actions::bet, [](HeadlessGame *g, position seat, Action action) {
+         GameInternals::perform<actions::bet>(*g, seat, action);
+       }}};
+
+  const Action check{actions::check, 0, 1};
+  position seat = 0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    auto handler = actionToFunction[check.action];
+    handler(&game, seat, check);
+    seat = (seat + 1) % 6;
+  }
+}
+BENCHMARK(BM_PerformActionFunctionMap);
+
+static void BM_PerformAction(benchmark::State &state) {
+  playersPool players = makePlayers(6);
+  gameSettings settings;
+  positions pos{0, 2, 1};
+  HeadlessGame game(players, settings, pos, 7);
+  GameInternals::startHand(game);
+
+  const Action check{actions::check, 0, 1};
+  position seat = 0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    GameInternals::performAction(game, seat, check);
+    benchmark::ClobberMemory();
+    seat = (seat + 1) % 6;
+  }
+}
+BENCHMARK(BM_PerformAction);
+
+// A whole hand at a table of state.range(0) random players, game included.
+static void BM_SimulateHand(benchmark::State &state) {
+  const position seats = static_cast<position>(state.range(0));
+  playersPool players = makePlayers(seats);
+  gameSettings settings;
+  Xoshiro256 decisions(6);
+  std::uint64_t hand = 0;
+
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    for (auto &player : players) {
+      player->setChips(settings.startingChips);
+    }
+    positions pos;
+    pos.dealerPosition = static_cast<position>(hand % seats);
+    pos.posSB = (pos.dealerPosition + 1) % seats;
+    pos.posBB = (pos.dealerPosition + 2) % seats;
+
+    HeadlessGame game(players, settings, pos, hand++);
+    for (position seat = 0; seat < seats; seat++) {
+      game.setStrategy(seat, randomStrategy(decisions));
+    }
+    game.simulateHand();
+    benchmark::DoNotOptimize(game.getPot());
+  }
+}
+BENCHMARK(BM_SimulateHand)->Arg(2)->Arg(6);
+
+/* The same hands played by one game readied with newHand, like Manager does.
+ * After the first hands warmed it up this should allocate nothing, the
+ * arena column shows blocks the hand arena had to take from the heap.
+ */
+static void BM_SimulateHandReused(benchmark::State &state) {
+  const position seats = static_cast<position>(state.range(0));
+  playersPool players = makePlayers(seats);
+  gameSettings settings;
+  Xoshiro256 decisions(6);
+  std::uint64_t hand = 0;
+  HeadlessGame game(players, settings, positions{}, 0);
+  for (position seat = 0; seat < seats; seat++) {
+    game.setStrategy(seat, randomStrategy(decisions));
+  }
+
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    for (auto &player : players) {
+      player->setChips(settings.startingChips);
+    }
+    positions pos;
+    pos.dealerPosition = static_cast<position>(hand % seats);
+    pos.posSB = (pos.dealerPosition + 1) % seats;
+    pos.posBB = (pos.dealerPosition + 2) % seats;
+
+    game.newHand(pos, hand++);
+    game.simulateHand();
+    benchmark::DoNotOptimize(game.getPot());
+  }
+  state.counters["arena"] = benchmark::Counter(
+      static_cast<double>(game.getArena().heapAllocations()),
+      benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SimulateHandReused)->Arg(2)->Arg(6);
+
+// Six handed hands of a reused Game, from seat setup.
+template <typename Game, typename Setup>
+static void playCallDownHands(benchmark::State &state, Setup setup) {
+  playersPool players = makePlayers(6);
+  gameSettings settings;
+  std::uint64_t hand = 0;
+  Game game(players, settings, positions{}, 0);
+  setup(game);
+
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    for (auto &player : players) {
+      player->setChips(settings.startingChips);
+    }
+    positions pos;
+    pos.dealerPosition = static_cast<position>(hand % 6);
+    pos.posSB = (pos.dealerPosition + 1) % 6;
+    pos.posBB = (pos.dealerPosition + 2) % 6;
+
+    game.newHand(pos, hand++);
+    game.simulateHand();
+    benchmark::DoNotOptimize(game.getPot());
+  }
+}
+
+/* What the decision policy costs: range 0 is a std::function strategy, 1 the
+ * virtual DecisionSource, 2 the bot as the Decider of the game.
+ */
+static void BM_DecisionPolicy(benchmark::State &state) {
+  static const auto bot = std::make_shared<const CallDownBot>();
+  static BotSource<const CallDownBot> source(bot);
+  if (state.range(0) == 0) {
+    playCallDownHands<HeadlessGame>(state, [](HeadlessGame &game) {
+      for (position seat = 0; seat < 6; seat++) {
+        game.setStrategy(seat, [](const turnInfo &info) {
+          return bot->decide(info);
+        });
+      }
+    });
+  } else if (state.range(0) == 1) {
+    using VirtualGame = BasicGame<silentIO, DecisionSource>;
+    playCallDownHands<VirtualGame>(state, [](VirtualGame &game) {
+      for (position seat = 0; seat < 6; seat++) {
+        game.setSource(seat, source);
+      }
+    });
+  } else {
+    using DirectGame = BasicGame<silentIO, const CallDownBot>;
+    playCallDownHands<DirectGame>(state, [](DirectGame &game) {
+      for (position seat = 0; seat < 6; seat++) {
+        game.setSource(seat, *bot);
+      }
+    });
+  }
+}
+BENCHMARK(BM_DecisionPolicy)->DenseRange(0, 2);
+
+// The GameState of the first decision of a hand at a table of seats.
+static GameState firstDecision(position seats) {
+  playersPool players = makePlayers(seats);
+  gameSettings settings;
+  HeadlessGame game(players, settings, positions{}, 9);
+  GameState start;
+  for (position seat = 0; seat < seats; seat++) {
+    game.setStrategy(seat, [&](const turnInfo &info) {
+      if (start.isTerminal()) {
+        start = game.exportState();
+      }
+      return Action{actions::fold, 0, info.currentRound};
+    });
+  }
+  game.simulateHand();
+  return start;
+}
+
+/* One rollout of a search: copies the GameState of the first decision of a
+ * hand and plays random legal moves on the copy until the hand is over.
+ */
+static void BM_GameStateRollout(benchmark::State &state) {
+  const GameState start = firstDecision(static_cast<position>(state.range(0)));
+  Xoshiro256 rng(10);
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    GameState rollout = start;
+    rollout.rng = Xoshiro256(rng());
+    while (!rollout.isTerminal()) {
+      const LegalMoves moves = rollout.legalActions();
+      const actions chosen = moves.nth(static_cast<int>(
+          uniformBelow(rng, static_cast<std::uint32_t>(moves.count()))));
+      rollout.apply({chosen, moves.minAmount(chosen), 0});
+    }
+    benchmark::DoNotOptimize(rollout.chips);
+  }
+}
+BENCHMARK(BM_GameStateRollout)->Arg(2)->Arg(6);
+
+/* A search of 1000 iterations on one thread, items/s is MCTS iterations per
+ * second of one core.
+ */
+static void BM_MctsSearch(benchmark::State &state) {
+  const GameState start = firstDecision(static_cast<position>(state.range(0)));
+  MctsSettings settings;
+  settings.budget = std::chrono::seconds(60);
+  settings.iterations = 1000;
+  MctsBot bot(settings, 1);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bot.decide(start));
+  }
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+BENCHMARK(BM_MctsSearch)->Arg(2)->Arg(6)->Unit(benchmark::kMillisecond);
+
+/* One decision of the RuleBot preflop and on the flop of a six handed
+ * table, the target is well under a microsecond.
+ */
+static void BM_RuleBotDecide(benchmark::State &state) {
+  static const RuleBot bot;
+  Player hero("Hero", 200);
+  hero.receiveCards(Card(Suit::Spades, Rank::Queen));
+  hero.receiveCards(Card(Suit::Hearts, Rank::Jack));
+  const std::array<Card, 3> flop = {Card(Suit::Clubs, Rank::Jack),
+                                    Card(Suit::Diamonds, Rank::Seven),
+                                    Card(Suit::Clubs, Rank::Two)};
+  LegalMoves moves;
+  moves.allow(actions::fold, 0, 0);
+  moves.allow(actions::call, 20, 20);
+  moves.allow(actions::raise, 30, 200);
+  moves.allow(actions::allIn, 200, 200);
+  const std::span<const Card> board =
+      state.range(0) == 0 ? std::span<const Card>{} : std::span(flop);
+  const turnInfo info{hero, 3, moves, board, 45, 20, gameStates::flop, 2,
+                      positions{}, 6, 6};
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bot.decide(info));
+  }
+}
+BENCHMARK(BM_RuleBotDecide)->Arg(0)->Arg(1);
+
+/* One turn line to a bot process and one line back, with cat as the bot:
+ * what the arena adds to every decision of an external bot.
+ */
+static void BM_BotPipeRoundTrip(benchmark::State &state) {
+  BotProcess bot("exec cat");
+  const std::string turn = "turn seat 0 street flop moves check call:20\n";
+  std::string reply;
+  for (auto _ : state) {
+    const auto deadline =
+        BotProcess::clock::now() + std::chrono::seconds(1);
+    if (!bot.send(turn, deadline) or !bot.receiveLine(reply, deadline)) {
+      state.SkipWithError("cat didn't answer");
+      break;
+    }
+    benchmark::DoNotOptimize(reply.data());
+  }
+}
+BENCHMARK(BM_BotPipeRoundTrip)->UseRealTime();
+
+// What the engine pays per log record: a compiled out level costs nothing, an
+// enabled one only copies its arguments into the ring.
+static void BM_LogDisabled(benchmark::State &state) {
+  std::int64_t seat = 0;
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    logTrace("Next player in sequence is seat {}", seat++);
+    benchmark::DoNotOptimize(seat);
+  }
+}
+BENCHMARK(BM_LogDisabled);
+
+static void BM_LogEnqueue(benchmark::State &state) {
+  std::ostringstream sink;
+  Logger::instance().setSink(sink);
+  const std::string name = "Player 3";
+  std::int64_t seat = 0;
+  // Also counts the sink growing on the thread of the Logger.
+  AllocationCounter counter(state);
+  for (auto _ : state) {
+    Logger::instance().write(LogLevel::info, "Seat {} ({}) bets {}", seat++,
+                             name, 200);
+    if (seat % 2048 == 0) {
+      state.PauseTiming();
+      Logger::instance().flush();
+      sink.str({});
+      state.ResumeTiming();
+    }
+  }
+  Logger::instance().setSink(std::clog);
+  state.counters["dropped"] =
+      static_cast<double>(Logger::instance().dropped());
+}
+BENCHMARK(BM_LogEnqueue);
+
+BENCHMARK_MAIN();
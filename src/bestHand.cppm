@@ -1,19 +1,412 @@
+/* This file implements showdown evaluation. It does so by providing a hand
+ * evaluator and a class.
+ * evaluateHand: ranks the best 5-card hand out of 5, 6 or 7 cards, given as
+ * Cards or as a CardSet.
+ *    -Flushes are looked up in a table indexed by the 13-bit rank mask of the
+ * flush suit.
+ *    -Every other hand only depends on how many cards of each rank there are.
+ * These rank counts are mapped to a dense index and looked up in a second
+ * table.
+ *    -The returned HandValue is an equivalence class between 1 and 7462, a
+ * higher value is a stronger hand and equal values split the pot.
+ * categoryOf returns the category (pair, flush, ...) of a HandValue.
+ * determineBestHand: decides the winner of a showdown between players.
+ */
 module;
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <span>
 #include <stdexcept> // for std::runtime_error
+#include <string>
 #include <vector>
 
-#include <memory>
-
 export module bestHand;
 import player;
 import cards;
 
+export using HandValue = std::uint16_t;
+
+export enum class HandCategory {
+  HighCard,
+  OnePair,
+  TwoPair,
+  ThreeOfAKind,
+  Straight,
+  Flush,
+  FullHouse,
+  FourOfAKind,
+  StraightFlush
+};
+
+namespace {
+
+constexpr int RANKS = 13;
+constexpr int MIN_CARDS = 5;
+constexpr int MAX_CARDS = 7;
+constexpr int MAX_PER_RANK = 4;
+
+// Number of rank-count vectors over n ranks that hold exactly k cards, with at
+// most four cards of every rank.
+using countTable = std::array<std::array<std::uint32_t, MAX_CARDS + 1>,
+                              RANKS + 1>;
+
+constexpr countTable buildCountTable() {
+  countTable dp{};
+  dp[0][0] = 1;
+  for (int n = 1; n <= RANKS; n++) {
+    for (int k = 0; k <= MAX_CARDS; k++) {
+      for (int c = 0; c <= MAX_PER_RANK and c <= k; c++) {
+        dp[n][k] += dp[n - 1][k - c];
+      }
+    }
+  }
+  return dp;
+}
+
+constexpr countTable vectorsWithCards = buildCountTable();
+
+// Strengths are built as category << 20 followed by five 4-bit ranks, so a
+// plain integer comparison orders two hands. They get compressed into the
+// dense HandValue classes once all of them are known.
+constexpr std::uint32_t packStrength(HandCategory category,
+                                     std::initializer_list<int> ranks) {
+  std::uint32_t strength = static_cast<std::uint32_t>(category);
+  int used = 0;
+  for (int r : ranks) {
+    strength = (strength << 4) | static_cast<std::uint32_t>(r);
+    used++;
+  }
+  for (; used < 5; used++) {
+    strength <<= 4;
+  }
+  return strength;
+}
+
+// Returns the highest card of a straight in the rank mask, or -1.
+constexpr int straightTop(std::uint16_t mask) {
+  for (int top = RANKS - 1; top >= 4; top--) {
+    std::uint16_t window = static_cast<std::uint16_t>(0x1F << (top - 4));
+    if ((mask & window) == window) {
+      return top;
+    }
+  }
+  // The wheel: A-2-3-4-5 plays as a five high straight.
+  constexpr std::uint16_t wheel = (1u << 12) | 0xF;
+  if ((mask & wheel) == wheel) {
+    return 3;
+  }
+  return -1;
+}
+
+// Strength of the best flush or straight flush inside one suit.
+std::uint32_t flushStrength(std::uint16_t suitMask) {
+  int top = straightTop(suitMask);
+  if (top >= 0) {
+    return packStrength(HandCategory::StraightFlush, {top});
+  }
+  std::uint32_t strength = static_cast<std::uint32_t>(HandCategory::Flush);
+  int taken = 0;
+  for (int r = RANKS - 1; r >= 0 and taken < 5; r--) {
+    if (suitMask & (1u << r)) {
+      strength = (strength << 4) | static_cast<std::uint32_t>(r);
+      taken++;
+    }
+  }
+  return strength;
+}
+
+// Strength of the best non-flush hand given how often every rank occurs.
+std::uint32_t countsStrength(const std::array<int, RANKS> &counts) {
+  std::uint16_t present = 0;
+  for (int r = 0; r < RANKS; r++) {
+    if (counts[r] > 0) {
+      present |= static_cast<std::uint16_t>(1u << r);
+    }
+  }
+
+  // Highest ranks that occur at least `atLeast` times, skipping `skip`.
+  auto highest = [&](int atLeast, int skipA = -1, int skipB = -1) {
+    for (int r = RANKS - 1; r >= 0; r--) {
+      if (counts[r] >= atLeast and r != skipA and r != skipB) {
+        return r;
+      }
+    }
+    return -1;
+  };
+
+  int quads = highest(4);
+  if (quads >= 0) {
+    return packStrength(HandCategory::FourOfAKind, {quads, highest(1, quads)});
+  }
+
+  int trips = highest(3);
+  if (trips >= 0) {
+    int pair = highest(2, trips);
+    if (pair >= 0) {
+      return packStrength(HandCategory::FullHouse, {trips, pair});
+    }
+  }
+
+  int top = straightTop(present);
+  if (top >= 0) {
+    return packStrength(HandCategory::Straight, {top});
+  }
+
+  if (trips >= 0) {
+    int first = highest(1, trips);
+    return packStrength(HandCategory::ThreeOfAKind,
+                        {trips, first, highest(1, trips, first)});
+  }
+
+  int highPair = highest(2);
+  if (highPair >= 0) {
+    int lowPair = highest(2, highPair);
+    if (lowPair >= 0) {
+      return packStrength(HandCategory::TwoPair,
+                          {highPair, lowPair, highest(1, highPair, lowPair)});
+    }
+    std::uint32_t strength = static_cast<std::uint32_t>(HandCategory::OnePair);
+    strength = (strength << 4) | static_cast<std::uint32_t>(highPair);
+    int taken = 0;
+    for (int r = RANKS - 1; r >= 0 and taken < 3; r--) {
+      if (counts[r] > 0 and r != highPair) {
+        strength = (strength << 4) | static_cast<std::uint32_t>(r);
+        taken++;
+      }
+    }
+    return strength << 4;
+  }
+
+  std::uint32_t strength = static_cast<std::uint32_t>(HandCategory::HighCard);
+  int taken = 0;
+  for (int r = RANKS - 1; r >= 0 and taken < 5; r--) {
+    if (counts[r] > 0) {
+      strength = (strength << 4) | static_cast<std::uint32_t>(r);
+      taken++;
+    }
+  }
+  return strength;
+}
+
+/* All lookup tables used by evaluateHand.
+ *    -flush maps the rank mask of a suit holding 5 or more cards to its value.
+ *    -noFlush holds one block per amount of cards (5, 6, 7), indexed by the
+ * dense rank-count index.
+ *    -digitOffset[i][k][q] is what rank i adds to that index when it holds q
+ * cards while k cards are left to place on ranks 0..i.
+ *    -categoryStart[c] is the lowest HandValue of category c.
+ */
+struct HandTables {
+  std::array<HandValue, 1u << RANKS> flush{};
+  std::vector<HandValue> noFlush;
+  std::array<std::uint32_t, MAX_CARDS + 1> noFlushBase{};
+  std::array<std::array<std::array<std::uint32_t, MAX_PER_RANK + 1>,
+                        MAX_CARDS + 1>,
+             RANKS>
+      digitOffset{};
+  std::array<HandValue, 9> categoryStart{};
+};
+
+// Visits every rank-count vector holding `cards` cards in index order.
+template <typename Visitor>
+void forEachCountVector(int cards, Visitor &&visit) {
+  std::array<int, RANKS> counts{};
+  auto recurse = [&](auto &&self, int rank, int left) -> void {
+    if (rank < 0) {
+      if (left == 0) {
+        visit(counts);
+      }
+      return;
+    }
+    for (int q = 0; q <= MAX_PER_RANK and q <= left; q++) {
+      counts[rank] = q;
+      self(self, rank - 1, left - q);
+    }
+    counts[rank] = 0;
+  };
+  recurse(recurse, RANKS - 1, cards);
+}
+
+HandTables buildHandTables() {
+  HandTables tables;
+
+  for (int i = 0; i < RANKS; i++) {
+    for (int k = 0; k <= MAX_CARDS; k++) {
+      std::uint32_t offset = 0;
+      for (int q = 0; q <= MAX_PER_RANK; q++) {
+        tables.digitOffset[i][k][q] = offset;
+        if (q <= k) {
+          offset += vectorsWithCards[i][k - q];
+        }
+      }
+    }
+  }
+
+  // First pass: raw strengths for every table slot.
+  std::vector<std::uint32_t> flushStrengths(tables.flush.size(), 0);
+  for (std::uint32_t mask = 0; mask < tables.flush.size(); mask++) {
+    if (std::popcount(mask) >= MIN_CARDS) {
+      flushStrengths[mask] =
+          flushStrength(static_cast<std::uint16_t>(mask));
+    }
+  }
+
+  std::vector<std::uint32_t> noFlushStrengths;
+  std::uint32_t base = 0;
+  for (int cards = MIN_CARDS; cards <= MAX_CARDS; cards++) {
+    tables.noFlushBase[cards] = base;
+    base += vectorsWithCards[RANKS][cards];
+    forEachCountVector(cards, [&](const std::array<int, RANKS> &counts) {
+      noFlushStrengths.push_back(countsStrength(counts));
+    });
+  }
+
+  // Second pass: compress strengths into consecutive classes.
+  std::vector<std::uint32_t> distinct(noFlushStrengths);
+  for (std::uint32_t s : flushStrengths) {
+    if (s != 0) {
+      distinct.push_back(s);
+    }
+  }
+  std::sort(distinct.begin(), distinct.end());
+  distinct.erase(std::unique(distinct.begin(), distinct.end()),
+                 distinct.end());
+
+  auto classOf = [&](std::uint32_t strength) {
+    auto it = std::lower_bound(distinct.begin(), distinct.end(), strength);
+    return static_cast<HandValue>(it - distinct.begin() + 1);
+  };
+
+  for (std::size_t mask = 0; mask < tables.flush.size(); mask++) {
+    if (flushStrengths[mask] != 0) {
+      tables.flush[mask] = classOf(flushStrengths[mask]);
+    }
+  }
+  tables.noFlush.reserve(noFlushStrengths.size());
+  for (std::uint32_t s : noFlushStrengths) {
+    tables.noFlush.push_back(classOf(s));
+  }
+
+  tables.categoryStart.fill(static_cast<HandValue>(distinct.size() + 1));
+  for (std::size_t i = distinct.size(); i-- > 0;) {
+    tables.categoryStart[distinct[i] >> 20] = static_cast<HandValue>(i + 1);
+  }
+  return tables;
+}
+
+const HandTables &handTables() {
+  static const HandTables tables = buildHandTables();
+  return tables;
+}
+
+// Ranks a hand without a flush from how many cards every rank holds.
+HandValue evaluateRankCounts(const std::array<std::uint8_t, RANKS> &counts,
+                             int count) {
+  const HandTables &tables = handTables();
+  std::uint32_t index = tables.noFlushBase[count];
+  int left = count;
+  for (int i = RANKS - 1; i >= 0; i--) {
+    index += tables.digitOffset[i][left][counts[i]];
+    left -= counts[i];
+  }
+  return tables.noFlush[index];
+}
+
+} // namespace
+
+/* Ranks the best 5-card hand that can be made from `count` cards held as one
+ * 13-bit rank mask per suit. `count` has to be between 5 and 7.
+ */
+export HandValue evaluateSuitMasks(const std::array<std::uint16_t, 4> &suits,
+                                   int count) {
+  // With at most 7 cards, a hand holding a flush can't hold a full house or
+  // quads, so the flush table alone decides it.
+  for (std::uint16_t suitMask : suits) {
+    if (std::popcount(suitMask) >= MIN_CARDS) {
+      return handTables().flush[suitMask];
+    }
+  }
+
+  std::array<std::uint8_t, RANKS> counts;
+  for (int i = 0; i < RANKS; i++) {
+    counts[i] = static_cast<std::uint8_t>(
+        ((suits[0] >> i) & 1) + ((suits[1] >> i) & 1) +
+        ((suits[2] >> i) & 1) + ((suits[3] >> i) & 1));
+  }
+  return evaluateRankCounts(counts, count);
+}
+
+/* Ranks the best 5-card hand out of the given cards. Between 5 and 7 cards
+ * are expected, duplicates aren't allowed.
+ */
+export HandValue evaluateHand(const Card *cards, std::size_t count) {
+  if (count < MIN_CARDS or count > MAX_CARDS) {
+    throw std::invalid_argument("A hand is evaluated from 5 to 7 cards.");
+  }
+  std::array<std::uint16_t, 4> suits{};
+  std::array<std::uint8_t, 4> perSuit{};
+  std::array<std::uint8_t, RANKS> counts{};
+  for (std::size_t i = 0; i < count; i++) {
+    int suit = static_cast<int>(cards[i].getSuit());
+    int rank = static_cast<int>(cards[i].getRank()) - static_cast<int>(Rank::Two);
+    suits[suit] |= static_cast<std::uint16_t>(1u << rank);
+    perSuit[suit]++;
+    counts[rank]++;
+  }
+  for (int suit = 0; suit < 4; suit++) {
+    if (perSuit[suit] >= MIN_CARDS) {
+      return handTables().flush[suits[suit]];
+    }
+  }
+  return evaluateRankCounts(counts, static_cast<int>(count));
+}
+
+export HandValue evaluateHand(const std::vector<Card> &cards) {
+  return evaluateHand(cards.data(), cards.size());
+}
+
+// Ranks the best 5-card hand in a set holding 5 to 7 cards.
+export HandValue evaluateHand(CardSet cards) {
+  int count = cards.size();
+  if (count < MIN_CARDS or count > MAX_CARDS) {
+    throw std::invalid_argument("A hand is evaluated from 5 to 7 cards.");
+  }
+  return evaluateSuitMasks({cards.suitMask(Suit::Clubs),
+                            cards.suitMask(Suit::Diamonds),
+                            cards.suitMask(Suit::Hearts),
+                            cards.suitMask(Suit::Spades)},
+                           count);
+}
+
+// Returns the category of a HandValue, e.g. HandCategory::FullHouse.
+export HandCategory categoryOf(HandValue value) {
+  const auto &start = handTables().categoryStart;
+  int category = static_cast<int>(HandCategory::StraightFlush);
+  while (category > 0 and value < start[category]) {
+    category--;
+  }
+  return static_cast<HandCategory>(category);
+}
+
+export std::string categoryToString(HandCategory category) {
+  static const std::string names[] = {
+      "High Card",  "One Pair", "Two Pair",   "Three of a Kind",
+      "Straight",   "Flush",    "Full House", "Four of a Kind",
+      "Straight Flush"};
+  return names[static_cast<int>(category)];
+}
+
 // Add 'export' keyword before the class declaration
 export class determineBestHand {
 private:
   // Store references to a vector of shared_ptr<Player> and the community cards.
   const std::vector<std::shared_ptr<Player>> &players;
-  const std::vector<Card> &communityCards;
+  std::span<const Card> communityCards;
 
   // Return all players who haven't folded and are still active.
   std::vector<std::shared_ptr<Player>> DetermineActiveHands() const {
@@ -53,12 +446,31 @@ private:
   }
 
 public:
-  // Constructor now takes a reference to a vector of shared_ptr<Player> and a
-  // reference to community cards
+  // Constructor now takes a reference to a vector of shared_ptr<Player> and
+  // the community cards.
   determineBestHand(const std::vector<std::shared_ptr<Player>> &players_,
-                    const std::vector<Card> &communityCards_)
+                    std::span<const Card> communityCards_)
       : players(players_), communityCards(communityCards_) {}
 
+  // Ranks one player's hole cards together with the community cards.
+  HandValue evaluatePlayer(const Player &player) const {
+    std::array<std::uint16_t, 4> suits{};
+    int count = 0;
+    for (std::span<const Card> cards :
+         {std::span<const Card>(player.getHand()), communityCards}) {
+      for (const auto &c : cards) {
+        suits[static_cast<int>(c.getSuit())] |= static_cast<std::uint16_t>(
+            1u << (static_cast<int>(c.getRank()) -
+                   static_cast<int>(Rank::Two)));
+        count++;
+      }
+    }
+    if (count < MIN_CARDS or count > MAX_CARDS) {
+      throw std::runtime_error("A showdown needs 5 to 7 cards per player.");
+    }
+    return evaluateSuitMasks(suits, count);
+  }
+
   // Determine the winner by comparing only the highest single card among active
   // players.
   std::shared_ptr<Player> determineWinnerByHighestCard() const {
@@ -84,4 +496,27 @@ public:
     // Return pointer to the winning player
     return bestPlayer;
   }
-};
\ No newline at end of file
+
+  // Determine the winner by ranking every active player's best 5-card hand.
+  // On equal hands the player seated first wins.
+  std::shared_ptr<Player> determineWinnerByHandRank() const {
+    std::shared_ptr<Player> bestPlayer = nullptr;
+    HandValue bestValue = 0;
+
+    for (auto &p : players) {
+      if (p->hasPlayerFolded() or !p->getIsActive()) {
+        continue;
+      }
+      HandValue value = evaluatePlayer(*p);
+      if (value > bestValue) {
+        bestValue = value;
+        bestPlayer = p;
+      }
+    }
+
+    if (!bestPlayer) {
+      throw std::runtime_error("No active players in the showdown.");
+    }
+    return bestPlayer;
+  }
+};
@@ -0,0 +1,484 @@
+/* This file implements playing against bots that run as processes of their
+ * own, over their stdin and stdout.
+ * The protocol:
+ *    -The engine starts with the line "poker line" or "poker binary" and the
+ * bot answers "ready". Everything after that is in the chosen mode.
+ *    -line: every turn is one line of formatTurn, the answer one line that
+ * parseAction reads (see decisionSource).
+ *    -binary: every message is a frame, a 4 byte little endian length and
+ * the payload. A turn is the TURN_PAYLOAD_BYTES of appendTurnFrame, an
+ * answer the action (its number in the actions enum) in 1 byte and the
+ * amount in 4, 0 for the least amount.
+ *    -The engine closing stdin ends the game, the bot should exit then.
+ * BotProcess: Starts a command through /bin/sh with pipes to its stdin and
+ * stdout. Both pipes are non-blocking, every send and receive waits with
+ * poll until a deadline at most.
+ *    -A reply that arrives after its deadline is dropped when it comes in,
+ * the next receive reads the reply to the next message.
+ *    -A bot that exits, sends a line or frame that is too long, or takes
+ * part of a message before its deadline passes is broken, nothing is sent
+ * to it anymore.
+ *    -Starting a process ignores SIGPIPE in the whole program, a bot that
+ * exited shows up as a failed send instead.
+ *    -The destructor closes the pipes, gives the bot 100 ms to exit and then
+ * kills it.
+ * ProcessSource: A DecisionSource that asks a BotProcess, every answer has to
+ * arrive within the timeout of a move. A missing, late, unreadable or illegal
+ * answer checks or folds and counts as a fault. Keeps how long the round
+ * trips took.
+ */
+module;
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+export module botProtocol;
+import cards;
+import game;
+import player;
+import decisionSource;
+
+export enum class ProtocolMode { line, binary };
+
+export constexpr std::size_t TURN_PAYLOAD_BYTES =
+    4 + 5 * 4 + 2 + 1 + 5 + 1 + 2 * ACTION_COUNT * 4;
+export constexpr std::size_t TURN_FRAME_BYTES = 4 + TURN_PAYLOAD_BYTES;
+export constexpr std::size_t ACTION_PAYLOAD_BYTES = 5;
+// Longer lines and frames break the bot, nothing it sends is that long.
+export constexpr std::size_t MAX_BOT_MESSAGE_BYTES = 4096;
+
+/* A turn as a bot reads it from a binary frame. */
+export struct TurnMessage {
+  position seat = 0;
+  gameStates street = gameStates::preFlop;
+  int playersInHand = 0;
+  int seats = 0;
+  std::uint32_t round = 0;
+  money pot = 0;
+  money highestBet = 0;
+  money bet = 0;
+  money chips = 0;
+  std::array<Card, 2> hole{};
+  int boardCards = 0;
+  std::array<Card, 5> board{};
+  LegalMoves moves;
+};
+
+void appendLittleU32(std::string &out, std::uint32_t value) {
+  for (int shift = 0; shift < 32; shift += 8) {
+    out += static_cast<char>((value >> shift) & 0xff);
+  }
+}
+
+std::uint32_t littleU32(const char *bytes) {
+  std::uint32_t value = 0;
+  for (int i = 3; i >= 0; i--) {
+    value = value << 8 | static_cast<unsigned char>(bytes[i]);
+  }
+  return value;
+}
+
+/* Appends the turn as a frame: seat, street, players in hand and seats a
+ * byte each, then round, pot, highest bet, bet and chips, the hole cards,
+ * the amount of board cards and 5 board cards a byte each (Card::toIndex),
+ * the mask of the legal moves and their least and most amounts by action.
+ */
+export void appendTurnFrame(std::string &out, const turnInfo &info) {
+  appendLittleU32(out, static_cast<std::uint32_t>(TURN_PAYLOAD_BYTES));
+  out += static_cast<char>(info.seat);
+  out += static_cast<char>(info.gameState);
+  out += static_cast<char>(info.playersInHand);
+  out += static_cast<char>(info.seats);
+  appendLittleU32(out, static_cast<std::uint32_t>(info.currentRound));
+  appendLittleU32(out, info.pot);
+  appendLittleU32(out, info.highestBet);
+  appendLittleU32(out, info.player.getCurrentBet());
+  appendLittleU32(out, info.player.getChips());
+  const std::vector<Card> &hand = info.player.getHand();
+  for (std::size_t i = 0; i < 2; i++) {
+    out += static_cast<char>(i < hand.size() ? hand[i].toIndex() : 0);
+  }
+  out += static_cast<char>(info.communityCards.size());
+  for (std::size_t i = 0; i < 5; i++) {
+    out += static_cast<char>(
+        i < info.communityCards.size() ? info.communityCards[i].toIndex() : 0);
+  }
+  out += static_cast<char>(info.validMoves.mask);
+  for (int act = 0; act < ACTION_COUNT; act++) {
+    appendLittleU32(out, info.validMoves.minAmount(static_cast<actions>(act)));
+  }
+  for (int act = 0; act < ACTION_COUNT; act++) {
+    appendLittleU32(out, info.validMoves.maxAmount(static_cast<actions>(act)));
+  }
+}
+
+/* Reads the payload of a turn frame. Throws std::invalid_argument when it
+ * isn't one.
+ */
+export TurnMessage readTurnPayload(std::string_view payload) {
+  if (payload.size() != TURN_PAYLOAD_BYTES) {
+    throw std::invalid_argument("A turn frame has the wrong length.");
+  }
+  auto byte = [&payload](std::size_t at) {
+    return static_cast<unsigned char>(payload[at]);
+  };
+  auto card = [&byte](std::size_t at) {
+    if (byte(at) >= DECK_SIZE) {
+      throw std::invalid_argument("A turn frame has a card that isn't one.");
+    }
+    return Card::fromIndex(byte(at));
+  };
+
+  TurnMessage turn;
+  turn.seat = byte(0);
+  if (byte(1) > static_cast<int>(gameStates::showDown)) {
+    throw std::invalid_argument("A turn frame has an unknown street.");
+  }
+  turn.street = static_cast<gameStates>(byte(1));
+  turn.playersInHand = byte(2);
+  turn.seats = byte(3);
+  turn.round = littleU32(payload.data() + 4);
+  turn.pot = littleU32(payload.data() + 8);
+  turn.highestBet = littleU32(payload.data() + 12);
+  turn.bet = littleU32(payload.data() + 16);
+  turn.chips = littleU32(payload.data() + 20);
+  turn.hole = {card(24), card(25)};
+  turn.boardCards = byte(26);
+  if (turn.boardCards > 5) {
+    throw std::invalid_argument("A turn frame has more than 5 board cards.");
+  }
+  for (int i = 0; i < turn.boardCards; i++) {
+    turn.board[i] = card(27 + i);
+  }
+  const std::uint8_t mask = byte(32);
+  const std::size_t least = 33;
+  const std::size_t most = least + ACTION_COUNT * 4;
+  for (int act = 0; act < ACTION_COUNT; act++) {
+    if (mask & (1u << act)) {
+      turn.moves.allow(static_cast<actions>(act),
+                       littleU32(payload.data() + least + act * 4),
+                       littleU32(payload.data() + most + act * 4));
+    }
+  }
+  return turn;
+}
+
+export void appendActionFrame(std::string &out, actions act, money amount) {
+  appendLittleU32(out, static_cast<std::uint32_t>(ACTION_PAYLOAD_BYTES));
+  out += static_cast<char>(act);
+  appendLittleU32(out, amount);
+}
+
+/* Reads the payload of an answer frame. Throws std::invalid_argument when it
+ * isn't one or not one of moves.
+ */
+export Action readActionPayload(std::string_view payload,
+                                const LegalMoves &moves, size_t currentRound) {
+  if (payload.size() != ACTION_PAYLOAD_BYTES or
+      static_cast<unsigned char>(payload[0]) >= ACTION_COUNT) {
+    throw std::invalid_argument("Not an answer frame.");
+  }
+  return answerOf(static_cast<actions>(payload[0]),
+                  littleU32(payload.data() + 1), moves, currentRound);
+}
+
+export class BotProcess {
+public:
+  using clock = std::chrono::steady_clock;
+
+private:
+  pid_t pid = -1;
+  int toBot = -1;
+  int fromBot = -1;
+  std::string inbox;
+  std::size_t lateReplies = 0;
+  bool broken = false;
+
+  /* Waits until fd is ready for events or deadline passed, false for the
+   * deadline.
+   */
+  static bool await(int fd, short events, clock::time_point deadline) {
+    while (true) {
+      const auto left = deadline - clock::now();
+      if (left <= clock::duration::zero()) {
+        return false;
+      }
+      // Rounded up, a poll never returns before the deadline.
+      const auto millis =
+          std::chrono::ceil<std::chrono::milliseconds>(left).count();
+      pollfd waiting{fd, events, 0};
+      const int ready = ::poll(&waiting, 1, static_cast<int>(millis));
+      if (ready > 0) {
+        return true;
+      }
+      if (ready < 0 and errno != EINTR) {
+        return false;
+      }
+    }
+  }
+
+  // Moves a line out of the inbox into out, false when there is none yet.
+  bool takeLine(std::string &out) {
+    const std::size_t end = inbox.find('\n');
+    if (end == std::string::npos) {
+      broken = broken or inbox.size() > MAX_BOT_MESSAGE_BYTES;
+      return false;
+    }
+    std::size_t length = end;
+    if (length > 0 and inbox[length - 1] == '\r') {
+      length--;
+    }
+    out.assign(inbox, 0, length);
+    inbox.erase(0, end + 1);
+    return true;
+  }
+
+  // Moves a frame payload out of the inbox into out.
+  bool takeFrame(std::string &out) {
+    if (inbox.size() < 4) {
+      return false;
+    }
+    const std::uint32_t length = littleU32(inbox.data());
+    if (length > MAX_BOT_MESSAGE_BYTES) {
+      broken = true;
+      return false;
+    }
+    if (inbox.size() < 4 + length) {
+      return false;
+    }
+    out.assign(inbox, 4, length);
+    inbox.erase(0, 4 + length);
+    return true;
+  }
+
+  template <typename Take>
+  bool receive(std::string &out, clock::time_point deadline, Take take) {
+    char buffer[MAX_BOT_MESSAGE_BYTES];
+    while (true) {
+      while ((this->*take)(out)) {
+        if (lateReplies == 0) {
+          return true;
+        }
+        lateReplies--;
+      }
+      if (broken or !await(fromBot, POLLIN, deadline)) {
+        return false;
+      }
+      const ssize_t got = ::read(fromBot, buffer, sizeof(buffer));
+      if (got > 0) {
+        inbox.append(buffer, static_cast<std::size_t>(got));
+      } else if (got == 0 or (errno != EAGAIN and errno != EINTR)) {
+        broken = true;
+        return false;
+      }
+    }
+  }
+
+public:
+  /* Starts command with /bin/sh -c. Throws std::system_error when the pipes
+   * or the process can't be made.
+   */
+  explicit BotProcess(const std::string &command) {
+    static const bool ignoringPipes = [] {
+      std::signal(SIGPIPE, SIG_IGN);
+      return true;
+    }();
+    (void)ignoringPipes;
+
+    int input[2];
+    int output[2];
+    if (::pipe2(input, O_CLOEXEC) != 0) {
+      throw std::system_error(errno, std::generic_category(), "pipe");
+    }
+    if (::pipe2(output, O_CLOEXEC) != 0) {
+      const int error = errno;
+      ::close(input[0]);
+      ::close(input[1]);
+      throw std::system_error(error, std::generic_category(), "pipe");
+    }
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+    posix_spawn_file_actions_adddup2(&fileActions, input[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&fileActions, output[1], STDOUT_FILENO);
+    std::string shell = "sh";
+    std::string flag = "-c";
+    std::string script = command;
+    char *argv[] = {shell.data(), flag.data(), script.data(), nullptr};
+    const int spawned =
+        ::posix_spawn(&pid, "/bin/sh", &fileActions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&fileActions);
+    ::close(input[0]);
+    ::close(output[1]);
+    if (spawned != 0) {
+      ::close(input[1]);
+      ::close(output[0]);
+      throw std::system_error(spawned, std::generic_category(), "spawn");
+    }
+    toBot = input[1];
+    fromBot = output[0];
+    ::fcntl(toBot, F_SETFL, ::fcntl(toBot, F_GETFL) | O_NONBLOCK);
+    ::fcntl(fromBot, F_SETFL, ::fcntl(fromBot, F_GETFL) | O_NONBLOCK);
+  }
+
+  BotProcess(const BotProcess &) = delete;
+  BotProcess &operator=(const BotProcess &) = delete;
+
+  ~BotProcess() {
+    ::close(toBot);
+    const auto deadline = clock::now() + std::chrono::milliseconds(100);
+    int status = 0;
+    while (::waitpid(pid, &status, WNOHANG) == 0) {
+      if (clock::now() >= deadline) {
+        ::kill(pid, SIGKILL);
+        ::waitpid(pid, &status, 0);
+        break;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ::close(fromBot);
+  }
+
+  /* Writes all of bytes, false when the bot is broken or the deadline passed
+   * first.
+   */
+  bool send(std::string_view bytes, clock::time_point deadline) {
+    std::size_t sent = 0;
+    while (!broken and sent < bytes.size()) {
+      const ssize_t wrote =
+          ::write(toBot, bytes.data() + sent, bytes.size() - sent);
+      if (wrote > 0) {
+        sent += static_cast<std::size_t>(wrote);
+      } else if (errno == EAGAIN) {
+        if (!await(toBot, POLLOUT, deadline)) {
+          // Half a message would garble everything after it.
+          broken = sent > 0;
+          return false;
+        }
+      } else if (errno != EINTR) {
+        broken = true;
+      }
+    }
+    return !broken;
+  }
+
+  // The next line without its line end, false on the deadline.
+  bool receiveLine(std::string &line, clock::time_point deadline) {
+    return receive(line, deadline, &BotProcess::takeLine);
+  }
+
+  // The payload of the next frame, false on the deadline.
+  bool receiveFrame(std::string &payload, clock::time_point deadline) {
+    return receive(payload, deadline, &BotProcess::takeFrame);
+  }
+
+  /* The reply to the last message missed its deadline, it is dropped when
+   * it arrives.
+   */
+  void dropNextReply() { lateReplies++; }
+
+  bool isBroken() const { return broken; }
+  pid_t processId() const { return pid; }
+};
+
+export class ProcessSource final : public DecisionSource {
+private:
+  using clock = BotProcess::clock;
+
+  BotProcess process;
+  ProtocolMode mode;
+  std::chrono::microseconds timeout;
+  std::string message;
+  std::string reply;
+  std::uint64_t decisionCount = 0;
+  std::uint64_t faultCount = 0;
+  std::uint64_t timeoutCount = 0;
+  clock::duration waited{};
+
+  bool receive(clock::time_point deadline) {
+    return mode == ProtocolMode::line ? process.receiveLine(reply, deadline)
+                                      : process.receiveFrame(reply, deadline);
+  }
+
+public:
+  /* Starts command and waits up to startTimeout for its "ready". Throws
+   * std::runtime_error when it doesn't come.
+   */
+  ProcessSource(const std::string &command, ProtocolMode mode,
+                std::chrono::microseconds moveTimeout,
+                std::chrono::milliseconds startTimeout =
+                    std::chrono::milliseconds(2000))
+      : process(command), mode(mode), timeout(moveTimeout) {
+    const auto deadline = clock::now() + startTimeout;
+    const std::string_view hello =
+        mode == ProtocolMode::line ? "poker line\n" : "poker binary\n";
+    if (!process.send(hello, deadline) or
+        !process.receiveLine(reply, deadline) or reply != "ready") {
+      throw std::runtime_error("The bot \"" + command +
+                               "\" didn't answer the handshake.");
+    }
+  }
+
+  Action decide(const turnInfo &info) override {
+    decisionCount++;
+    const auto start = clock::now();
+    const auto deadline = start + timeout;
+    message.clear();
+    if (mode == ProtocolMode::line) {
+      message += formatTurn(info);
+      message += '\n';
+    } else {
+      appendTurnFrame(message, info);
+    }
+    const bool sent = process.send(message, deadline);
+    const bool answered = sent and receive(deadline);
+    waited += clock::now() - start;
+
+    if (answered) {
+      try {
+        return mode == ProtocolMode::line
+                   ? parseAction(reply, info.validMoves, info.currentRound)
+                   : readActionPayload(reply, info.validMoves,
+                                       info.currentRound);
+      } catch (const std::invalid_argument &) {
+        // Played like a missing answer.
+      }
+    } else if (sent and !process.isBroken()) {
+      timeoutCount++;
+      process.dropNextReply();
+    }
+    faultCount++;
+    return fallbackAction(info.validMoves, info.currentRound);
+  }
+
+  std::uint64_t decisions() const { return decisionCount; }
+  // Answers that were missing, late, unreadable or not legal.
+  std::uint64_t faults() const { return faultCount; }
+  // The faults that were late answers.
+  std::uint64_t timeouts() const { return timeoutCount; }
+  bool isBroken() const { return process.isBroken(); }
+
+  // From sending the turn until the answer was read, on average.
+  std::chrono::nanoseconds meanRoundTrip() const {
+    if (decisionCount == 0) {
+      return std::chrono::nanoseconds::zero();
+    }
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(waited) /
+           decisionCount;
+  }
+};
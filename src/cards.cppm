@@ -1,35 +1,62 @@
-/* This file implements the French-Suited Cards. It does so by providing 2
+/* This file implements the French-Suited Cards. It does so by providing 3
  * classes.
  * Card: Simulates a single card
  *    -getSuit returns the Suit of a card which is a enum class.
  *    -getRank returns the Rank of a card which is a enum class.
  *    -cardToString returns a string representation of the card.
- * Deck: Simulates a deck of cards
- *    -initializeDeck creates a deck of 52 cards.
- *    -shuffleDeck shuffles the deck of cards using a RNG.
- *    -dealCard removes the top card from the deck and returns it.
- *    -burnCard removes the top card from the deck and disposes this.
+ *    -toIndex/fromIndex convert between a card and its number 0..51, which
+ * is suit * 13 + rank - 2.
+ * CardSet: A set of cards stored as a 52-bit mask, one bit per card index.
+ *    -add, remove and contains work on a single card.
+ *    -size returns the amount of cards in the set.
+ *    -suitMask returns the 13-bit rank mask of one suit.
+ *    -|, & and - combine sets, e.g. removing dead cards from a deck.
+ *    -begin/end iterate over the cards from the lowest index up.
+ *    -toVector converts the set back to a vector of cards.
+ * Deck: Simulates a deck of cards. The 52 cards live in a fixed array, dealt
+ * cards are simply moved behind the remaining ones, so nothing is allocated.
+ *    -Made from a CardSet it only holds the cards of the set.
+ *    -shuffleDeck shuffles the deck of cards using a RNG, any generator from
+ * the prng module (or the standard library) can be passed in.
+ *    -dealCard removes the top card from the deck and returns it. Given a
+ * generator it removes a random card instead, which is a Fisher-Yates shuffle
+ * that stops after the cards that are actually dealt.
+ *    -burnCard removes the top card (or a random one) from the deck and
+ * disposes this.
  *    -peekCard returns the top card from the deck and doesn't affect the deck.
  *    -printDeck prints the deck of cards.
  *    -size returns the number of cards in the deck.
- *    -resetDeck resets the deck of cards unshuffled.
+ *    -resetDeck puts all dealt cards back in O(1), a deck made from a CardSet
+ * only gets the cards of the set back.
  *    -operator[] returns a reference to the card at the given index.
+ * HandIndexer: Numbers hole cards plus board densely per round, collapsing
+ * suit permutations, so AsKs and AhKh share an entry of any table.
  */
 
 module; // <--- tells the compiler: everything that follows is global
         // (pre-module) code
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <iostream>
 #include <random>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 export module cards;
+import prng;
 
-export enum class Suit { Clubs, Diamonds, Hearts, Spades };
+export constexpr int DECK_SIZE = 52;
 
-export enum class Rank : int {
+export enum class Suit : std::uint8_t { Clubs, Diamonds, Hearts, Spades };
+
+export enum class Rank : std::uint8_t {
   Two = 2,
   Three,
   Four,
@@ -51,6 +78,7 @@ private:
   Rank rank;
 
 public:
+  Card() : suit(Suit::Clubs), rank(Rank::Two) {}
   Card(Suit s, Rank r) : suit(s), rank(r) {}
   Suit getSuit() const { return suit; }
   Rank getRank() const { return rank; }
@@ -64,68 +92,512 @@ public:
     return ranks[static_cast<int>(rank) - 2] + " of " +
            suits[static_cast<int>(suit)];
   }
+
+  int toIndex() const {
+    return static_cast<int>(suit) * 13 + static_cast<int>(rank) -
+           static_cast<int>(Rank::Two);
+  }
+
+  static Card fromIndex(int index) {
+    return Card(static_cast<Suit>(index / 13),
+                static_cast<Rank>(index % 13 + static_cast<int>(Rank::Two)));
+  }
 };
 
-export class Deck {
+export class CardSet {
 private:
-  std::vector<Card> cards;
-
-  void initializeDeck() {
-    for (int s = static_cast<int>(Suit::Clubs);
-         s <= static_cast<int>(Suit::Spades); s++) {
-      for (int r = static_cast<int>(Rank::Two);
-           r <= static_cast<int>(Rank::Ace); r++) {
-        cards.emplace_back(static_cast<Suit>(s), static_cast<Rank>(r));
-      }
+  std::uint64_t mask;
+
+  static constexpr std::uint64_t FULL_DECK = (std::uint64_t{1} << 52) - 1;
+
+public:
+  class iterator {
+  private:
+    std::uint64_t rest;
+
+  public:
+    explicit iterator(std::uint64_t bits) : rest(bits) {}
+    Card operator*() const { return Card::fromIndex(std::countr_zero(rest)); }
+    iterator &operator++() {
+      rest &= rest - 1;
+      return *this;
+    }
+    bool operator==(const iterator &other) const = default;
+  };
+
+  constexpr CardSet() : mask(0) {}
+  explicit constexpr CardSet(std::uint64_t bits) : mask(bits & FULL_DECK) {}
+  CardSet(std::initializer_list<Card> cards) : mask(0) {
+    for (const Card &card : cards) {
+      add(card);
+    }
+  }
+  explicit CardSet(std::span<const Card> cards) : mask(0) {
+    for (const Card &card : cards) {
+      add(card);
     }
   }
 
+  static constexpr CardSet fullDeck() { return CardSet(FULL_DECK); }
+
+  std::uint64_t bits() const { return mask; }
+  int size() const { return std::popcount(mask); }
+  bool empty() const { return mask == 0; }
+
+  void add(const Card &card) { mask |= std::uint64_t{1} << card.toIndex(); }
+  void remove(const Card &card) {
+    mask &= ~(std::uint64_t{1} << card.toIndex());
+  }
+  bool contains(const Card &card) const {
+    return (mask >> card.toIndex()) & 1;
+  }
+
+  // Returns the ranks held in one suit, bit 0 being a Two.
+  std::uint16_t suitMask(Suit suit) const {
+    return static_cast<std::uint16_t>((mask >> (static_cast<int>(suit) * 13)) &
+                                      0x1FFF);
+  }
+
+  iterator begin() const { return iterator(mask); }
+  iterator end() const { return iterator(0); }
+
+  std::vector<Card> toVector() const {
+    std::vector<Card> cards;
+    cards.reserve(size());
+    for (Card card : *this) {
+      cards.push_back(card);
+    }
+    return cards;
+  }
+
+  CardSet operator|(CardSet other) const { return CardSet(mask | other.mask); }
+  CardSet operator&(CardSet other) const { return CardSet(mask & other.mask); }
+  CardSet operator-(CardSet other) const { return CardSet(mask & ~other.mask); }
+  CardSet operator~() const { return CardSet(~mask); }
+  CardSet &operator|=(CardSet other) {
+    mask |= other.mask;
+    return *this;
+  }
+  CardSet &operator&=(CardSet other) {
+    mask &= other.mask;
+    return *this;
+  }
+  CardSet &operator-=(CardSet other) {
+    mask &= ~other.mask;
+    return *this;
+  }
+  bool operator==(const CardSet &other) const = default;
+};
+
+export class Deck {
+private:
+  std::array<Card, DECK_SIZE> cards;
+  size_t remaining;
+  size_t full; // The cards the deck was made with, what resetDeck restores.
+
 public:
-  Deck() { initializeDeck(); }
+  Deck() : remaining(DECK_SIZE), full(DECK_SIZE) {
+    for (int i = 0; i < DECK_SIZE; i++) {
+      cards[i] = Card::fromIndex(i);
+    }
+  }
+
+  // A deck of exactly the cards of left, e.g. the ones nobody has seen.
+  explicit Deck(CardSet left) : remaining(0) {
+    for (Card card : left) {
+      cards[remaining++] = card;
+    }
+    full = remaining;
+  }
 
   void shuffleDeck() {
     std::random_device rd;
-    std::mt19937 g(rd());
-    std::shuffle(cards.begin(), cards.end(), g);
+    Xoshiro256 g((static_cast<std::uint64_t>(rd()) << 32) | rd());
+    shuffleDeck(g);
+  }
+
+  // Shuffles the remaining cards with the caller's generator, so a seeded
+  // generator gives a reproducible order.
+  template <typename Generator> void shuffleDeck(Generator &g) {
+    for (size_t i = remaining; i > 1; i--) {
+      std::swap(cards[i - 1],
+                cards[uniformBelow(g, static_cast<std::uint32_t>(i))]);
+    }
   }
 
   Card dealCard() {
-    if (cards.empty()) {
+    if (remaining == 0) {
+      throw std::out_of_range("No cards left in the deck");
+    }
+    return cards[--remaining];
+  }
+
+  // Deals a random card of the remaining ones: one step of a Fisher-Yates
+  // shuffle, so only the cards that get dealt are ever shuffled.
+  template <typename Generator> Card dealCard(Generator &g) {
+    if (remaining == 0) {
       throw std::out_of_range("No cards left in the deck");
     }
-    Card c = cards.back();
-    cards.pop_back();
-    return c;
+    size_t pick = uniformBelow(g, static_cast<std::uint32_t>(remaining));
+    remaining--;
+    std::swap(cards[pick], cards[remaining]);
+    return cards[remaining];
   }
 
   void burnCard() {
-    if (cards.empty()) {
+    if (remaining == 0) {
       throw std::out_of_range("No cards left to burn");
     }
-    cards.pop_back();
+    remaining--;
   }
 
+  template <typename Generator> void burnCard(Generator &g) { dealCard(g); }
+
   Card peekCard() {
-    if (cards.empty()) {
+    if (remaining == 0) {
       throw std::out_of_range("No cards to peek at");
     }
-    return cards.back();
+    return cards[remaining - 1];
   }
 
   void printDeck() const {
-    for (auto const &card : cards) {
-      std::cout << card.cardToString() << std::endl;
+    for (size_t i = 0; i < remaining; i++) {
+      std::cout << cards[i].cardToString() << std::endl;
+    }
+  }
+
+  size_t size() const { return remaining; }
+
+  // Puts every dealt card back, only the cards the deck was made with. The
+  // order of the deck is whatever the last deals left behind, so deal
+  // randomly or shuffle before dealing again.
+  void resetDeck() { remaining = full; }
+
+  Card &operator[](size_t index) {
+    if (index >= remaining) {
+      throw std::out_of_range("Deck index out of range");
+    }
+    return cards[index];
+  }
+
+  const Card &operator[](size_t index) const {
+    if (index >= remaining) {
+      throw std::out_of_range("Deck index out of range");
+    }
+    return cards[index];
+  }
+};
+
+export constexpr int HAND_ROUNDS = 4; // Preflop, flop, turn and river.
+export constexpr std::array<int, HAND_ROUNDS> BOARD_CARDS = {0, 3, 4, 5};
+
+constexpr std::uint64_t binomial(std::uint64_t n, std::uint64_t k) {
+  if (k > n) {
+    return 0;
+  }
+  std::uint64_t result = 1;
+  for (std::uint64_t i = 0; i < k; i++) {
+    result = result * (n - i) / (i + 1);
+  }
+  return result;
+}
+
+// Pascal's triangle for the rank combinations, the hot part of HandIndexer.
+constexpr auto SMALL_BINOMIALS = [] {
+  std::array<std::array<std::uint32_t, 14>, 14> table{};
+  for (std::uint64_t n = 0; n < table.size(); n++) {
+    for (std::uint64_t k = 0; k < table.size(); k++) {
+      table[n][k] = static_cast<std::uint32_t>(binomial(n, k));
+    }
+  }
+  return table;
+}();
+
+/* Maps hole cards plus board onto a dense index per round, hands that only
+ * differ by a permutation of the suits or by the order of the board share an
+ * index. Round 0 is preflop, round 1 the flop, 2 the turn and 3 the river.
+ *    -Per suit, the ranks of the hole cards and the ranks of the board form
+ * its configuration. It is numbered by the combination of the hole ranks and
+ * the combination of the board ranks among the 13 - hole ranks left. The
+ * shape of a configuration is its amount of hole and board cards.
+ *    -A hand is the multiset of its 4 configurations. The sorted shapes of
+ * the 4 suits select a block of indices, suits with the same shape are a
+ * multiset of configurations within it.
+ *    -size(round) is the amount of indices: 169, 1286792, 13960050 and
+ * 123156254. unindex returns the canonical hand of an index, where the suits
+ * are used in the order Clubs, Diamonds, Hearts, Spades from the largest
+ * configuration down.
+ *    -index does no allocation, a few dozen table lookups and a binary search
+ * over the (at most 30) blocks of the round.
+ */
+export class HandIndexer {
+private:
+  static constexpr int SUITS = 4;
+  static constexpr int RANKS = 13;
+  static constexpr int HOLE_CARDS = 2;
+  static constexpr int SHAPE_CODES = 3 * 6; // 0..2 hole, 0..5 board cards.
+
+  struct Block {
+    std::uint32_t key;    // The 4 shape codes, largest first, 5 bits each.
+    std::uint64_t offset; // First index of the block.
+    std::uint64_t size;
+  };
+
+  std::array<std::vector<Block>, HAND_ROUNDS> blocks;
+  std::array<std::uint64_t, HAND_ROUNDS> sizes{};
+  std::array<std::uint64_t, SHAPE_CODES> configs{}; // Per shape.
+
+  static constexpr std::uint64_t choose(std::uint64_t n, std::uint64_t k) {
+    if (n < SMALL_BINOMIALS.size() and k < SMALL_BINOMIALS.size()) {
+      return SMALL_BINOMIALS[n][k];
     }
+    return binomial(n, k);
   }
 
-  size_t size() const { return cards.size(); }
+  static constexpr int holeOf(int code) { return code % 3; }
+  static constexpr int boardOf(int code) { return code / 3; }
 
-  void resetDeck() {
-    cards.clear();
-    initializeDeck();
+  // Number of set among the ranks not in used, in colex order.
+  static std::uint64_t colexIndex(std::uint16_t set, std::uint16_t used) {
+    std::uint64_t index = 0;
+    for (int t = 1; set != 0; set &= set - 1, t++) {
+      const int rank = std::countr_zero(set);
+      const int position =
+          rank - std::popcount(static_cast<unsigned>(used & ((1u << rank) - 1)));
+      index += choose(position, t);
+    }
+    return index;
   }
 
-  Card &operator[](size_t index) { return cards.at(index); }
+  /* The t ranks numbered index among the ranks not in used, the inverse of
+   * colexIndex.
+   */
+  static std::uint16_t colexSet(std::uint64_t index, int t,
+                                std::uint16_t used) {
+    std::uint32_t compressed = 0;
+    int n = RANKS - std::popcount(static_cast<unsigned>(used));
+    for (; t > 0; t--) {
+      int position = t - 1;
+      while (position + 1 < n and choose(position + 1, t) <= index) {
+        position++;
+      }
+      index -= choose(position, t);
+      compressed |= 1u << position;
+      n = position;
+    }
+    std::uint16_t set = 0;
+    for (int rank = 0, position = 0; rank < RANKS; rank++) {
+      if (!(used & (1u << rank))) {
+        if (compressed & (1u << position)) {
+          set |= static_cast<std::uint16_t>(1u << rank);
+        }
+        position++;
+      }
+    }
+    return set;
+  }
 
-  const Card &operator[](size_t index) const { return cards.at(index); }
+  void addBlocks(int round, std::array<int, SUITS> &codes, int suit,
+                 int hole, int board) {
+    if (suit == SUITS) {
+      if (hole != 0 or board != 0) {
+        return;
+      }
+      std::uint32_t key = 0;
+      std::uint64_t size = 1;
+      for (int s = 0; s < SUITS;) {
+        int same = 1;
+        while (s + same < SUITS and codes[s + same] == codes[s]) {
+          same++;
+        }
+        size *= choose(configs[codes[s]] + same - 1, same);
+        s += same;
+      }
+      for (int s = 0; s < SUITS; s++) {
+        key = (key << 5) | static_cast<std::uint32_t>(codes[s]);
+      }
+      blocks[round].push_back({key, 0, size});
+      return;
+    }
+    const int limit = suit == 0 ? SHAPE_CODES - 1 : codes[suit - 1];
+    for (int code = limit; code >= 0; code--) {
+      if (holeOf(code) <= hole and boardOf(code) <= board) {
+        codes[suit] = code;
+        addBlocks(round, codes, suit + 1, hole - holeOf(code),
+                  board - boardOf(code));
+      }
+    }
+  }
+
+public:
+  HandIndexer() {
+    for (int code = 0; code < SHAPE_CODES; code++) {
+      configs[code] = choose(RANKS, holeOf(code)) *
+                      choose(RANKS - holeOf(code), boardOf(code));
+    }
+    for (int round = 0; round < HAND_ROUNDS; round++) {
+      std::array<int, SUITS> codes{};
+      addBlocks(round, codes, 0, HOLE_CARDS, BOARD_CARDS[round]);
+      std::sort(blocks[round].begin(), blocks[round].end(),
+                [](const Block &a, const Block &b) { return a.key < b.key; });
+      for (Block &block : blocks[round]) {
+        block.offset = sizes[round];
+        sizes[round] += block.size;
+      }
+    }
+  }
+
+  // Amount of hole cards plus board cards of round.
+  static constexpr int cardsIn(int round) {
+    return HOLE_CARDS + BOARD_CARDS[round];
+  }
+
+  std::uint64_t size(int round) const { return sizes[round]; }
+
+  /* The index of cardsIn(round) cards, the 2 hole cards first. Throws when a
+   * card is given twice.
+   */
+  std::uint64_t index(const Card *cards, int round) const {
+    std::array<std::uint16_t, SUITS> hole{};
+    std::array<std::uint16_t, SUITS> board{};
+    std::uint64_t seen = 0;
+    const int count = cardsIn(round);
+    for (int i = 0; i < count; i++) {
+      const Card card = cards[i];
+      seen |= std::uint64_t{1} << card.toIndex();
+      const auto rank = static_cast<std::uint16_t>(
+          1u << (static_cast<int>(card.getRank()) -
+                 static_cast<int>(Rank::Two)));
+      (i < HOLE_CARDS ? hole : board)[static_cast<int>(card.getSuit())] |=
+          rank;
+    }
+    if (std::popcount(seen) != count) {
+      throw std::invalid_argument("A card can only be dealt once.");
+    }
+
+    std::array<int, SUITS> codes;
+    std::array<std::uint64_t, SUITS> configIndex;
+    for (int s = 0; s < SUITS; s++) {
+      const int holeCount = std::popcount(static_cast<unsigned>(hole[s]));
+      codes[s] = holeCount + 3 * std::popcount(static_cast<unsigned>(board[s]));
+      configIndex[s] = colexIndex(hole[s], 0) +
+                       choose(RANKS, holeCount) * colexIndex(board[s], hole[s]);
+    }
+
+    // Largest shape first, equal shapes by largest configuration.
+    std::array<int, SUITS> order = {0, 1, 2, 3};
+    for (int i = 1; i < SUITS; i++) {
+      for (int j = i; j > 0; j--) {
+        const int a = order[j - 1];
+        const int b = order[j];
+        if (codes[a] > codes[b] or
+            (codes[a] == codes[b] and configIndex[a] >= configIndex[b])) {
+          break;
+        }
+        std::swap(order[j - 1], order[j]);
+      }
+    }
+
+    std::uint32_t key = 0;
+    for (int s : order) {
+      key = (key << 5) | static_cast<std::uint32_t>(codes[s]);
+    }
+    const std::vector<Block> &roundBlocks = blocks[round];
+    const auto block = std::lower_bound(
+        roundBlocks.begin(), roundBlocks.end(), key,
+        [](const Block &b, std::uint32_t k) { return b.key < k; });
+
+    std::uint64_t value = 0;
+    for (int i = 0; i < SUITS;) {
+      const int code = codes[order[i]];
+      int same = 1;
+      while (i + same < SUITS and codes[order[i + same]] == code) {
+        same++;
+      }
+      // The configurations of a group, largest first, made strictly
+      // decreasing and numbered in colex order.
+      std::uint64_t multiset = 0;
+      for (int k = 0; k < same; k++) {
+        multiset += choose(configIndex[order[i + k]] + same - 1 - k, same - k);
+      }
+      value = value * choose(configs[code] + same - 1, same) + multiset;
+      i += same;
+    }
+    return block->offset + value;
+  }
+
+  std::uint64_t index(const std::vector<Card> &holeCards,
+                      const std::vector<Card> &board) const {
+    if (holeCards.size() != HOLE_CARDS or
+        (board.size() != 0 and (board.size() < 3 or board.size() > 5))) {
+      throw std::invalid_argument("A hand is 2 hole cards and 0, 3, 4 or 5 "
+                                  "board cards.");
+    }
+    std::array<Card, 7> cards;
+    std::copy(holeCards.begin(), holeCards.end(), cards.begin());
+    std::copy(board.begin(), board.end(), cards.begin() + HOLE_CARDS);
+    const int round = board.empty() ? 0 : static_cast<int>(board.size()) - 2;
+    return index(cards.data(), round);
+  }
+
+  /* Writes the canonical hand of index in round into cards, which needs room
+   * for cardsIn(round) cards.
+   */
+  void unindex(int round, std::uint64_t index, Card *cards) const {
+    if (index >= sizes[round]) {
+      throw std::out_of_range("Hand index out of range.");
+    }
+    const std::vector<Block> &roundBlocks = blocks[round];
+    const auto block =
+        std::upper_bound(
+            roundBlocks.begin(), roundBlocks.end(), index,
+            [](std::uint64_t i, const Block &b) { return i < b.offset; }) -
+        1;
+    std::uint64_t value = index - block->offset;
+
+    std::array<int, SUITS> codes;
+    for (int s = 0; s < SUITS; s++) {
+      codes[s] = static_cast<int>((block->key >> (5 * (SUITS - 1 - s))) & 31);
+    }
+    // The groups were combined first to last, so they come out last first.
+    std::array<std::uint64_t, SUITS> configIndex{};
+    for (int end = SUITS; end > 0;) {
+      int same = 1;
+      while (end - same > 0 and codes[end - same - 1] == codes[end - 1]) {
+        same++;
+      }
+      const std::uint64_t groupSize =
+          choose(configs[codes[end - 1]] + same - 1, same);
+      std::uint64_t multiset = value % groupSize;
+      value /= groupSize;
+      for (int k = 0; k < same; k++) {
+        const int t = same - k;
+        std::uint64_t y = t == 1 ? multiset : static_cast<std::uint64_t>(t - 1);
+        while (choose(y + 1, t) <= multiset) {
+          y++;
+        }
+        multiset -= choose(y, t);
+        configIndex[end - same + k] = y - (t - 1);
+      }
+      end -= same;
+    }
+
+    int holeAt = 0;
+    int boardAt = HOLE_CARDS;
+    for (int s = 0; s < SUITS; s++) {
+      const std::uint64_t holeSets = choose(RANKS, holeOf(codes[s]));
+      const std::uint16_t hole =
+          colexSet(configIndex[s] % holeSets, holeOf(codes[s]), 0);
+      const std::uint16_t board =
+          colexSet(configIndex[s] / holeSets, boardOf(codes[s]), hole);
+      for (auto [set, at] : {std::pair{hole, &holeAt},
+                             std::pair{board, &boardAt}}) {
+        for (; set != 0; set &= set - 1) {
+          cards[(*at)++] = Card(static_cast<Suit>(s),
+                                static_cast<Rank>(std::countr_zero(set) +
+                                                  static_cast<int>(Rank::Two)));
+        }
+      }
+    }
+  }
 };
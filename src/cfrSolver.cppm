@@ -0,0 +1,644 @@
+/* This file implements a heads-up CFR+ solver for the betting rules of Game.
+ * HandBuckets: The card abstraction. Every player is dealt one of n buckets
+ * with the given weights, at the showdown bucket i wins equity(i, j) of the
+ * pot against bucket j. The buckets stay the same over all streets, so the
+ * streets only add betting rounds. ranked(n) is the simplest such game, the
+ * higher bucket always wins.
+ * CfrSolver: Builds the public betting tree once and runs CFR+ on it.
+ *    -Player 0 is the small blind and the button, player 1 the big blind.
+ * Blinds are minBet / 2 and minBet, both start with startingChips.
+ *    -The actions of a node follow allValidAction: fold and all-in are always
+ * possible, check and bet minBet when nothing is bet this street, call and
+ * raise by minBet when something is. An all-in counts as a bet. Actions that
+ * are the same move as another one (an all-in for exactly the call, a raise
+ * against an all-in player) are left out.
+ *    -The tree is a flat array, the children of a node are stored next to
+ * each other and always after their parent. Regrets and strategy sums are
+ * flat arrays of [decision][bucket][4 actions], reach and values of
+ * [node][bucket], all 64 byte aligned.
+ *    -An iteration computes the reach of both players front to back through
+ * the array and the values of one player back to front, once per player
+ * (alternating updates). Regrets are floored at 0 and the average strategy
+ * is weighted linearly with the iteration.
+ *    -Every bucket only reads its own regrets and reach, so the buckets are
+ * split over the ThreadPool in blocks of 16 (one cache line of floats). The
+ * tree is split as well: addNode builds it depth first, so the descendants
+ * of a decision are one range of the array. The largest ranges are split
+ * until there are at least SUBTREES of them, the few nodes above them run
+ * before (reach) or after (values) the ranges. A task is one range and one
+ * block of buckets, so even 16 buckets keep every thread busy. The results
+ * don't depend on the amount of threads.
+ *    -exploitability is what two best responses against the average strategy
+ * win on average, in chips per hand. It is 0 at an equilibrium.
+ */
+module;
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+export module cfrSolver;
+import game;
+import threadPool;
+
+export constexpr std::size_t MAX_CFR_ACTIONS = 4;
+export constexpr std::size_t MAX_CFR_NODES = std::size_t{1} << 24;
+
+export struct HandBuckets {
+  std::vector<float> weight; // How likely every bucket is dealt.
+  std::vector<float> equity; // equity[i * size() + j]: share of i against j.
+
+  std::size_t size() const { return weight.size(); }
+
+  /* n equally likely buckets, the higher one wins, equal ones split. */
+  static HandBuckets ranked(std::size_t buckets) {
+    HandBuckets ranked;
+    ranked.weight.assign(buckets, 1.0f);
+    ranked.equity.resize(buckets * buckets);
+    for (std::size_t i = 0; i < buckets; i++) {
+      for (std::size_t j = 0; j < buckets; j++) {
+        ranked.equity[i * buckets + j] = i > j ? 1.0f : (i == j ? 0.5f : 0.0f);
+      }
+    }
+    return ranked;
+  }
+};
+
+export enum class CfrNodeKind : std::uint8_t { player0, player1, fold, showdown };
+
+/* A node of the betting tree. action and bet are the move that led to it,
+ * with the amounts an Action of Game would carry.
+ */
+export struct CfrNode {
+  std::uint32_t firstChild = 0;
+  std::uint32_t decision = 0; // Row in the regret arrays, decisions only.
+  std::array<money, 2> committed{};
+  CfrNodeKind kind = CfrNodeKind::showdown;
+  std::uint8_t childCount = 0;
+  std::uint8_t street = 0;
+  std::uint8_t folder = 0; // Who folded, fold nodes only.
+  actions action = actions::check;
+  money bet = 0;
+};
+
+export struct SolveReport {
+  std::size_t iterations = 0;
+  double seconds = 0;
+  double iterationsPerSecond = 0;
+  double exploitability = 0; // Chips per hand.
+};
+
+namespace {
+
+constexpr std::size_t CACHE_LINE = 64;
+constexpr std::size_t BLOCK = CACHE_LINE / sizeof(float);
+constexpr std::size_t SUBTREES = 64;
+
+/* A zeroed float array on its own cache lines. */
+class AlignedFloats {
+private:
+  struct Free {
+    void operator()(float *data) const {
+      ::operator delete[](data, std::align_val_t{CACHE_LINE});
+    }
+  };
+  std::unique_ptr<float[], Free> data;
+
+public:
+  explicit AlignedFloats(std::size_t size = 0)
+      : data(static_cast<float *>(::operator new[](
+            std::max<std::size_t>(size, 1) * sizeof(float),
+            std::align_val_t{CACHE_LINE}))) {
+    std::fill_n(data.get(), size, 0.0f);
+  }
+
+  float *get() { return data.get(); }
+  const float *get() const { return data.get(); }
+};
+
+/* The betting state while the tree is built. */
+struct BettingState {
+  std::uint8_t street = 0;
+  std::array<money, 2> bets{};
+  std::array<money, 2> committed{};
+  std::array<bool, 2> acted{};
+  int toAct = 0;
+  bool betPlaced = true;
+};
+
+} // namespace
+
+export class CfrSolver {
+private:
+  gameSettings settings;
+  HandBuckets buckets;
+  std::size_t bucketCount;
+  std::size_t stride; // bucketCount rounded up to a whole cache line.
+  std::vector<CfrNode> tree;
+  std::size_t decisions = 0;
+
+  AlignedFloats regrets;
+  AlignedFloats strategySums;
+  std::array<AlignedFloats, 2> reach;
+  AlignedFloats values;
+  // payoff[j * stride + i] = 2 * equity(i, j) - 1, what bucket i wins per
+  // chip at a showdown against j. Columns are contiguous so the showdown
+  // loop runs over i.
+  AlignedFloats payoff;
+  std::size_t iterationCount = 0;
+
+  // The nodes [begin, end) of the array below the decision parent.
+  struct Subtree {
+    std::uint32_t parent;
+    std::uint32_t begin;
+    std::uint32_t end;
+  };
+  std::vector<std::uint32_t> top; // The nodes above the subtrees, in order.
+  std::vector<Subtree> subtrees;
+
+  void addNode(std::uint32_t index, const BettingState &state) {
+    const int player = state.toAct;
+    const int other = 1 - player;
+    const money chips = settings.startingChips - state.committed[player];
+    const money highestBet = std::max(state.bets[0], state.bets[1]);
+    const money toCall = highestBet - state.bets[player];
+    const bool otherAllIn = state.committed[other] == settings.startingChips;
+
+    struct Move {
+      actions action;
+      money pay;
+      money bet;
+    };
+    std::array<Move, MAX_CFR_ACTIONS> moves;
+    int count = 0;
+    moves[count++] = {actions::fold, 0, 0};
+    if (!state.betPlaced) {
+      moves[count++] = {actions::check, 0, 0};
+    }
+    if (state.betPlaced and chips >= toCall) {
+      moves[count++] = {actions::call, toCall, highestBet};
+    }
+    if (state.betPlaced and !otherAllIn and
+        chips >= toCall + settings.minBet) {
+      moves[count++] = {actions::raise, toCall + settings.minBet,
+                        highestBet + settings.minBet};
+    }
+    if (!state.betPlaced and chips >= settings.minBet) {
+      moves[count++] = {actions::bet, settings.minBet, settings.minBet};
+    }
+    bool duplicate = false;
+    for (int m = 1; m < count; m++) {
+      duplicate |= moves[m].pay == chips;
+    }
+    if (!duplicate and !(otherAllIn and chips > toCall)) {
+      moves[count++] = {actions::allIn, chips, chips};
+    }
+
+    const std::uint32_t first = static_cast<std::uint32_t>(tree.size());
+    if (tree.size() + count > MAX_CFR_NODES) {
+      throw std::length_error("Betting tree too large, use fewer chips per "
+                              "minBet.");
+    }
+    tree.resize(tree.size() + count);
+    CfrNode &node = tree[index];
+    node.kind = player == 0 ? CfrNodeKind::player0 : CfrNodeKind::player1;
+    node.street = state.street;
+    node.committed = state.committed;
+    node.firstChild = first;
+    node.childCount = static_cast<std::uint8_t>(count);
+    node.decision = static_cast<std::uint32_t>(decisions++);
+
+    for (int m = 0; m < count; m++) {
+      const std::uint32_t childIndex = first + m;
+      BettingState next = state;
+      next.bets[player] += moves[m].pay;
+      next.committed[player] += moves[m].pay;
+      next.acted[player] = true;
+      next.betPlaced |= moves[m].pay > 0;
+
+      CfrNode &child = tree[childIndex];
+      child.action = moves[m].action;
+      child.bet = moves[m].bet;
+      child.street = state.street;
+      child.committed = next.committed;
+      if (moves[m].action == actions::fold) {
+        child.kind = CfrNodeKind::fold;
+        child.folder = static_cast<std::uint8_t>(player);
+        continue;
+      }
+
+      const bool playerAllIn =
+          next.committed[player] == settings.startingChips;
+      const bool closed =
+          (next.acted[other] and next.bets[player] == next.bets[other]) or
+          (playerAllIn and next.bets[player] <= next.bets[other]) or
+          (otherAllIn and next.bets[player] >= next.bets[other]);
+      if (!closed) {
+        next.toAct = other;
+        addNode(childIndex, next);
+      } else if (playerAllIn or otherAllIn or state.street == 3) {
+        child.kind = CfrNodeKind::showdown;
+      } else {
+        BettingState street;
+        street.street = static_cast<std::uint8_t>(state.street + 1);
+        street.committed = next.committed;
+        street.toAct = 1;
+        street.betPlaced = false;
+        addNode(childIndex, street);
+      }
+    }
+  }
+
+  /* Splits the tree into top and subtrees. Starting with everything below
+   * the root, the largest subtree moves the children of its parent to top and
+   * is replaced by the subtrees of the children.
+   */
+  void splitTree() {
+    std::vector<std::uint32_t> end(tree.size());
+    for (std::size_t n = tree.size(); n-- > 0;) {
+      end[n] = static_cast<std::uint32_t>(n + 1);
+      if (isDecision(tree[n])) {
+        end[n] = tree[n].firstChild + tree[n].childCount;
+        for (int a = 0; a < tree[n].childCount; a++) {
+          end[n] = std::max(end[n], end[tree[n].firstChild + a]);
+        }
+      }
+    }
+    top = {0};
+    subtrees = {{0, tree[0].firstChild, end[0]}};
+    while (subtrees.size() < SUBTREES) {
+      const auto largest = std::max_element(
+          subtrees.begin(), subtrees.end(), [](Subtree a, Subtree b) {
+            return a.end - a.begin < b.end - b.begin;
+          });
+      const CfrNode &parent = tree[largest->parent];
+      if (largest->end - largest->begin <= parent.childCount) {
+        break; // Nothing left below the children.
+      }
+      subtrees.erase(largest);
+      for (int a = 0; a < parent.childCount; a++) {
+        const std::uint32_t child = parent.firstChild + a;
+        top.push_back(child);
+        if (isDecision(tree[child])) {
+          subtrees.push_back({child, tree[child].firstChild, end[child]});
+        }
+      }
+    }
+    std::sort(top.begin(), top.end());
+    std::sort(subtrees.begin(), subtrees.end(),
+              [](Subtree a, Subtree b) { return a.begin < b.begin; });
+  }
+
+  static int owner(const CfrNode &node) {
+    return node.kind == CfrNodeKind::player0 ? 0 : 1;
+  }
+  static bool isDecision(const CfrNode &node) {
+    return node.kind == CfrNodeKind::player0 or
+           node.kind == CfrNodeKind::player1;
+  }
+
+  // Regret matching on the floored regrets of bucket at decision.
+  void currentStrategy(const CfrNode &node, std::size_t bucket,
+                       float *strategy) const {
+    const float *regret =
+        regrets.get() + (node.decision * stride + bucket) * MAX_CFR_ACTIONS;
+    float total = 0;
+    for (int a = 0; a < node.childCount; a++) {
+      total += regret[a];
+    }
+    if (total <= 0) {
+      std::fill_n(strategy, node.childCount, 1.0f / node.childCount);
+      return;
+    }
+    const float scale = 1 / total;
+    for (int a = 0; a < node.childCount; a++) {
+      strategy[a] = regret[a] * scale;
+    }
+  }
+
+  void averageStrategy(const CfrNode &node, std::size_t bucket,
+                       float *strategy) const {
+    const float *sum = strategySums.get() +
+                       (node.decision * stride + bucket) * MAX_CFR_ACTIONS;
+    float total = 0;
+    for (int a = 0; a < node.childCount; a++) {
+      total += sum[a];
+    }
+    if (total <= 0) {
+      std::fill_n(strategy, node.childCount, 1.0f / node.childCount);
+      return;
+    }
+    const float scale = 1 / total;
+    for (int a = 0; a < node.childCount; a++) {
+      strategy[a] = sum[a] * scale;
+    }
+  }
+
+  /* The reach of both players at the children of node n for the buckets
+   * [begin, end), with the current or the average strategy.
+   */
+  void reachBelow(std::size_t n, std::size_t begin, std::size_t end,
+                  bool average) {
+    const CfrNode &node = tree[n];
+    if (!isDecision(node)) {
+      return;
+    }
+    const int acting = owner(node);
+    float *waiting = reach[1 - acting].get();
+    for (int a = 0; a < node.childCount; a++) {
+      std::copy(waiting + n * stride + begin, waiting + n * stride + end,
+                waiting + (node.firstChild + a) * stride + begin);
+    }
+    const float *parent = reach[acting].get() + n * stride;
+    float *children = reach[acting].get() + node.firstChild * stride;
+    for (std::size_t i = begin; i < end; i++) {
+      float strategy[MAX_CFR_ACTIONS];
+      if (average) {
+        averageStrategy(node, i, strategy);
+      } else {
+        currentStrategy(node, i, strategy);
+      }
+      for (int a = 0; a < node.childCount; a++) {
+        children[a * stride + i] = parent[i] * strategy[a];
+      }
+    }
+  }
+
+  // The value of a terminal node for the buckets [begin, end) of player.
+  void terminalValues(const CfrNode &node, std::size_t n, int player,
+                      std::size_t begin, std::size_t end) {
+    const float *opponent = reach[1 - player].get() + n * stride;
+    float *value = values.get() + n * stride;
+    if (node.kind == CfrNodeKind::fold) {
+      float opponentReach = 0;
+      for (std::size_t j = 0; j < bucketCount; j++) {
+        opponentReach += opponent[j];
+      }
+      const float won = node.folder == player
+                            ? -static_cast<float>(node.committed[player])
+                            : static_cast<float>(node.committed[1 - player]);
+      std::fill(value + begin, value + end, won * opponentReach);
+      return;
+    }
+    const float stake = static_cast<float>(
+        std::min(node.committed[0], node.committed[1]));
+    float sums[BLOCK] = {};
+    for (std::size_t j = 0; j < bucketCount; j++) {
+      if (opponent[j] == 0) {
+        continue;
+      }
+      const float chance = stake * opponent[j];
+      const float *column = payoff.get() + j * stride + begin;
+      for (std::size_t k = 0; k < end - begin; k++) {
+        sums[k] += column[k] * chance;
+      }
+    }
+    std::copy(sums, sums + (end - begin), value + begin);
+  }
+
+  /* The counterfactual value of player at node n for the buckets
+   * [begin, end), the children have theirs already. Updates regrets and
+   * strategy sums of player, or plays a best response when bestResponse is
+   * set.
+   */
+  void valueAt(std::size_t n, int player, std::size_t begin, std::size_t end,
+               bool bestResponse) {
+    const CfrNode &node = tree[n];
+    float *value = values.get() + n * stride;
+    if (!isDecision(node)) {
+      terminalValues(node, n, player, begin, end);
+      return;
+    }
+    const float *children = values.get() + node.firstChild * stride;
+    if (owner(node) != player) {
+      for (std::size_t i = begin; i < end; i++) {
+        float sum = 0;
+        for (int a = 0; a < node.childCount; a++) {
+          sum += children[a * stride + i];
+        }
+        value[i] = sum;
+      }
+      return;
+    }
+    if (bestResponse) {
+      for (std::size_t i = begin; i < end; i++) {
+        float best = children[i];
+        for (int a = 1; a < node.childCount; a++) {
+          best = std::max(best, children[a * stride + i]);
+        }
+        value[i] = best;
+      }
+      return;
+    }
+
+    const float weight = static_cast<float>(iterationCount + 1);
+    const float *ownReach = reach[player].get() + n * stride;
+    for (std::size_t i = begin; i < end; i++) {
+      float strategy[MAX_CFR_ACTIONS];
+      currentStrategy(node, i, strategy);
+      float expected = 0;
+      for (int a = 0; a < node.childCount; a++) {
+        expected += strategy[a] * children[a * stride + i];
+      }
+      value[i] = expected;
+
+      const std::size_t row = (node.decision * stride + i) * MAX_CFR_ACTIONS;
+      float *regret = regrets.get() + row;
+      float *sum = strategySums.get() + row;
+      for (int a = 0; a < node.childCount; a++) {
+        regret[a] =
+            std::max(regret[a] + children[a * stride + i] - expected, 0.0f);
+        sum[a] += weight * ownReach[i] * strategy[a];
+      }
+    }
+  }
+
+  // Runs pass(begin, end) for every block of buckets on the pool.
+  template <typename Pass> void forEachBlock(ThreadPool &pool, Pass pass) {
+    const std::size_t blocks = stride / BLOCK;
+    pool.parallelFor(blocks, [&](std::size_t block) {
+      const std::size_t begin = block * BLOCK;
+      const std::size_t end = std::min(begin + BLOCK, bucketCount);
+      if (begin < end) {
+        pass(begin, end);
+      }
+    });
+  }
+
+  // Runs pass(subtree, begin, end) for every subtree and block of buckets.
+  template <typename Pass> void forEachSubtree(ThreadPool &pool, Pass pass) {
+    const std::size_t blocks = stride / BLOCK;
+    pool.parallelFor(subtrees.size() * blocks, [&](std::size_t task) {
+      const std::size_t begin = task % blocks * BLOCK;
+      const std::size_t end = std::min(begin + BLOCK, bucketCount);
+      if (begin < end) {
+        pass(subtrees[task / blocks], begin, end);
+      }
+    });
+  }
+
+  /* Front to back: the reach of both players, with the current or the
+   * average strategy.
+   */
+  void computeReach(ThreadPool &pool, bool average) {
+    forEachBlock(pool, [&](std::size_t begin, std::size_t end) {
+      for (int player = 0; player < 2; player++) {
+        std::copy(buckets.weight.begin() + begin, buckets.weight.begin() + end,
+                  reach[player].get() + begin);
+      }
+      for (std::uint32_t n : top) {
+        reachBelow(n, begin, end, average);
+      }
+    });
+    forEachSubtree(pool, [&](Subtree subtree, std::size_t begin,
+                             std::size_t end) {
+      for (std::size_t n = subtree.begin; n < subtree.end; n++) {
+        reachBelow(n, begin, end, average);
+      }
+    });
+  }
+
+  // Back to front: the counterfactual values of player.
+  void computeValues(ThreadPool &pool, int player, bool bestResponse) {
+    forEachSubtree(pool, [&](Subtree subtree, std::size_t begin,
+                             std::size_t end) {
+      for (std::size_t n = subtree.end; n-- > subtree.begin;) {
+        valueAt(n, player, begin, end, bestResponse);
+      }
+    });
+    forEachBlock(pool, [&](std::size_t begin, std::size_t end) {
+      for (std::size_t i = top.size(); i-- > 0;) {
+        valueAt(top[i], player, begin, end, bestResponse);
+      }
+    });
+  }
+
+public:
+  CfrSolver(const gameSettings &settings, HandBuckets handBuckets)
+      : settings(settings), buckets(std::move(handBuckets)),
+        bucketCount(buckets.size()) {
+    if (bucketCount == 0 or buckets.equity.size() != bucketCount * bucketCount) {
+      throw std::invalid_argument("Every pair of buckets needs an equity.");
+    }
+    float totalWeight = 0;
+    for (float w : buckets.weight) {
+      if (w < 0) {
+        throw std::invalid_argument("Bucket weights can't be negative.");
+      }
+      totalWeight += w;
+    }
+    if (totalWeight <= 0) {
+      throw std::invalid_argument("At least one bucket has to be dealt.");
+    }
+    for (float &w : buckets.weight) {
+      w /= totalWeight;
+    }
+    for (std::size_t i = 0; i < bucketCount; i++) {
+      for (std::size_t j = 0; j < bucketCount; j++) {
+        const float share = buckets.equity[i * bucketCount + j];
+        if (share < 0 or share > 1 or
+            std::abs(share + buckets.equity[j * bucketCount + i] - 1) > 1e-4f) {
+          throw std::invalid_argument("Equities of a pair of buckets have to "
+                                      "add up to 1.");
+        }
+      }
+    }
+    const money smallBlind = static_cast<money>(settings.minBet * 0.5);
+    if (smallBlind == 0 or settings.startingChips <= settings.minBet) {
+      throw std::invalid_argument("Both players need more chips than the big "
+                                  "blind.");
+    }
+
+    stride = (bucketCount + BLOCK - 1) / BLOCK * BLOCK;
+    payoff = AlignedFloats(bucketCount * stride);
+    for (std::size_t i = 0; i < bucketCount; i++) {
+      for (std::size_t j = 0; j < bucketCount; j++) {
+        payoff.get()[j * stride + i] =
+            2 * buckets.equity[i * bucketCount + j] - 1;
+      }
+    }
+
+    BettingState preflop;
+    preflop.bets = {smallBlind, settings.minBet};
+    preflop.committed = preflop.bets;
+    tree.resize(1);
+    addNode(0, preflop);
+    tree.shrink_to_fit();
+
+    regrets = AlignedFloats(decisions * stride * MAX_CFR_ACTIONS);
+    strategySums = AlignedFloats(decisions * stride * MAX_CFR_ACTIONS);
+    reach[0] = AlignedFloats(tree.size() * stride);
+    reach[1] = AlignedFloats(tree.size() * stride);
+    values = AlignedFloats(tree.size() * stride);
+    splitTree();
+  }
+
+  const std::vector<CfrNode> &nodes() const { return tree; }
+  std::size_t decisionCount() const { return decisions; }
+  std::size_t iterations() const { return iterationCount; }
+
+  /* The average strategy of the player to act at node with bucket, one
+   * probability per child.
+   */
+  std::array<float, MAX_CFR_ACTIONS> strategyAt(std::size_t node,
+                                                std::size_t bucket) const {
+    if (node >= tree.size() or !isDecision(tree[node]) or
+        bucket >= bucketCount) {
+      throw std::out_of_range("No decision for this node and bucket.");
+    }
+    std::array<float, MAX_CFR_ACTIONS> strategy{};
+    averageStrategy(tree[node], bucket, strategy.data());
+    return strategy;
+  }
+
+  /* Runs CFR+ iterations, every one updates both players once. */
+  void iterate(ThreadPool &pool, std::size_t count) {
+    for (std::size_t k = 0; k < count; k++) {
+      for (int player = 0; player < 2; player++) {
+        computeReach(pool, false);
+        computeValues(pool, player, false);
+      }
+      iterationCount++;
+    }
+  }
+
+  /* What a best response of player wins per hand against the average
+   * strategy of the other player.
+   */
+  double bestResponseValue(ThreadPool &pool, int player) {
+    computeReach(pool, true);
+    computeValues(pool, player, true);
+    double value = 0;
+    for (std::size_t i = 0; i < bucketCount; i++) {
+      value += static_cast<double>(buckets.weight[i]) * values.get()[i];
+    }
+    return value;
+  }
+
+  double exploitability(ThreadPool &pool) {
+    return (bestResponseValue(pool, 0) + bestResponseValue(pool, 1)) / 2;
+  }
+
+  /* Runs count iterations and measures them, the exploitability is computed
+   * after the clock stopped.
+   */
+  SolveReport solve(ThreadPool &pool, std::size_t count) {
+    auto start = std::chrono::steady_clock::now();
+    iterate(pool, count);
+    auto stop = std::chrono::steady_clock::now();
+
+    SolveReport report;
+    report.iterations = count;
+    report.seconds = std::chrono::duration<double>(stop - start).count();
+    report.iterationsPerSecond =
+        report.seconds > 0 ? static_cast<double>(count) / report.seconds : 0;
+    report.exploitability = exploitability(pool);
+    return report;
+  }
+};
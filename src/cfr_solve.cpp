@@ -0,0 +1,49 @@
+/* Solves the heads-up betting game of Game with CFR+ and reports how fast
+ * and how far it converges.
+ * Usage: cfr_solve <iterations> [buckets] [starting chips] [threads]
+ * Every tenth of the iterations it prints iterations/sec and the
+ * exploitability in chips and milli big blinds per hand.
+ */
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+import game;
+import threadPool;
+import cfrSolver;
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " <iterations> [buckets] [starting chips] [threads]"
+              << std::endl;
+    return 1;
+  }
+  const std::size_t iterations = std::strtoull(argv[1], nullptr, 10);
+  const std::size_t buckets =
+      argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 16;
+  gameSettings settings;
+  if (argc > 3) {
+    settings.startingChips = static_cast<money>(std::strtoul(argv[3], nullptr, 10));
+  }
+  ThreadPool pool(argc > 4 ? std::strtoull(argv[4], nullptr, 10)
+                           : std::thread::hardware_concurrency());
+
+  CfrSolver solver(settings, HandBuckets::ranked(buckets));
+  std::cout << "Betting tree: " << solver.nodes().size() << " nodes, "
+            << solver.decisionCount() << " decisions, " << buckets
+            << " buckets, " << pool.size() << " threads\n";
+
+  const std::size_t step = iterations >= 10 ? iterations / 10 : 1;
+  for (std::size_t done = 0; done < iterations; done += step) {
+    SolveReport report =
+        solver.solve(pool, std::min(step, iterations - done));
+    std::cout << "Iterations: " << solver.iterations()
+              << "  Iterations/sec: " << report.iterationsPerSecond
+              << "  Exploitability: " << report.exploitability
+              << " chips/hand ("
+              << 1000 * report.exploitability / settings.minBet
+              << " mbb/hand)" << std::endl;
+  }
+  return 0;
+}
@@ -0,0 +1,353 @@
+/* This file implements where the decisions of a seat come from.
+ * DecisionSource: Gets a const view of the table (turnInfo) and returns an
+ * Action. The implementations are final, so a game over one of them
+ * (BasicGame<silentIO, BotSource<const RuleBot>>) calls decide directly.
+ * BasicGame<IO, DecisionSource> mixes them at one table through the virtual
+ * call, sourceStrategy plugs one into a strategy seat.
+ *    -HumanSource: Prints the turn and asks through promptAction, on any
+ * pair of streams instead of std::cin and std::cout.
+ *    -ScriptedSource: Plays a fixed list of actions in order, for tests.
+ * Throws std::out_of_range when the list runs out and std::invalid_argument
+ * for an action that isn't legal.
+ *    -BotSource: Asks a bot, one that decides from turnInfo (RuleBot) or
+ * from the GameState of the turn (MctsBot).
+ *    -CallDownBot: Checks or calls every decision, a Decider (callDown) that
+ * needs no source at all.
+ *    -RemoteSource: Writes the turn as one line (formatTurn) to a peer and
+ * reads the action back as one line (parseAction). A reply that can't be
+ * read or isn't legal checks or folds and counts as a fault.
+ * The line protocol:
+ *    turn seat 2 street flop round 3 pot 45 high 20 bet 0 chips 180
+ *    players 3 hole AsKd board Jc7d2c moves check raise:30-180 allin:180
+ * Cards are rank (23456789TJQKA) and suit (cdhs), "-" for no board. A move
+ * is the action with its least and most amount, the same amount once when
+ * they are equal. The answer is the action and, for bets and raises, the
+ * amount: "raise 60". Amounts mean what they mean in LegalMoves, without
+ * one (or 0) the least amount is played.
+ */
+module;
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+export module decisionSource;
+import cards;
+import game;
+import player;
+
+export class DecisionSource {
+public:
+  virtual ~DecisionSource() = default;
+  virtual Action decide(const turnInfo &info) = 0;
+};
+
+constexpr std::array<std::string_view, ACTION_COUNT> PROTOCOL_ACTIONS = {
+    "fold", "check", "call", "raise", "allin", "bet"};
+constexpr std::array<std::string_view, 5> PROTOCOL_STREETS = {
+    "preflop", "flop", "turn", "river", "showdown"};
+
+// Two characters per card, "As" for the ace of spades.
+export void appendCardCode(std::string &out, Card card) {
+  static constexpr std::string_view RANKS = "23456789TJQKA";
+  static constexpr std::string_view SUITS = "cdhs";
+  out += RANKS[static_cast<int>(card.getRank()) - 2];
+  out += SUITS[static_cast<int>(card.getSuit())];
+}
+
+/* The turn as one line of the protocol, without the newline. */
+export std::string formatTurn(const turnInfo &info) {
+  std::string line;
+  line.reserve(160);
+  auto field = [&line](std::string_view key, std::uint64_t value) {
+    line += ' ';
+    line += key;
+    line += ' ';
+    line += std::to_string(value);
+  };
+  line += "turn";
+  field("seat", static_cast<std::uint64_t>(info.seat));
+  line += " street ";
+  line += PROTOCOL_STREETS[static_cast<int>(info.gameState)];
+  field("round", info.currentRound);
+  field("pot", info.pot);
+  field("high", info.highestBet);
+  field("bet", info.player.getCurrentBet());
+  field("chips", info.player.getChips());
+  field("players", static_cast<std::uint64_t>(info.playersInHand));
+  line += " hole ";
+  for (Card card : info.player.getHand()) {
+    appendCardCode(line, card);
+  }
+  line += " board ";
+  if (info.communityCards.empty()) {
+    line += '-';
+  }
+  for (Card card : info.communityCards) {
+    appendCardCode(line, card);
+  }
+  line += " moves";
+  for (actions act : info.validMoves) {
+    line += ' ';
+    line += PROTOCOL_ACTIONS[static_cast<int>(act)];
+    if (act == actions::fold or act == actions::check) {
+      continue;
+    }
+    line += ':';
+    line += std::to_string(info.validMoves.minAmount(act));
+    if (info.validMoves.maxAmount(act) != info.validMoves.minAmount(act)) {
+      line += '-';
+      line += std::to_string(info.validMoves.maxAmount(act));
+    }
+  }
+  return line;
+}
+
+/* The moves of a turn line, what a bot reads back from formatTurn. Throws
+ * std::invalid_argument when line has no moves or an amount that doesn't fit
+ * money.
+ */
+export LegalMoves parseMoves(std::string_view line) {
+  const std::size_t start = line.find(" moves");
+  if (line.rfind("turn", 0) != 0 or start == std::string_view::npos) {
+    throw std::invalid_argument("Not a turn: " + std::string(line));
+  }
+  auto number = [](std::string_view digits) {
+    if (digits.empty() or digits.size() > 10) {
+      throw std::invalid_argument("Bad amount in a move.");
+    }
+    std::uint64_t value = 0;
+    for (char digit : digits) {
+      if (digit < '0' or digit > '9') {
+        throw std::invalid_argument("Bad amount in a move.");
+      }
+      value = value * 10 + static_cast<std::uint64_t>(digit - '0');
+    }
+    if (value > std::numeric_limits<money>::max()) {
+      throw std::invalid_argument("Bad amount in a move.");
+    }
+    return static_cast<money>(value);
+  };
+
+  LegalMoves moves;
+  std::string_view rest = line.substr(start + 6);
+  while (!rest.empty()) {
+    if (rest.front() == ' ' or rest.front() == '\r') {
+      rest.remove_prefix(1);
+      continue;
+    }
+    const std::string_view move = rest.substr(0, rest.find_first_of(" \r"));
+    rest.remove_prefix(move.size());
+    const std::string_view name = move.substr(0, move.find(':'));
+    int index = 0;
+    while (index < ACTION_COUNT and PROTOCOL_ACTIONS[index] != name) {
+      index++;
+    }
+    if (index == ACTION_COUNT) {
+      throw std::invalid_argument("Unknown move: " + std::string(move));
+    }
+    money least = 0;
+    money most = 0;
+    if (name.size() < move.size()) {
+      const std::string_view amounts = move.substr(name.size() + 1);
+      const std::size_t dash = amounts.find('-');
+      least = number(amounts.substr(0, dash));
+      most = dash == std::string_view::npos ? least
+                                            : number(amounts.substr(dash + 1));
+    }
+    moves.allow(static_cast<actions>(index), least, most);
+  }
+  return moves;
+}
+
+/* act for amount, the least amount of act for 0. Throws
+ * std::invalid_argument when that isn't one of moves.
+ */
+export Action answerOf(actions act, std::uint64_t amount,
+                       const LegalMoves &moves, size_t currentRound) {
+  if (!moves.isLegal(act)) {
+    throw std::invalid_argument("The answer isn't a legal action.");
+  }
+  if (amount == 0) {
+    amount = moves.minAmount(act);
+  }
+  if (amount < moves.minAmount(act) or amount > moves.maxAmount(act)) {
+    throw std::invalid_argument("The amount of the answer isn't legal.");
+  }
+  return Action{act, static_cast<money>(amount), currentRound};
+}
+
+/* Reads an answer of the protocol. Throws std::invalid_argument when line
+ * isn't an action or not one of moves.
+ */
+export Action parseAction(std::string_view line, const LegalMoves &moves,
+                          size_t currentRound) {
+  while (!line.empty() and (line.back() == '\r' or line.back() == ' ')) {
+    line.remove_suffix(1);
+  }
+  const std::size_t space = line.find(' ');
+  const std::string_view name = line.substr(0, space);
+  int index = 0;
+  while (index < ACTION_COUNT and PROTOCOL_ACTIONS[index] != name) {
+    index++;
+  }
+  if (index == ACTION_COUNT) {
+    throw std::invalid_argument("Unknown action: " + std::string(line));
+  }
+
+  std::uint64_t amount = 0;
+  if (space != std::string_view::npos) {
+    const std::string_view digits = line.substr(space + 1);
+    if (digits.empty() or digits.size() > 10) {
+      throw std::invalid_argument("Bad amount: " + std::string(line));
+    }
+    for (char digit : digits) {
+      if (digit < '0' or digit > '9') {
+        throw std::invalid_argument("Bad amount: " + std::string(line));
+      }
+      amount = amount * 10 + static_cast<std::uint64_t>(digit - '0');
+    }
+  }
+  return answerOf(static_cast<actions>(index), amount, moves, currentRound);
+}
+
+/* The answer to a turn line, what parseAction reads. amount 0 leaves it out.
+ */
+export std::string formatAnswer(actions act, money amount) {
+  std::string line(PROTOCOL_ACTIONS[static_cast<int>(act)]);
+  if (amount != 0) {
+    line += ' ';
+    line += std::to_string(amount);
+  }
+  return line;
+}
+
+// Checks when it can, calls otherwise and never folds with chips to call.
+export actions callDown(const LegalMoves &moves) {
+  if (moves.isLegal(actions::check)) {
+    return actions::check;
+  }
+  return moves.isLegal(actions::call) ? actions::call : actions::allIn;
+}
+
+/* Plays callDown, the reference bot of poker_arena and a Decider for tests
+ * and benchmarks.
+ */
+export struct CallDownBot {
+  Action decide(const turnInfo &info) const {
+    const actions act = callDown(info.validMoves);
+    return Action{act, info.validMoves.minAmount(act), info.currentRound};
+  }
+};
+
+export class HumanSource final : public DecisionSource {
+private:
+  std::istream &in;
+  std::ostream &out;
+
+public:
+  HumanSource(std::istream &in, std::ostream &out) : in(in), out(out) {}
+
+  Action decide(const turnInfo &info) override {
+    std::string cards;
+    for (Card card : info.player.getHand()) {
+      appendCardCode(cards, card);
+    }
+    cards += " |";
+    for (Card card : info.communityCards) {
+      cards += ' ';
+      appendCardCode(cards, card);
+    }
+    out << "\n" << info.player.getName() << " (" << info.player.getChips()
+        << " chips) on the " << gameStateName(info.gameState) << ": " << cards
+        << "\nPot: " << info.pot << ", highest bet: " << info.highestBet
+        << "\n"
+        << std::endl;
+    return promptAction(info.validMoves, info.currentRound, in, out);
+  }
+};
+
+export class ScriptedSource final : public DecisionSource {
+private:
+  std::vector<Action> script;
+  std::size_t next = 0;
+
+public:
+  explicit ScriptedSource(std::vector<Action> script)
+      : script(std::move(script)) {}
+
+  Action decide(const turnInfo &info) override {
+    if (next == script.size()) {
+      throw std::out_of_range("The script has no more actions.");
+    }
+    Action action = script[next++];
+    if (!info.validMoves.isLegal(action.action)) {
+      throw std::invalid_argument("The scripted action isn't legal.");
+    }
+    action.roundCounter = info.currentRound;
+    return action;
+  }
+
+  // Actions not played yet.
+  std::size_t remaining() const { return script.size() - next; }
+};
+
+/* Bot is shared, the same bot can serve several sources. */
+export template <typename Bot> class BotSource final : public DecisionSource {
+private:
+  std::shared_ptr<Bot> bot;
+
+public:
+  explicit BotSource(std::shared_ptr<Bot> bot) : bot(std::move(bot)) {}
+
+  Action decide(const turnInfo &info) override {
+    if constexpr (requires { bot->decide(info); }) {
+      return bot->decide(info);
+    } else {
+      Action action = bot->decide(info.state());
+      action.roundCounter = info.currentRound;
+      return action;
+    }
+  }
+};
+
+/* The peer reads turns from out and answers on in, a line each. */
+export class RemoteSource final : public DecisionSource {
+private:
+  std::istream &in;
+  std::ostream &out;
+  std::string reply;
+  std::uint64_t faultCount = 0;
+
+public:
+  RemoteSource(std::istream &in, std::ostream &out) : in(in), out(out) {}
+
+  Action decide(const turnInfo &info) override {
+    out << formatTurn(info) << '\n' << std::flush;
+    if (std::getline(in, reply)) {
+      try {
+        return parseAction(reply, info.validMoves, info.currentRound);
+      } catch (const std::invalid_argument &) {
+        // Falls through to the fallback like a peer that went away.
+      }
+    }
+    faultCount++;
+    return fallbackAction(info.validMoves, info.currentRound);
+  }
+
+  // Answers that were missing, unreadable or not legal.
+  std::uint64_t faults() const { return faultCount; }
+};
+
+/* A strategy that asks source, for setStrategy of a game or a manager. */
+export strategy sourceStrategy(std::shared_ptr<DecisionSource> source) {
+  return [source](const turnInfo &info) { return source->decide(info); };
+}
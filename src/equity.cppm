@@ -0,0 +1,255 @@
+/* This file implements all-in equity calculations between known hands.
+ * monteCarloEquity: Deals the missing community cards at random and counts
+ * how often every hand wins or ties.
+ *    -The live cards are taken from a fresh Deck minus the dead cards, every
+ * sample draws the missing board cards with a partial Fisher-Yates shuffle.
+ *    -Samples are cut into fixed size chunks, every chunk has its own random
+ * stream derived from the seed and the chunk number. The result therefore only
+ * depends on the seed and not on the amount of threads.
+ *    -Every chunk counts into its own slot, the slots are summed once all
+ * threads are done, so threads never share a counter.
+ * exactEquity: Visits every possible runout of the board once instead.
+ *    -Runouts are the combinations of the live cards in lexicographic order
+ * of their Deck position.
+ *    -Split pots are counted in integer units of 1/2520 (2520 is divisible by
+ * every player count up to 10), so the result is bit-exact and identical
+ * with or without a thread pool.
+ */
+module;
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+export module equity;
+import cards;
+import bestHand;
+import threadPool;
+import prng;
+
+export constexpr std::size_t MAX_EQUITY_PLAYERS = 10;
+export constexpr std::size_t BOARD_SIZE = 5;
+
+/* Per hand, the fraction of runouts it won alone, the fraction it tied for
+ * the best hand, and its share of the pot (wins plus split shares).
+ */
+export struct EquityResult {
+  std::vector<double> win;
+  std::vector<double> tie;
+  std::vector<double> equity;
+  std::uint64_t samples = 0;
+};
+
+namespace {
+
+constexpr std::size_t SAMPLES_PER_CHUNK = 1 << 14;
+constexpr std::uint64_t SHARE_UNITS = 2520; // lcm(1, ..., 10)
+
+struct alignas(64) ChunkTally {
+  std::array<std::uint64_t, MAX_EQUITY_PLAYERS> wins{};
+  std::array<std::uint64_t, MAX_EQUITY_PLAYERS> ties{};
+  std::array<std::uint64_t, MAX_EQUITY_PLAYERS> shares{};
+  std::uint64_t samples = 0;
+};
+
+/* The hands and board of one equity question, checked and converted to card
+ * sets once.
+ */
+struct EquitySpot {
+  std::vector<CardSet> hands;
+  CardSet board;
+  std::array<std::uint8_t, 52> live{};
+  int liveCount = 0;
+  int missing = 0;
+};
+
+EquitySpot prepareSpot(const std::vector<std::vector<Card>> &holeCards,
+                       const std::vector<Card> &board) {
+  if (holeCards.size() < 2 or holeCards.size() > MAX_EQUITY_PLAYERS) {
+    throw std::invalid_argument("Equity needs between 2 and 10 hands.");
+  }
+  if (board.size() > BOARD_SIZE) {
+    throw std::invalid_argument("A board holds at most 5 cards.");
+  }
+
+  EquitySpot spot;
+  CardSet dead;
+  for (const auto &hand : holeCards) {
+    if (hand.size() != 2) {
+      throw std::invalid_argument("Every hand needs exactly 2 hole cards.");
+    }
+    CardSet holeSet(hand);
+    if (holeSet.size() != 2 or !(holeSet & dead).empty()) {
+      throw std::invalid_argument("A card can only be dealt once.");
+    }
+    dead |= holeSet;
+    spot.hands.push_back(holeSet);
+  }
+  spot.board = CardSet(board);
+  if (spot.board.size() != static_cast<int>(board.size()) or
+      !(spot.board & dead).empty()) {
+    throw std::invalid_argument("A card can only be dealt once.");
+  }
+  dead |= spot.board;
+
+  Deck deck;
+  for (std::size_t i = 0; i < deck.size(); i++) {
+    if (!dead.contains(deck[i])) {
+      spot.live[spot.liveCount++] =
+          static_cast<std::uint8_t>(deck[i].toIndex());
+    }
+  }
+  spot.missing = static_cast<int>(BOARD_SIZE - board.size());
+  return spot;
+}
+
+// Evaluates every hand on one full board and books the result.
+void tallyRunout(const EquitySpot &spot, CardSet fullBoard,
+                 ChunkTally &tally) {
+  std::array<HandValue, MAX_EQUITY_PLAYERS> values;
+  HandValue best = 0;
+  for (std::size_t p = 0; p < spot.hands.size(); p++) {
+    values[p] = evaluateHand(spot.hands[p] | fullBoard);
+    best = std::max(best, values[p]);
+  }
+
+  int winners = 0;
+  for (std::size_t p = 0; p < spot.hands.size(); p++) {
+    winners += values[p] == best;
+  }
+  for (std::size_t p = 0; p < spot.hands.size(); p++) {
+    if (values[p] != best) {
+      continue;
+    }
+    if (winners == 1) {
+      tally.wins[p]++;
+    } else {
+      tally.ties[p]++;
+    }
+    tally.shares[p] += SHARE_UNITS / winners;
+  }
+  tally.samples++;
+}
+
+EquityResult mergeTallies(const std::vector<ChunkTally> &tallies,
+                          std::size_t players) {
+  EquityResult result;
+  result.win.assign(players, 0.0);
+  result.tie.assign(players, 0.0);
+  result.equity.assign(players, 0.0);
+  ChunkTally total;
+  for (const auto &tally : tallies) {
+    total.samples += tally.samples;
+    for (std::size_t p = 0; p < players; p++) {
+      total.wins[p] += tally.wins[p];
+      total.ties[p] += tally.ties[p];
+      total.shares[p] += tally.shares[p];
+    }
+  }
+  result.samples = total.samples;
+  for (std::size_t p = 0; p < players and total.samples > 0; p++) {
+    double samples = static_cast<double>(total.samples);
+    result.win[p] = static_cast<double>(total.wins[p]) / samples;
+    result.tie[p] = static_cast<double>(total.ties[p]) / samples;
+    result.equity[p] = static_cast<double>(total.shares[p]) /
+                       (samples * static_cast<double>(SHARE_UNITS));
+  }
+  return result;
+}
+
+/* Visits every combination of `depth` live cards from position `first` on,
+ * adding them to board.
+ */
+template <typename Visitor>
+void forEachRunout(const EquitySpot &spot, int first, int depth, CardSet board,
+                   Visitor &&visit) {
+  if (depth == 0) {
+    visit(board);
+    return;
+  }
+  for (int i = first; i <= spot.liveCount - depth; i++) {
+    forEachRunout(spot, i + 1, depth - 1,
+                  board | CardSet(std::uint64_t{1} << spot.live[i]), visit);
+  }
+}
+
+} // namespace
+
+/* Estimates the equity of every hand from `samples` random runouts of the
+ * board. holeCards holds 2 cards per player and board the 0 to 5 community
+ * cards dealt so far.
+ */
+export EquityResult monteCarloEquity(
+    const std::vector<std::vector<Card>> &holeCards,
+    const std::vector<Card> &board, std::uint64_t samples, ThreadPool &pool,
+    std::uint64_t seed = 0) {
+  const EquitySpot spot = prepareSpot(holeCards, board);
+  const std::size_t chunks =
+      static_cast<std::size_t>((samples + SAMPLES_PER_CHUNK - 1) /
+                               SAMPLES_PER_CHUNK);
+  std::vector<ChunkTally> tallies(chunks);
+
+  pool.parallelFor(chunks, [&](std::size_t chunk) {
+    Xoshiro256 rng(seed, chunk);
+
+    std::array<std::uint8_t, 52> live = spot.live;
+    ChunkTally &tally = tallies[chunk];
+    std::uint64_t begin = chunk * SAMPLES_PER_CHUNK;
+    std::uint64_t end = std::min<std::uint64_t>(samples,
+                                                begin + SAMPLES_PER_CHUNK);
+
+    for (std::uint64_t s = begin; s < end; s++) {
+      CardSet fullBoard = spot.board;
+      for (int k = 0; k < spot.missing; k++) {
+        std::uint32_t left = static_cast<std::uint32_t>(spot.liveCount - k);
+        std::uint32_t pick = uniformBelow(rng, left);
+        std::swap(live[k], live[k + pick]);
+        fullBoard |= CardSet(std::uint64_t{1} << live[k]);
+      }
+      tallyRunout(spot, fullBoard, tally);
+    }
+  });
+
+  return mergeTallies(tallies, spot.hands.size());
+}
+
+/* Computes the exact equity of every hand by evaluating all runouts of the
+ * board. Cheap from the flop on (990 runouts heads-up), preflop it visits
+ * 1.7 million runouts and the pool overload is the better choice.
+ */
+export EquityResult exactEquity(const std::vector<std::vector<Card>> &holeCards,
+                                const std::vector<Card> &board) {
+  const EquitySpot spot = prepareSpot(holeCards, board);
+  std::vector<ChunkTally> tallies(1);
+  forEachRunout(spot, 0, spot.missing, spot.board, [&](CardSet fullBoard) {
+    tallyRunout(spot, fullBoard, tallies[0]);
+  });
+  return mergeTallies(tallies, spot.hands.size());
+}
+
+/* Same as exactEquity, but the runouts are split over the pool by their first
+ * card.
+ */
+export EquityResult exactEquity(const std::vector<std::vector<Card>> &holeCards,
+                                const std::vector<Card> &board,
+                                ThreadPool &pool) {
+  const EquitySpot spot = prepareSpot(holeCards, board);
+  if (spot.missing == 0) {
+    return exactEquity(holeCards, board);
+  }
+
+  const std::size_t firstCards =
+      static_cast<std::size_t>(spot.liveCount - spot.missing + 1);
+  std::vector<ChunkTally> tallies(firstCards);
+  pool.parallelFor(firstCards, [&](std::size_t first) {
+    CardSet start =
+        spot.board | CardSet(std::uint64_t{1} << spot.live[first]);
+    forEachRunout(spot, static_cast<int>(first) + 1, spot.missing - 1, start,
+                  [&](CardSet fullBoard) {
+                    tallyRunout(spot, fullBoard, tallies[first]);
+                  });
+  });
+  return mergeTallies(tallies, spot.hands.size());
+}
@@ -0,0 +1,2198 @@
+/* This file implements the poker engine. It does so by providing 2 classes.
+ * BasicGame: Plays a single hand at a table. It is a template over an output
+ * policy:
+ *    -Game (consoleIO) prints the table and asks std::cin for every player
+ * without a strategy, through promptAction.
+ *    -HeadlessGame (silentIO) has every console statement compiled out and
+ * takes all its decisions from strategies.
+ *    -setStrategy plugs a decision callback into a seat. randomStrategy
+ * plays a random legal move, for simulations, tests and benchmarks.
+ *    -The second template argument is the decision policy. By default every
+ * seat has a strategy (std::function). With a Decider type, like a bot or a
+ * final DecisionSource, setSource points seats at objects of that type and
+ * decide is called on them directly, an all-bot game then pays no indirect
+ * call per decision.
+ *    -setActionListener sees every action a player takes, the replay module
+ * uses it to record hands.
+ *    -setHandHistory appends every logged action, blinds included, to a
+ * binary hand history log.
+ *    -During a hand, chips, bets and folds live in a SeatTable and players
+ * are referred to by seat. The Players are updated when the hand is over and
+ * right before a strategy gets to see one.
+ *    -At the end of a hand the pot is split into a main pot and side pots by
+ * what every seat committed, each goes to the best hand that can win it.
+ *    -What a hand allocates comes from a HandArena inside the game that
+ * resetHand releases in one go. newHand readies the game for another hand at
+ * the same table, a reused game plays its hands without touching the heap.
+ *    -exportState copies the hand at a decision into a GameState,
+ * importState and resumeHand play a hand on from one. A strategy only gets
+ * the view of its seat (turnInfo::state), without the cards of others.
+ * GameState: A hand in progress as trivially copyable data with apply and
+ * legalActions, for searches and what-if analysis that play hands forward
+ * without the game.
+ * Manager: Runs a sequence of hands and moves the blinds around.
+ *    -enableHandHistory writes the actions of all its hands to one log.
+ *    -A seed decides the cards of all its hands, setStrategy plugs a
+ * strategy into a seat for every hand. HeadlessManager plays without a
+ * console, the tournament module runs many of them in parallel.
+ */
+module;
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <assert.h>
+#include <climits>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+export module game;
+import player;
+import cards;
+import bestHand;
+import prng;
+import handHistory;
+import seatTable;
+import sidePots;
+import handArena;
+import logger;
+
+export constexpr int INVALID_POS = INT_MIN;
+export constexpr int AMOUNT_OF_CARDS = 2;
+constexpr int COMMUNITY_CARDS = 5;
+
+export using money = std::uint32_t;
+export using playersPool = std::deque<std::shared_ptr<Player>>;
+export using notActivePlayers = std::vector<std::shared_ptr<Player>>;
+export using position = std::int32_t;
+export enum class actions { fold, check, call, raise, allIn, bet };
+
+export inline const std::map<actions, std::string> actionmessages = {
+    {actions::fold, "Fold your hand"},
+    {actions::check, "Check and pass"},
+    {actions::call, "Call the current bet"},
+    {actions::raise, "Raise the stakes with atleast: "},
+    {actions::allIn, "Go all in with atleast: "},
+    {actions::bet, "Place a bet with atleast: "}};
+
+export constexpr int ACTION_COUNT = static_cast<int>(actions::bet) + 1;
+
+/* The legal moves of a turn: one bit per action in mask and the amounts of
+ * every legal action. min is the amount a decision plays by default, max the
+ * most it may play. Call and raise amounts are what the bet of the player
+ * becomes this round, bet and all-in amounts are chips put in.
+ * Plain data, so it is copied into every turn instead of built on the heap.
+ */
+export struct LegalMoves {
+  std::uint8_t mask = 0;
+  std::array<money, ACTION_COUNT> min{};
+  std::array<money, ACTION_COUNT> max{};
+
+  static constexpr std::uint8_t bit(actions act) {
+    return static_cast<std::uint8_t>(1u << static_cast<int>(act));
+  }
+
+  constexpr void allow(actions act, money least, money most) {
+    mask |= bit(act);
+    min[static_cast<int>(act)] = least;
+    max[static_cast<int>(act)] = most;
+  }
+
+  constexpr bool isLegal(actions act) const { return mask & bit(act); }
+  constexpr money minAmount(actions act) const {
+    return min[static_cast<int>(act)];
+  }
+  constexpr money maxAmount(actions act) const {
+    return max[static_cast<int>(act)];
+  }
+  constexpr int count() const { return std::popcount(mask); }
+
+  // The index-th legal action in the order of the actions enum.
+  constexpr actions nth(int index) const {
+    unsigned rest = mask;
+    for (; index > 0; index--) {
+      rest &= rest - 1;
+    }
+    return static_cast<actions>(std::countr_zero(rest));
+  }
+
+  // Walks over the legal actions in the order of the actions enum.
+  class iterator {
+  private:
+    unsigned rest;
+
+  public:
+    constexpr explicit iterator(unsigned bits) : rest(bits) {}
+    constexpr actions operator*() const {
+      return static_cast<actions>(std::countr_zero(rest));
+    }
+    constexpr iterator &operator++() {
+      rest &= rest - 1;
+      return *this;
+    }
+    constexpr bool operator==(const iterator &other) const = default;
+  };
+  constexpr iterator begin() const { return iterator(mask); }
+  constexpr iterator end() const { return iterator(0); }
+};
+static_assert(std::is_trivially_copyable_v<LegalMoves>);
+
+/* The legal moves of a seat with chips left that already bet alreadyBet this
+ * round, shared by the game and GameState.
+ */
+constexpr LegalMoves legalMovesOf(money alreadyBet, money chips,
+                                  money highestBet, money raiseAmount,
+                                  money minBet, bool aBetHasBeenPlaced) {
+  LegalMoves moves;
+
+  // Fold is always valid, all-in always puts in all chips.
+  moves.allow(actions::fold, 0, 0);
+  moves.allow(actions::allIn, chips, chips);
+
+  // can only check if a bet has been placed. in PR, always true.
+  if (!aBetHasBeenPlaced) {
+    moves.allow(actions::check, 0, 0);
+  }
+
+  // Call and raise amounts are what the player's bet becomes in this round,
+  // the player only pays the difference with what he already put in.
+  if ((aBetHasBeenPlaced) and (highestBet >= alreadyBet) and
+      (chips >= highestBet - alreadyBet)) {
+    moves.allow(actions::call, highestBet, highestBet);
+  }
+
+  if ((aBetHasBeenPlaced) and (raiseAmount + highestBet > alreadyBet) and
+      (chips >= raiseAmount + highestBet - alreadyBet)) {
+    moves.allow(actions::raise, raiseAmount + highestBet, alreadyBet + chips);
+  }
+
+  if ((aBetHasBeenPlaced == false) and (chips >= minBet)) {
+    moves.allow(actions::bet, minBet, chips);
+  }
+  return moves;
+}
+
+export enum class gameStates { preFlop, flop, turn, river, showDown };
+
+export const char *gameStateName(gameStates state) {
+  switch (state) {
+  case gameStates::preFlop:
+    return "Pre-Flop";
+  case gameStates::flop:
+    return "Flop";
+  case gameStates::turn:
+    return "Turn";
+  case gameStates::river:
+    return "River";
+  case gameStates::showDown:
+    return "Show Down";
+  }
+  return "Unknown";
+}
+
+export struct Action {
+  actions action;
+  money bet;
+  size_t roundCounter;
+};
+
+// Whether action is one of moves, its amount included.
+export constexpr bool allowsAction(const LegalMoves &moves,
+                                   const Action &action) {
+  return moves.isLegal(action.action) and
+         action.bet >= moves.minAmount(action.action) and
+         action.bet <= moves.maxAmount(action.action);
+}
+
+// What a seat plays when its decision is no good: check, or fold.
+export Action fallbackAction(const LegalMoves &moves, size_t currentRound) {
+  return Action{moves.isLegal(actions::check) ? actions::check : actions::fold,
+                0, currentRound};
+}
+export using playersHistory = std::pmr::unordered_map<int, Action>;
+
+export constexpr int STATE_SEATS = 10;
+
+/* A hand in progress as plain data: what the game would do next only depends
+ * on this, so a search copies it with memcpy and plays it forward on its own.
+ *    -actor is the seat to act, legalActions its moves and apply plays one of
+ * them. apply then moves on to the next seat to act, deals the next street
+ * when the betting round is over and pays the pots at the end of the hand,
+ * exactly like the game loop does. actor is -1 once the hand is over.
+ *    -The deck and generator are part of the state, a copy deals the same
+ * streets as the game. Give rng a new seed to deal other ones.
+ *    -Tables of up to STATE_SEATS seats, a few hundred bytes.
+ * BasicGame::exportState takes one at a decision, importState and resumeHand
+ * play the rest of a hand from one.
+ */
+export struct GameState {
+  std::array<money, STATE_SEATS> chips{};
+  std::array<money, STATE_SEATS> bets{};      // This betting round.
+  std::array<money, STATE_SEATS> committed{}; // This hand.
+  std::array<std::array<Card, AMOUNT_OF_CARDS>, STATE_SEATS> holeCards{};
+  std::array<Card, COMMUNITY_CARDS> board{};
+  Deck deck;
+  Xoshiro256 rng;
+  money pot = 0;
+  money highestBet = 0;
+  money raiseAmount = 0;
+  money minBet = 0;
+  std::uint32_t currentRound = 0;
+  seatMask active = 0;
+  seatMask folded = 0;
+  gameStates street = gameStates::preFlop;
+  std::int8_t seats = 0;
+  std::int8_t boardCards = 0;
+  std::int8_t dealer = 0;
+  std::int8_t smallBlind = 0;
+  std::int8_t bigBlind = 0;
+  std::int8_t actor = -1;
+  // The bookkeeping of BasicGame::getNextPlayerInSequence.
+  std::int8_t actionTaker = -1;
+  std::int8_t lastTurnPlayer = -1;
+  std::int8_t leftOfDealer = -1;
+  bool aBetHasBeenPlaced = false;
+  bool firstIterationOfRound = true;
+  bool firstTime = true;
+  bool killSwitch = false;
+  bool freePassForLeftOfDealer = false;
+
+  bool isTerminal() const { return actor < 0; }
+
+  LegalMoves legalActions() const {
+    if (isTerminal()) {
+      return LegalMoves{};
+    }
+    return legalMovesOf(bets[actor], chips[actor], highestBet, raiseAmount,
+                        minBet, aBetHasBeenPlaced);
+  }
+
+  /* Plays action for actor. Throws std::logic_error when the hand is over
+   * and std::invalid_argument for an action or amount legalActions doesn't
+   * allow.
+   */
+  void apply(const Action &action) {
+    if (isTerminal()) {
+      throw std::logic_error("The hand of this state is over.");
+    }
+    if (!allowsAction(legalActions(), action)) {
+      throw std::invalid_argument("Not a legal action in this state.");
+    }
+
+    const int seat = actor;
+    switch (action.action) {
+    case actions::fold:
+      folded |= bit(seat);
+      if (seat == leftOfDealer) {
+        const int newLeft = nextInHandAfter(dealer);
+        leftOfDealer = static_cast<std::int8_t>(
+            newLeft != -1 ? newLeft : leftOfDealer);
+        freePassForLeftOfDealer = true;
+      }
+      break;
+    case actions::check:
+      break;
+    case actions::call:
+      pot += putIn(seat, action.bet > bets[seat] ? action.bet - bets[seat]
+                                                 : 0);
+      break;
+    case actions::raise:
+      pot += putIn(seat, action.bet - bets[seat]);
+      highestBet = action.bet;
+      actionTaker = static_cast<std::int8_t>(seat);
+      break;
+    case actions::allIn:
+      pot += putIn(seat, action.bet);
+      if (bets[seat] > highestBet) {
+        highestBet = bets[seat];
+        actionTaker = static_cast<std::int8_t>(seat);
+      }
+      break;
+    case actions::bet:
+      pot += putIn(seat, action.bet);
+      highestBet = std::max(highestBet, bets[seat]);
+      aBetHasBeenPlaced = true;
+      actionTaker = static_cast<std::int8_t>(seat);
+      break;
+    }
+    firstIterationOfRound = false;
+    advance();
+  }
+
+  std::span<const Card> communityCards() const {
+    return {board.data(), static_cast<std::size_t>(boardCards)};
+  }
+
+  /* What seat knows of the hand. The hole cards of the other seats are
+   * default Cards, the deck holds every card seat doesn't see and the
+   * generator is seeded from the round, so neither gives away the cards of
+   * others or the streets to come. Deal the other seats cards from the deck
+   * before playing the view to a showdown.
+   */
+  GameState viewOf(int seat) const {
+    GameState view = *this;
+    for (int other = 0; other < seats; other++) {
+      if (other != seat) {
+        view.holeCards[other] = {};
+      }
+    }
+    view.deck = Deck(CardSet::fullDeck() - CardSet(holeCards[seat]) -
+                     CardSet(communityCards()));
+    view.rng = Xoshiro256(currentRound);
+    return view;
+  }
+
+  // What SidePots needs of a table.
+  int size() const { return seats; }
+  money committedOf(int seat) const { return committed[seat]; }
+  seatMask inHandSeats() const { return active & ~folded; }
+  int inHandCount() const { return std::popcount(inHandSeats()); }
+  void addChips(int seat, money amount) { chips[seat] += amount; }
+
+private:
+  static constexpr seatMask bit(int seat) { return seatMask{1} << seat; }
+
+  money putIn(int seat, money amount) {
+    chips[seat] -= amount;
+    bets[seat] += amount;
+    committed[seat] += amount;
+    return amount;
+  }
+
+  // SeatTable::firstInHandFrom.
+  int firstInHandFrom(int start) const {
+    const seatMask inHand = inHandSeats();
+    const seatMask fromStart = inHand & (~seatMask{0} << start);
+    if (fromStart != 0) {
+      return std::countr_zero(fromStart);
+    }
+    return inHand != 0 ? std::countr_zero(inHand) : -1;
+  }
+
+  // BasicGame::getNextActiveAfter.
+  int nextInHandAfter(int seat) const {
+    if (seat < 0) {
+      return -1;
+    }
+    const int candidate = firstInHandFrom((seat + 1) % seats);
+    return candidate == seat ? -1 : candidate;
+  }
+
+  // BasicGame::getNextPlayerInSequence.
+  int nextInSequence() {
+    if (killSwitch) {
+      killSwitch = false;
+      return -1;
+    }
+    const int next = firstInHandFrom((lastTurnPlayer + 1) % seats);
+    leftOfDealer = static_cast<std::int8_t>(nextInHandAfter(dealer));
+    if (actionTaker == -1 and next == leftOfDealer and
+        !firstIterationOfRound) {
+      if (!freePassForLeftOfDealer) {
+        return -1;
+      }
+      freePassForLeftOfDealer = false;
+    }
+    if (actionTaker != -1 and next == actionTaker) {
+      if (actionTaker == bigBlind and firstTime) {
+        firstTime = false;
+        killSwitch = true;
+        return next;
+      }
+      return -1;
+    }
+    return next;
+  }
+
+  /* Finds the next seat to act, going through the following streets like
+   * BasicGame::subRoundHandler when the betting round is over.
+   */
+  void advance() {
+    while (true) {
+      const int next = nextInSequence();
+      if (next != -1 and inHandCount() > 1) {
+        actor = static_cast<std::int8_t>(next);
+        lastTurnPlayer = actor;
+        return;
+      }
+
+      lastTurnPlayer = dealer;
+      actionTaker = -1;
+      bets.fill(0);
+      highestBet = 0;
+      street = static_cast<gameStates>(static_cast<int>(street) + 1);
+      if (inHandCount() <= 1 or street == gameStates::showDown) {
+        finish();
+        return;
+      }
+
+      aBetHasBeenPlaced = false;
+      deck.burnCard(rng);
+      const int cards = street == gameStates::flop ? 3 : 1;
+      for (int i = 0; i < cards; i++) {
+        board[boardCards++] = deck.dealCard(rng);
+      }
+      currentRound++;
+      firstIterationOfRound = true;
+    }
+  }
+
+  // Pays the pots like BasicGame::payOut, the hand is over afterwards.
+  void finish() {
+    std::array<HandValue, MAX_SEATS> values{};
+    if (street == gameStates::showDown) {
+      const CardSet shown(communityCards());
+      for (seatMask inHand = inHandSeats(); inHand != 0;
+           inHand &= inHand - 1) {
+        const int seat = std::countr_zero(inHand);
+        values[seat] = evaluateHand(CardSet(holeCards[seat]) | shown);
+      }
+    }
+    SidePots pots;
+    pots.build(*this);
+    pots.settle(*this, values, dealer);
+    pot = 0;
+    actor = -1;
+  }
+};
+static_assert(std::is_trivially_copyable_v<GameState>);
+static_assert(sizeof(GameState) <= 512);
+
+export struct gameSettings {
+  size_t minAmountPlayers = 2;
+  size_t maxAmountPlayers = 6;
+  money minBet = 10;
+  money startingChips = 100;
+  size_t maximumRounds = 10;
+};
+
+export struct positions {
+  position dealerPosition = 0;
+  position posBB = 1;
+  position posSB = 2;
+};
+
+export struct whoPlays {
+  position ActionTaker;
+  position LastTurnPlayer;
+};
+
+/* What a strategy gets to see when it is a player's turn. */
+export struct turnInfo {
+  const Player &player;
+  position seat;
+  LegalMoves validMoves;
+  std::span<const Card> communityCards;
+  money pot;
+  money highestBet;
+  gameStates gameState;
+  size_t currentRound;
+  positions gamePositions;
+  int playersInHand; // Active and not folded, the player included.
+  int seats;
+  // The game asking, state() exports it through exportGame.
+  const void *game = nullptr;
+  GameState (*exportGame)(const void *game) = nullptr;
+
+  /* The hand as the seat to act sees it, BasicGame::exportState through
+   * GameState::viewOf. Searching strategies play it forward once they dealt
+   * the hidden cards themselves.
+   */
+  GameState state() const {
+    if (exportGame == nullptr) {
+      throw std::logic_error("This turn has no game to export.");
+    }
+    return exportGame(game).viewOf(seat);
+  }
+};
+
+/* A strategy picks one of the valid moves in turnInfo. */
+export using strategy = std::function<Action(const turnInfo &)>;
+
+/* Picks one of the valid moves uniformly from rng, bets and raises use the
+ * minimum. rng has to outlive the strategy.
+ */
+export strategy randomStrategy(Xoshiro256 &rng) {
+  return [&rng](const turnInfo &info) {
+    const LegalMoves &moves = info.validMoves;
+    actions chosen = moves.nth(static_cast<int>(uniformBelow(
+        rng, static_cast<std::uint32_t>(moves.count()))));
+    return Action{chosen, moves.minAmount(chosen), info.currentRound};
+  };
+}
+
+/* A type that picks the moves itself, for the decision policy of BasicGame.
+ */
+export template <typename T>
+concept Decider = requires(T &source, const turnInfo &info) {
+  { source.decide(info) } -> std::same_as<Action>;
+};
+
+/* Asks for one of validMoves on in, with the options printed to out. A bet or
+ * raise also asks for the amount until it is one of the legal amounts. A
+ * choice that isn't offered folds.
+ */
+export Action promptAction(const LegalMoves &validMoves, size_t currentRound,
+                           std::istream &in, std::ostream &out) {
+  std::array<actions, ACTION_COUNT> offeredOptions;
+
+  out << "Available actions:\n" << std::endl;
+  int offered = 0;
+  for (actions act : validMoves) {
+    out << offered + 1 << ") " << actionmessages.at(act)
+        << " [Amount: " << validMoves.minAmount(act) << "]\n"
+        << std::endl;
+    offeredOptions[offered++] = act;
+  }
+
+  out << "Enter the number of your choice: " << std::endl;
+  int choice = 0;
+  in >> choice;
+
+  if (choice < 1 or choice > offered) {
+    out << "Invalid choice, defaulting to fold.\n" << std::endl;
+    return Action{actions::fold, 0, 0};
+  }
+
+  actions selected = offeredOptions[choice - 1];
+  money chosenAmount = validMoves.minAmount(selected);
+
+  // For bet and raise, allow custom amount input starting from the minimum.
+  if (selected == actions::bet or selected == actions::raise) {
+    const money minAmount = chosenAmount;
+    const money maxAmount = validMoves.maxAmount(selected);
+    std::string actionName = (selected == actions::bet) ? "bet" : "raise";
+    out << "You can " << actionName << " from " << minAmount << " to "
+        << maxAmount << " chips.\n"
+        << std::endl;
+    out << "How much would you like to " << actionName << "? " << std::endl;
+
+    in >> chosenAmount;
+    while (in.fail() or chosenAmount < minAmount or chosenAmount > maxAmount) {
+      if (in.eof()) {
+        out << "No more input, defaulting to fold.\n" << std::endl;
+        return Action{actions::fold, 0, 0};
+      }
+      in.clear();
+      in.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+      out << "Invalid amount. Please enter an amount from " << minAmount
+          << " to " << maxAmount << ": " << std::endl;
+      in >> chosenAmount;
+    }
+  }
+
+  return Action{selected, chosenAmount, currentRound};
+}
+
+/* Called with the seat and the action every time a player acts. */
+export using actionListener = std::function<void(position, const Action &)>;
+
+/* Output policies for BasicGame. With silentIO every print and every read
+ * from std::cin is compiled out of the game loop.
+ */
+export struct consoleIO {
+  static constexpr bool enabled = true;
+};
+export struct silentIO {
+  static constexpr bool enabled = false;
+};
+
+export struct GameInternals;
+
+export template <typename IO, typename Source = strategy> class BasicGame {
+private:
+  friend struct GameInternals;
+
+  static_assert(std::is_same_v<Source, strategy> or Decider<Source>,
+                "A decision policy is strategy or a Decider.");
+
+  static constexpr bool consoleOutput = IO::enabled;
+  static constexpr bool seatStrategies = std::is_same_v<Source, strategy>;
+  // What a seat decides with, empty or nullptr for the console.
+  using SeatDecision = std::conditional_t<seatStrategies, strategy, Source *>;
+
+  money pot;
+  playersPool players;
+  SeatTable seats;
+  SidePots sidePots;
+  std::array<HandValue, MAX_SEATS> handValues{};
+  Deck deck;
+  HandArena arena; // Per hand, released by resetHand.
+  std::pmr::vector<Card> communityCards{arena.resource()};
+  money highestBet;
+  gameStates gameState;
+  gameSettings settings;
+  money raiseAmount = settings.minBet;
+  positions gamePositions;
+  bool aBetHasBeenPlaced;
+  size_t currentRound = 0;
+  bool firstIterationOfRound = true;
+  bool firstTime = true;
+  bool killSwitch = false;
+  bool freePassForLeftOfDealer = false;
+  position leftPlayerToDealer;
+  position toAct = -1; // The seat whose decision is being asked for.
+  std::array<SeatDecision, MAX_SEATS> strategies{};
+  actionListener listener;
+  HandHistoryWriter *history = nullptr;
+  std::uint64_t historyHand = 0;
+  std::uint64_t seed;
+  Xoshiro256 rng;
+  void checkHoleCards() {
+    for (auto player : players) {
+      std::cout << "Player " << player->getName() << " Has the following cards"
+                << "\n";
+      for (Card card : player->getHand()) {
+        std::cout << " " << card.cardToString() << "\n";
+      }
+      std::cout << "\n";
+    }
+  }
+
+  int getActivePlayers() { return seats.activeCount(); }
+
+  int getNotFoldedPlayers() { return seats.inHandCount(); }
+
+  /* Returns the seat after the last player to act who is active and hasn't
+   * folded.
+   */
+  position getNextActivePlayer() {
+    return seats.firstInHandFrom((currentPlays.LastTurnPlayer + 1) %
+                                 seats.size());
+  }
+
+  // Helper to find the next active player after 'current', -1 if there is
+  // none.
+  position getNextActiveAfter(position current) {
+    if (current < 0) {
+      return -1;
+    }
+    position candidate = seats.nextInHand(current);
+    return candidate == current ? -1 : candidate;
+  }
+
+  void printGameState(gameStates state) {
+    std::cout << "Game state: " << gameStateName(state) << std::endl;
+  }
+
+  /*
+  Shows detailed information for the current player's turn.
+  This function prints more detailed information about the current player,
+  including the player's hole cards, the chips they have, and what the next
+  action is. It then also shows the current game state, such as the highest
+  bet and pot value.
+  */
+  void showTurnInfo(position seat) {
+    const std::shared_ptr<Player> &currentPlayer = players[seat];
+    // Print the entire table first so the user sees all players’ states.
+    std::cout << "\n\n";
+    printPlayersTable();
+
+    // Now show the current player's turn block
+    std::cout << "\n=============================================\n"
+              << std::endl;
+    std::cout << "It's " << currentPlayer->getName() << "'s turn!\n"
+              << std::endl;
+    std::cout << currentPlayer->getName() << " has " << seats.chipsOf(seat)
+              << " chips.\n"
+              << std::endl;
+
+    // Use the helper function to print game state.
+    printGameState(gameState);
+
+    // Show hole cards.
+    std::cout << "Hole Cards:\n";
+    for (const auto &card : currentPlayer->getHand()) {
+      std::cout << "  " << card.cardToString() << "\n" << std::endl;
+    }
+
+    // Who is next?
+    position next = getNextActiveAfter(seat);
+    if (next != -1) {
+      std::cout << "Next to act: " << players[next]->getName() << "\n"
+                << std::endl;
+    } else {
+      std::cout << "No other active players.\n" << std::endl;
+    }
+
+    std::cout << "Highest bet so far: " << highestBet << "\n" << std::endl;
+    std::cout << "Pot: " << pot << "\n" << std::endl;
+    std::cout << "=============================================\n\n"
+              << std::endl;
+  }
+
+  /*
+  Prints a summary table of all players' current states.
+  This function is used to display an overview of every player's chips,
+  blind position, and status (folded/active) for the entire table.
+  */
+  void printPlayersTable() {
+    std::cout << "#   Name        Chips     Blind       Status\n" << std::endl;
+    std::cout << "------------------------------------------\n" << std::endl;
+
+    int playerNumber = 1;
+    for (position seat = 0; seat < seats.size(); seat++) {
+      // Determine blind status as a string
+      std::string blindStatus;
+      switch (seats.blindOf(seat)) {
+      case Blind::dealer:
+        blindStatus = "Dealer";
+        break;
+      case Blind::smallBlind:
+        blindStatus = "SmallBlind";
+        break;
+      case Blind::bigBlind:
+        blindStatus = "BigBlind";
+        break;
+      default:
+        blindStatus = "None";
+        break;
+      }
+
+      // Determine status as a string
+      std::string status;
+      if (!seats.isActive(seat)) {
+        status = (seats.chipsOf(seat) == 0 ? "Out of Chips" : "Inactive");
+      } else {
+        status = (seats.hasFolded(seat) ? "Folded" : "Active");
+      }
+
+      // Print row
+      std::cout << std::left << std::setw(4) << playerNumber << std::setw(12)
+                << players[seat]->getName() << std::setw(10)
+                << seats.chipsOf(seat)
+                << std::setw(12) << blindStatus << std::setw(10) << status
+                << std::endl;
+      playerNumber++;
+    }
+    std::cout << "------------------------------------------\n" << std::endl;
+  }
+
+  /* Decides which player plays next.
+   * This should decide who the actionTaker is and check if we are already at
+   * that actiontaker.
+   * Returns the seat of the player who should play.
+   * If the returned seat is -1. There should be no next player.
+   * Note that this function relies on the caller to reset the actionTaker
+   * when we did encounter a NULL return.
+   */
+  position getNextPlayerInSequence() {
+    if (killSwitch) {
+      if constexpr (consoleOutput) {
+        std::cout << "\nKILLSWITCH ACTIVATED\n" << std::endl;
+      }
+      killSwitch = false;
+      return -1;
+    }
+
+    position nextPlayer = getNextActivePlayer();
+
+    // Recompute LeftOfDealer to ensure we always have a valid, non-folded seat.
+    position leftOfDealerCandidate =
+        getNextActiveAfter(gamePositions.dealerPosition);
+    leftPlayerToDealer = leftOfDealerCandidate;
+    logDebug("Left of dealer: {}, next player: {}", leftPlayerToDealer,
+             nextPlayer);
+
+    // If nextPlayer equals LeftOfDealer in a non-first iteration,
+    // normally we would return nullptr to signal the end of the betting round.
+    // However, if freePassForLeftOfDealer is active, we allow this player to
+    // act and clear the flag.
+    if ((currentPlays.ActionTaker == -1) and
+        (nextPlayer == leftOfDealerCandidate) and !firstIterationOfRound) {
+      if (freePassForLeftOfDealer) {
+        logDebug("Free pass active for left of dealer, allowing action.");
+        freePassForLeftOfDealer = false;
+      } else {
+        logDebug("ActionTaker -1, next is left of dealer, not first round.");
+        return -1;
+      }
+    }
+
+    if ((currentPlays.ActionTaker != -1) and
+        (nextPlayer == currentPlays.ActionTaker)) {
+      logDebug("ActionTaker not -1, next is the action taker.");
+      if (currentPlays.ActionTaker == gamePositions.posBB and firstTime) {
+        firstTime = false;
+        killSwitch = true;
+        return nextPlayer;
+      }
+      return -1;
+    }
+    return nextPlayer;
+  }
+
+  /* This function handles the preflop round.
+   * We iterate over the players untill getNextPlayerInSequence determines that
+   * we can stop. For each player we get all valid actions from a helper
+   * function in the form of LegalMoves.
+   * We then offer and execute the action.
+   */
+
+  // Note: We seem to stop at player = 0 while condition =  1;
+  void handlePreFlop() {
+    aBetHasBeenPlaced = true;
+
+    letPlayerstakeAction();
+    return;
+  }
+
+  void handleFlop() {
+    aBetHasBeenPlaced = false;
+    dealCommunityCards();
+    letPlayerstakeAction();
+    return;
+  }
+  void handleTurn() {
+    aBetHasBeenPlaced = false;
+    dealCommunityCards();
+    letPlayerstakeAction();
+    return;
+  }
+
+  void handleRiver() {
+    aBetHasBeenPlaced = false;
+    dealCommunityCards();
+    letPlayerstakeAction();
+    return;
+  }
+
+  void handleShowDown() {
+    calculateBesthand();
+    return;
+  }
+
+  /* Returns what the player can play, what is valid, as a mask with the
+   * amount range of every valid action.
+   */
+  LegalMoves allValidAction(position seat) const {
+    return legalMovesOf(seats.betOf(seat), seats.chipsOf(seat), highestBet,
+                        raiseAmount, settings.minBet, aBetHasBeenPlaced);
+  }
+
+  void logActions(position seat, Action action) {
+    if constexpr (consoleOutput) {
+      const std::string &playerName = players[seat]->getName();
+      switch (action.action) {
+      case actions::fold:
+        std::cout << "[" << playerName << "] folds.\n" << std::endl;
+        break;
+      case actions::check:
+        std::cout << "[" << playerName << "] checks.\n" << std::endl;
+        break;
+      case actions::call:
+        std::cout << "[" << playerName << "] calls with " << action.bet
+                  << " chips.\n"
+                  << std::endl;
+        break;
+      case actions::raise:
+        std::cout << "[" << playerName << "] raises by " << action.bet
+                  << " chips.\n"
+                  << std::endl;
+        break;
+      case actions::allIn:
+        std::cout << "[" << playerName << "] goes all-in with " << action.bet
+                  << " chips.\n"
+                  << std::endl;
+        break;
+      case actions::bet:
+        std::cout << "[" << playerName << "] places a bet of " << action.bet
+                  << " chips.\n"
+                  << std::endl;
+        break;
+      default:
+        std::cout << "[" << playerName << "] performs an unknown action."
+                  << std::endl;
+        break;
+      }
+    }
+    if (history) {
+      history->append({historyHand,
+                       static_cast<std::uint32_t>(players[seat]->getId()),
+                       static_cast<std::uint8_t>(seat),
+                       static_cast<std::uint8_t>(gameState),
+                       static_cast<std::uint8_t>(action.action), action.bet,
+                       static_cast<std::uint32_t>(action.roundCounter)});
+    }
+  }
+
+  /* The players folded property is set to true.
+   * The effects of this will be executed in other functions while the game is
+   * running.
+   */
+  void fold(position seat, Action folded) {
+    seats.fold(seat);
+
+    // If the player folding is currently designated as LeftOfDealer,
+    // update LeftOfDealer to the next active, non-folded player
+    // and grant a free pass so that the new LeftOfDealer can act.
+    if (seat == leftPlayerToDealer) {
+      // getNextActiveAfter already skips folded and inactive players.
+      position newLeft = getNextActiveAfter(gamePositions.dealerPosition);
+      leftPlayerToDealer = (newLeft != -1 ? newLeft : leftPlayerToDealer);
+      freePassForLeftOfDealer = true;
+    }
+
+    logActions(seat, folded);
+    return;
+  }
+
+  /* The player checks. We assume that the player can validly check, to ensure
+   * this, this must be checked in different parts of game.
+   */
+  void check(position seat, Action checked) {
+    logActions(seat, checked);
+    return;
+  }
+
+  /* The player matches his bet with the current highest bet.
+   * We assume here that the player has enough to call. This is left to other
+   * function that check this.
+   */
+  void call(position seat, Action called) {
+    pot += seats.call(seat, called.bet);
+
+    logActions(seat, called);
+    return;
+  }
+
+  /* The player bets a amount which is greater than the current highest bet.
+   * We assume that this player can actually raise, we leave this to other
+   * functions.
+   */
+  void raise(position seat, Action raised) {
+    pot += seats.raise(seat, raised.bet);
+
+    highestBet = raised.bet;
+
+    currentPlays.ActionTaker = seat;
+
+    logActions(seat, raised);
+    return;
+  }
+
+  /* All remaining chips go to the pot
+   */
+  void allIn(position seat, Action allIn) {
+    seats.bet(seat, allIn.bet);
+
+    pot += allIn.bet;
+
+    if (seats.betOf(seat) > highestBet) {
+      highestBet = seats.betOf(seat);
+      currentPlays.ActionTaker = seat;
+    }
+    logActions(seat, allIn);
+    return;
+  }
+
+  /* This player bets x.
+   * We leave it to other functions to ensure that a player can only bet when no
+   * one has placed a bet in that round except the SB and BB. This is most
+   * likely the player after the SB.
+   */
+  void bet(position seat, Action action) {
+    seats.bet(seat, action.bet);
+
+    pot += action.bet;
+    highestBet = std::max(highestBet, seats.betOf(seat));
+    aBetHasBeenPlaced = true;
+    currentPlays.ActionTaker = seat;
+
+    logActions(seat, action);
+  }
+
+  /* Actually calls the action for the player which is validated through the
+   * given input.
+   */
+  void performAction(position seat, Action actionToExecute) {
+    if (listener) {
+      listener(seat, actionToExecute);
+    }
+    switch (actionToExecute.action) {
+    case actions::fold:
+      return perform<actions::fold>(seat, actionToExecute);
+    case actions::check:
+      return perform<actions::check>(seat, actionToExecute);
+    case actions::call:
+      return perform<actions::call>(seat, actionToExecute);
+    case actions::raise:
+      return perform<actions::raise>(seat, actionToExecute);
+    case actions::allIn:
+      return perform<actions::allIn>(seat, actionToExecute);
+    case actions::bet:
+      return perform<actions::bet>(seat, actionToExecute);
+    }
+    throw std::invalid_argument("Unknown action.");
+  }
+
+  /* The handler of act, resolved at compile time so performAction is a jump
+   * table into inlined handlers.
+   */
+  template <actions act> void perform(position seat, const Action &action) {
+    if constexpr (act == actions::fold) {
+      fold(seat, action);
+    } else if constexpr (act == actions::check) {
+      check(seat, action);
+    } else if constexpr (act == actions::call) {
+      call(seat, action);
+    } else if constexpr (act == actions::raise) {
+      raise(seat, action);
+    } else if constexpr (act == actions::allIn) {
+      allIn(seat, action);
+    } else {
+      static_assert(act == actions::bet);
+      bet(seat, action);
+    }
+  }
+
+  static GameState exportGame(const void *game) {
+    return static_cast<const BasicGame *>(game)->exportState();
+  }
+
+  /* offers certain options to the player. The player gives his option as input.
+   * We return this input as a action type.
+   * A seat with a strategy decides on its own, every other seat is asked
+   * through the console, which a headless game doesn't have. A decision
+   * that isn't one of the valid moves checks or folds (fallbackAction).
+   */
+  Action getActionPlayer(position seat) {
+    const LegalMoves validMoves = allValidAction(seat);
+    if (strategies[seat]) {
+      Player &player = *players[seat];
+      seats.store(seat, player);
+      turnInfo info{player,
+                    seat,
+                    validMoves,
+                    communityCards,
+                    pot,
+                    highestBet,
+                    gameState,
+                    currentRound,
+                    gamePositions,
+                    getNotFoldedPlayers(),
+                    seats.size(),
+                    this,
+                    &exportGame};
+      Action action;
+      if constexpr (seatStrategies) {
+        action = strategies[seat](info);
+      } else {
+        action = strategies[seat]->decide(info);
+      }
+      // A strategy can't play what the rules don't allow, whatever it says.
+      if (!allowsAction(validMoves, action)) {
+        logWarn("Seat {} chose the illegal action {} with bet {}, it checks "
+                "or folds instead",
+                seat, static_cast<int>(action.action), action.bet);
+        return fallbackAction(validMoves, currentRound);
+      }
+      return action;
+    }
+    if constexpr (consoleOutput) {
+      return promptAction(validMoves, currentRound, std::cin, std::cout);
+    } else {
+      throw std::logic_error("A headless game needs a strategy for every "
+                             "seat.");
+    }
+  }
+
+  /* Gets, validates and performs action
+   * Possible input player?
+   * Calls getNextPlayerInSequence()
+   * Calculate all valid actions for player.
+   * Offer these options
+   * Gets the action from getActionPlayer().
+   * performs these actions.
+   * Maybe return a pointer to the winner?
+   *
+   */
+  void letPlayerstakeAction() {
+    currentRound++;
+
+    firstIterationOfRound = true;
+    logDebug("Starting letPlayerstakeAction, currentRound: {}, "
+             "LastTurnPlayer: {}, ActionTaker: {}, state: {}",
+             currentRound, currentPlays.LastTurnPlayer,
+             currentPlays.ActionTaker, gameStateName(gameState));
+
+    finishBettingRound();
+  }
+
+  // Lets players act until getNextPlayerInSequence ends the betting round.
+  void finishBettingRound() {
+    position seat;
+    while (((seat = getNextPlayerInSequence()) != -1) and
+           getNotFoldedPlayers() > 1) {
+      takeTurn(seat);
+    }
+    logDebug("Exiting letPlayerstakeAction loop.");
+  }
+
+  void takeTurn(position seat) {
+    currentPlays.LastTurnPlayer = seat;
+
+    logDebug("Next player in sequence is seat {} ({})", seat,
+             players[seat]->getName());
+    if constexpr (consoleOutput) {
+      // Show full table and current player's info:
+      showTurnInfo(seat);
+    }
+    toAct = seat;
+    Action action = getActionPlayer(seat);
+    logDebug("Seat {} chose action {} with bet {}", seat,
+             static_cast<int>(action.action), action.bet);
+
+    performAction(seat, action);
+    toAct = -1;
+    if (firstIterationOfRound) {
+      firstIterationOfRound = false;
+    }
+
+    logDebug("Updated pot: {}, highestBet: {}", pot, highestBet);
+  }
+
+  /* Will walk through all gameStates and update these states.Folded
+   * The stop condition can be:
+   *  either we reached the end of showDown and we calculate a winner
+   *    * Everyone except one person folded.
+   *
+   * Calls getNextPlayerInSequence()
+   * Calculate all valid actions for player.
+   * Offer these options
+   * Gets the action from getActionPlayer().
+   * performs these actions.
+   */
+  void subRoundHandler() {
+    while (getNotFoldedPlayers() > 1) {
+      if constexpr (consoleOutput) {
+        std::cout << "\n\n Not-Folded-Players: " << getNotFoldedPlayers()
+                  << std::endl;
+      }
+      switch (gameState) {
+      case gameStates::preFlop:
+        handleState<gameStates::preFlop>();
+        break;
+      case gameStates::flop:
+        handleState<gameStates::flop>();
+        break;
+      case gameStates::turn:
+        handleState<gameStates::turn>();
+        break;
+      case gameStates::river:
+        handleState<gameStates::river>();
+        break;
+      case gameStates::showDown:
+        handleState<gameStates::showDown>();
+        break;
+      }
+      if (!nextStreet()) {
+        break;
+      }
+    }
+  }
+
+  /* Ends the betting round of gameState, false when that was the showdown.
+   */
+  bool nextStreet() {
+    currentPlays.LastTurnPlayer = gamePositions.dealerPosition;
+    currentPlays.ActionTaker = -1;
+    resetBets();
+
+    if constexpr (consoleOutput) {
+      std::cout << "Printing gamestate here.!!!!" << std::endl;
+      printGameState(gameState);
+    }
+    if (gameState == gameStates::showDown) {
+      return false;
+    }
+    gameState = static_cast<gameStates>(static_cast<int>(gameState) + 1);
+    return true;
+  }
+
+  // The handler of state, resolved at compile time like perform.
+  template <gameStates state> void handleState() {
+    if constexpr (state == gameStates::preFlop) {
+      handlePreFlop();
+    } else if constexpr (state == gameStates::flop) {
+      handleFlop();
+    } else if constexpr (state == gameStates::turn) {
+      handleTurn();
+    } else if constexpr (state == gameStates::river) {
+      handleRiver();
+    } else {
+      static_assert(state == gameStates::showDown);
+      handleShowDown();
+    }
+  }
+
+  /* Calls the players method resetHand to give a clean sheet for the next
+   * round.
+   */
+  void resetHand() {
+    for (auto &player : players) {
+      player->resetCards();
+    }
+    seats.resetHand();
+    // Nothing may point into the arena once it is released.
+    decltype(communityCards)(arena.resource()).swap(communityCards);
+    arena.release();
+    return;
+  }
+
+  /* Every betting round starts without bets, what was bet before is already
+   * in the pot.
+   */
+  void resetBets() {
+    seats.resetBets();
+    highestBet = 0;
+  }
+
+  /* Deals 2 cards to every player who is active in this round
+   */
+  void dealHoleCards() {
+    for (int i = 0; i < AMOUNT_OF_CARDS; i++) {
+      for (position seat = 0; seat < seats.size(); seat++) {
+        if (seats.isActive(seat)) {
+          Card toBeDealt = deck.dealCard(rng);
+          players[seat]->receiveCards(toBeDealt);
+        }
+      }
+    }
+    return;
+  }
+
+  /* Depending on the game state, adds cards to communityCards.
+   */
+  void dealCommunityCards() {
+    int cardsTobeDealt = 1;
+    if (gameState == gameStates::flop) {
+      cardsTobeDealt = 3;
+    } else if (gameState == gameStates::preFlop) {
+      cardsTobeDealt = 0;
+    }
+
+    deck.burnCard(rng);
+    for (int i = 0; i < cardsTobeDealt; i++) {
+      Card communityCard = deck.dealCard(rng);
+      communityCards.push_back(communityCard);
+    }
+    return;
+  }
+
+  /* Does the basic one time operations needed in a round.
+   * Make the Blinds pay.
+   * Deal hole cards to players in the game.
+   */
+  void standardStartRoundOperations() {
+    const position smallBlind = gamePositions.posSB;
+    const position bigBlind = gamePositions.posBB;
+
+    if (seats.chipsOf(smallBlind) <
+        static_cast<money>(0.5 * settings.minBet)) {
+      Action allInAction = {actions::allIn, seats.chipsOf(smallBlind), 0};
+      allIn(smallBlind, allInAction);
+    } else {
+      Action betAction = {actions::bet,
+                          static_cast<money>(settings.minBet * 0.5), 0};
+      bet(smallBlind, betAction);
+    }
+    if (seats.chipsOf(bigBlind) < settings.minBet) {
+      Action allInAction = {actions::allIn, seats.chipsOf(bigBlind), 0};
+      allIn(bigBlind, allInAction);
+    } else {
+      Action betAction = {actions::bet, settings.minBet, 0};
+      highestBet = settings.minBet;
+      bet(bigBlind, betAction);
+    }
+
+    dealHoleCards();
+
+    return;
+  }
+
+  /* Calculates the hand of every player still in the hand, payOut uses
+   * them to decide who wins which pot.
+   * Does this with the evaluator of the module bestHand.cppm
+   */
+  void calculateBesthand() {
+    const CardSet board(communityCards);
+    position winner = -1;
+    for (seatMask inHand = seats.inHandSeats(); inHand != 0;
+         inHand &= inHand - 1) {
+      position seat = std::countr_zero(inHand);
+      handValues[seat] = evaluateHand(CardSet(players[seat]->getHand()) | board);
+      if (winner == -1 or handValues[seat] > handValues[winner]) {
+        winner = seat;
+      }
+    }
+    if (winner == -1) {
+      throw std::runtime_error("No active players in the showdown.");
+    }
+    if constexpr (consoleOutput) {
+      std::cout << "The best hand winner is: " << players[winner]->getName()
+                << " with "
+                << categoryToString(categoryOf(handValues[winner])) << "\n";
+    }
+  }
+
+  /* Splits the pot into a main pot and side pots and pays each of them to
+   * the best hand that contributed to it. When everybody else folded the
+   * last player simply gets everything.
+   */
+  void payOut() {
+    if (getNotFoldedPlayers() == 0) {
+      throw std::logic_error("Every player folded.");
+    }
+    sidePots.build(seats);
+    sidePots.settle(seats, handValues, gamePositions.dealerPosition);
+    if constexpr (consoleOutput) {
+      for (int i = 0; i < sidePots.size(); i++) {
+        std::cout << (i == 0 ? "Main pot: " : "Side pot: ")
+                  << sidePots[i].total << " chips\n";
+      }
+    }
+  }
+
+public:
+  whoPlays currentPlays;
+  BasicGame()
+      : pot(0), players(), deck(), highestBet(0),
+        gameState(gameStates::preFlop), settings(), gamePositions(),
+        seed(std::random_device{}()), rng(seed) {}
+
+  /* The seed decides which cards get dealt, two games with the same seed and
+   * the same decisions play out identically.
+   */
+  BasicGame(playersPool &players, gameSettings &settings, const positions &pos,
+            std::uint64_t seed = std::random_device{}())
+      : players(players), settings(settings), gamePositions(pos), pot(0),
+        highestBet(0), deck(),
+        gameState(gameStates::preFlop), seed(seed), rng(seed),
+        currentPlays(gamePositions.posBB + 1, gamePositions.posSB + 1) {}
+
+  /* Lets the strategy decide for the player at seat instead of the console.
+   */
+  void setStrategy(position seat, strategy decide)
+    requires seatStrategies
+  {
+    if (seat < 0 or seat >= MAX_SEATS) {
+      throw std::out_of_range("A table has at most 32 seats.");
+    }
+    strategies[seat] = std::move(decide);
+  }
+
+  /* Lets source decide for the player at seat, source has to outlive the
+   * game. Several seats can share one source.
+   */
+  void setSource(position seat, Source &source)
+    requires(!seatStrategies)
+  {
+    if (seat < 0 or seat >= MAX_SEATS) {
+      throw std::out_of_range("A table has at most 32 seats.");
+    }
+    strategies[seat] = &source;
+  }
+
+  void setActionListener(actionListener onAction) {
+    listener = std::move(onAction);
+  }
+
+  /* Appends every action of the next simulateHand to writer, which has to
+   * outlive the hand. nullptr turns the log off again.
+   */
+  void setHandHistory(HandHistoryWriter *writer) { history = writer; }
+
+  /* Will function as the entre point for a round.
+   * Calls standardStartRoundOperations.
+   * Calls subRoundHandler.
+   * Pays the main pot and side pots to their winners.
+   * Reset function? s.a cards cleaned up, folded status reset.
+   */
+  void simulateHand() {
+    if (history) {
+      historyHand = history->beginHand();
+    }
+    seats.load(players);
+    communityCards.reserve(COMMUNITY_CARDS);
+    standardStartRoundOperations();
+    if constexpr (consoleOutput) {
+      checkHoleCards();
+      std::cout << "Finished checking HoleCards"
+                << "\n";
+    }
+    subRoundHandler();
+    payOut();
+    resetHand();
+    seats.store(players);
+  }
+
+  /* Sets the game up for another hand at the same table, as if it was made
+   * anew with pos and seed. Strategies, listener and hand history stay.
+   * Reusing a game keeps its allocations warm, a hand then runs without
+   * touching the heap.
+   */
+  void newHand(const positions &pos, std::uint64_t handSeed) {
+    pot = 0;
+    deck = Deck();
+    highestBet = 0;
+    gameState = gameStates::preFlop;
+    gamePositions = pos;
+    currentRound = 0;
+    firstIterationOfRound = true;
+    firstTime = true;
+    killSwitch = false;
+    freePassForLeftOfDealer = false;
+    toAct = -1;
+    seed = handSeed;
+    rng = Xoshiro256(handSeed);
+    currentPlays = {gamePositions.posBB + 1, gamePositions.posSB + 1};
+  }
+
+  /* The hand as a GameState, at the decision of the seat a strategy is
+   * asked for, so from within that strategy. Throws std::logic_error
+   * elsewhere and std::invalid_argument for tables of more than STATE_SEATS
+   * seats.
+   */
+  GameState exportState() const {
+    if (toAct < 0) {
+      throw std::logic_error("A game exports its state at a decision only.");
+    }
+    if (seats.size() > STATE_SEATS) {
+      throw std::invalid_argument("A GameState has at most 10 seats.");
+    }
+    GameState state;
+    for (position seat = 0; seat < seats.size(); seat++) {
+      state.chips[seat] = seats.chipsOf(seat);
+      state.bets[seat] = seats.betOf(seat);
+      state.committed[seat] = seats.committedOf(seat);
+      state.folded |= seats.hasFolded(seat) ? seatMask{1} << seat : 0;
+      const std::vector<Card> &hand = players[seat]->getHand();
+      std::copy_n(hand.begin(), std::min<std::size_t>(hand.size(),
+                                                      AMOUNT_OF_CARDS),
+                  state.holeCards[seat].begin());
+    }
+    std::copy(communityCards.begin(), communityCards.end(),
+              state.board.begin());
+    state.deck = deck;
+    state.rng = rng;
+    state.pot = pot;
+    state.highestBet = highestBet;
+    state.raiseAmount = raiseAmount;
+    state.minBet = settings.minBet;
+    state.currentRound = static_cast<std::uint32_t>(currentRound);
+    state.active = seats.activeSeats();
+    state.street = gameState;
+    state.seats = static_cast<std::int8_t>(seats.size());
+    state.boardCards = static_cast<std::int8_t>(communityCards.size());
+    state.dealer = static_cast<std::int8_t>(gamePositions.dealerPosition);
+    state.smallBlind = static_cast<std::int8_t>(gamePositions.posSB);
+    state.bigBlind = static_cast<std::int8_t>(gamePositions.posBB);
+    state.actor = static_cast<std::int8_t>(toAct);
+    state.actionTaker = static_cast<std::int8_t>(currentPlays.ActionTaker);
+    state.lastTurnPlayer =
+        static_cast<std::int8_t>(currentPlays.LastTurnPlayer);
+    state.leftOfDealer = static_cast<std::int8_t>(leftPlayerToDealer);
+    state.aBetHasBeenPlaced = aBetHasBeenPlaced;
+    state.firstIterationOfRound = firstIterationOfRound;
+    state.firstTime = firstTime;
+    state.killSwitch = killSwitch;
+    state.freePassForLeftOfDealer = freePassForLeftOfDealer;
+    return state;
+  }
+
+  /* Puts the game at the decision of state, resumeHand plays on from there.
+   * The players are those of this game, one for every seat of state; their
+   * cards are replaced by the ones of state.
+   */
+  void importState(const GameState &state) {
+    if (state.seats != static_cast<int>(players.size())) {
+      throw std::invalid_argument(
+          "The state is of a table with another amount of seats.");
+    }
+    if (state.isTerminal()) {
+      throw std::invalid_argument("The hand of the state is already over.");
+    }
+    seats.load(players);
+    for (position seat = 0; seat < state.seats; seat++) {
+      const seatMask bit = seatMask{1} << seat;
+      seats.restore(seat, state.chips[seat], state.bets[seat],
+                    state.committed[seat], state.active & bit,
+                    state.folded & bit);
+      players[seat]->resetCards();
+      if (state.active & bit) {
+        for (const Card &card : state.holeCards[seat]) {
+          players[seat]->receiveCards(card);
+        }
+      }
+    }
+    communityCards.assign(state.board.begin(),
+                          state.board.begin() + state.boardCards);
+    deck = state.deck;
+    rng = state.rng;
+    pot = state.pot;
+    highestBet = state.highestBet;
+    raiseAmount = state.raiseAmount;
+    settings.minBet = state.minBet;
+    currentRound = state.currentRound;
+    gameState = state.street;
+    gamePositions = {state.dealer, state.bigBlind, state.smallBlind};
+    toAct = state.actor;
+    currentPlays = {state.actionTaker, state.lastTurnPlayer};
+    leftPlayerToDealer = state.leftOfDealer;
+    aBetHasBeenPlaced = state.aBetHasBeenPlaced;
+    firstIterationOfRound = state.firstIterationOfRound;
+    firstTime = state.firstTime;
+    killSwitch = state.killSwitch;
+    freePassForLeftOfDealer = state.freePassForLeftOfDealer;
+  }
+
+  /* Plays the hand importState left the game in to its end, from the
+   * decision of the state on. Pays out and writes the players back like
+   * simulateHand.
+   */
+  void resumeHand() {
+    if (toAct < 0) {
+      throw std::logic_error("Import a state before resuming a hand.");
+    }
+    if (history) {
+      historyHand = history->beginHand();
+    }
+    takeTurn(toAct);
+    finishBettingRound();
+    if (nextStreet()) {
+      subRoundHandler();
+    }
+    payOut();
+    resetHand();
+    seats.store(players);
+  }
+
+  money getPot() const { return pot; }
+  std::uint64_t getSeed() const { return seed; }
+  const HandArena &getArena() const { return arena; }
+  const playersPool &getPlayers() const { return players; }
+  const positions &getPositions() const { return gamePositions; }
+  const gameSettings &getSettings() const { return settings; }
+};
+
+export using Game = BasicGame<consoleIO>;
+export using HeadlessGame = BasicGame<silentIO>;
+
+/* Gives benchmarks and tests access to single steps of a hand, like
+ * ManagerTest does for Manager.
+ */
+export struct GameInternals {
+  /* Loads the players and posts the blinds, the game is then where the first
+   * preflop decision is asked for.
+   */
+  template <typename IO, typename Source>
+  static void startHand(BasicGame<IO, Source> &game) {
+    game.seats.load(game.players);
+    game.standardStartRoundOperations();
+    game.aBetHasBeenPlaced = true;
+  }
+
+  template <typename IO, typename Source>
+  static LegalMoves allValidAction(BasicGame<IO, Source> &game,
+                                   position seat) {
+    return game.allValidAction(seat);
+  }
+
+  template <typename IO, typename Source>
+  static position getNextPlayerInSequence(BasicGame<IO, Source> &game) {
+    return game.getNextPlayerInSequence();
+  }
+
+  template <typename IO, typename Source>
+  static void performAction(BasicGame<IO, Source> &game, position seat,
+                            Action action) {
+    game.performAction(seat, action);
+  }
+
+  // One action handler without the dispatch of performAction.
+  template <actions act, typename IO, typename Source>
+  static void perform(BasicGame<IO, Source> &game, position seat,
+                      const Action &action) {
+    game.template perform<act>(seat, action);
+  }
+};
+
+export class ManagerTest;
+
+/* Output policy IO works like the one of BasicGame, every hand is played in a
+ * BasicGame<IO>.
+ */
+export template <typename IO> class BasicManager {
+private:
+  static constexpr bool consoleOutput = IO::enabled;
+
+  gameSettings settings;            // a struct containing all default settings
+  std::vector<std::string> names;   // Default names for six players.
+  notActivePlayers inActivePlayers; // All players who have 0 chips and cannot
+                                    // play anymore
+  playersHistory History;           // The history of each player.
+  std::unique_ptr<HandHistoryWriter> historyWriter; // Log of every action.
+  size_t currentRound;
+  positions specialPositions; // struct containing position of BB SB and Dealer.
+  bool gameActive;
+  std::uint64_t seed;
+  SplitMix64 handSeeds; // The seed of every hand is drawn from this.
+  std::vector<strategy> strategies;
+
+  friend class ManagerTest;
+
+  int activePlayers() {
+    int activeCount = 0;
+    for (auto &player : players) {
+      if (player->getIsActive()) {
+        activeCount++;
+      }
+    }
+    return activeCount;
+  }
+
+public:
+  playersPool players; // a deque with shared pointers to each player.
+  BasicManager() : BasicManager(gameSettings(), std::random_device{}()) {}
+
+  /* All hands of a manager with the same seed, settings and strategies play
+   * out identically.
+   */
+  BasicManager(const gameSettings &settings, std::uint64_t seed)
+      : settings(settings),
+        names({"Phill", "Doyle", "Daniel", "Chris", "Johnny", "You"}),
+        currentRound(0), seed(seed), handSeeds(seed) {
+    initalizePLayers();
+  }
+
+  /* Every hand asks strategy for the decisions of the player at seat instead
+   * of the console.
+   */
+  void setStrategy(position seat, strategy decide) {
+    if (seat >= static_cast<position>(strategies.size())) {
+      strategies.resize(seat + 1);
+    }
+    strategies[seat] = std::move(decide);
+  }
+
+  std::uint64_t getSeed() const { return seed; }
+
+  /* Appends every action of the following hands to the binary log at path.
+   */
+  void enableHandHistory(const std::string &path) {
+    historyWriter = std::make_unique<HandHistoryWriter>(path);
+  }
+
+  /* Console managers show message to the players on std::cout, in order
+   * with the rest of the table. Headless ones only log it at debug.
+   */
+  void log(const std::string &message) const {
+    if constexpr (consoleOutput) {
+      std::cout << message << std::endl;
+    } else {
+      logDebug("{}", message);
+    }
+  }
+
+  /* Error catching function. (Later. For now names is a static defined
+   * array.) When too few names provided, ask input to fill in missingAmount
+   * of names.
+   */
+  void handleTooFewNamesProvided(int missingAmount) {}
+
+  /* Initalizes the SB BB and D positions. This can't be reduced to a default
+   * value init as in the begin of the game we might already have inactive
+   * players.
+   */
+  void initalizeSpecialPositions() {
+    position newDealerIndex = findNextValidPos(0);
+    if (newDealerIndex == INVALID_POS) {
+      handleTooFewPlayers();
+      return;
+    }
+
+    players[newDealerIndex]->setBlind(Blind::dealer);
+    specialPositions.dealerPosition = newDealerIndex;
+
+    position initialSBIndex = findNextValidPos(newDealerIndex + 1);
+    if (initialSBIndex == INVALID_POS) {
+      handleTooFewPlayers();
+      return;
+    }
+
+    players[initialSBIndex]->setBlind(Blind::smallBlind);
+    specialPositions.posSB = initialSBIndex;
+
+    position initialBBIndex = findNextValidPos(initialSBIndex + 1);
+    if (initialBBIndex == INVALID_POS) {
+      handleTooFewPlayers();
+      return;
+    }
+
+    players[initialBBIndex]->setBlind(Blind::bigBlind);
+    specialPositions.posBB = initialBBIndex;
+  }
+
+  /* Initalizes all players with their names and starting chips.
+   * These players get allocated on the heap with shared pointers and pushed
+   * onto the playersPool
+   */
+  void initalizePLayers() {
+
+    if (names.size() < settings.minAmountPlayers) {
+      handleTooFewNamesProvided(names.size() - settings.minAmountPlayers);
+    }
+
+    for (int i = 0; i < names.size() and i < settings.maxAmountPlayers; i++) {
+      std::shared_ptr<Player> p =
+          make_shared<Player>(names[i], settings.startingChips);
+      players.emplace_back(p);
+    }
+    initalizeSpecialPositions();
+  }
+
+  /* Return the special position by pointer.
+   */
+  std::shared_ptr<const positions> getSpecialPositions() {
+    return std::make_shared<positions>(specialPositions);
+  }
+
+  size_t getCurrentRound() { return currentRound; }
+
+  /* Will print out the current round, name, chips, and activity status in a
+   * nice format.
+   */
+  void gameStatistics() {
+    std::cout << "==========================================" << std::endl;
+    std::cout << "           Poker Game Statistics          " << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << "Current Round: " << currentRound << std::endl << std::endl;
+
+    // Print the header with fixed column widths
+    std::cout << std::left << std::setw(4) << "#" << std::setw(12) << "Name"
+              << std::setw(10) << "Chips" << std::setw(12) << "Blind"
+              << std::setw(10) << "Status" << std::endl;
+    std::cout << "------------------------------------------" << std::endl;
+
+    int playerNumber = 1;
+    for (const auto &player : players) {
+      std::string blindStatus = "None";
+      switch (player->getBlind()) {
+      case Blind::dealer:
+        blindStatus = "Dealer";
+        break;
+      case Blind::smallBlind:
+        blindStatus = "SmallBlind";
+        break;
+      case Blind::bigBlind:
+        blindStatus = "BigBlind";
+        break;
+      default:
+        break;
+      }
+
+      std::string status =
+          player->getIsActive()
+              ? "Active"
+              : (player->getChips() == 0 ? "Out of Chips" : "Inactive");
+
+      // Print player information with proper alignment
+      std::cout << std::left << std::setw(4) << playerNumber << std::setw(12)
+                << player->getName() << std::setw(10) << player->getChips()
+                << std::setw(12) << blindStatus << std::setw(10) << status
+                << std::endl;
+      playerNumber++;
+    }
+
+    std::cout << "------------------------------------------" << std::endl;
+  }
+
+  /* Plays hands until settings.maximumRounds hands are played or fewer than
+   * 3 players have chips left, the blinds need 3 different players.
+   */
+  void startGame() {
+    // One game plays every hand, so its allocations stay warm.
+    BasicGame<IO> game(players, settings, specialPositions, 0);
+    for (position seat = 0; seat < static_cast<position>(strategies.size());
+         seat++) {
+      if (strategies[seat]) {
+        game.setStrategy(seat, strategies[seat]);
+      }
+    }
+    game.setHandHistory(historyWriter.get());
+    while (currentRound < settings.maximumRounds and activePlayers() >= 3) {
+      game.newHand(specialPositions, handSeeds());
+      game.simulateHand();
+      currentRound++;
+      decidePlayersLifeCycle();
+      if (activePlayers() < 3) {
+        break;
+      }
+      arrangePlayersPosition();
+      if constexpr (consoleOutput) {
+        gameStatistics();
+      }
+    }
+
+    endGame();
+  }
+
+  /* Flushes the hand history and, with console output, prints the final
+   * standings.
+   */
+  void endGame() {
+    if (historyWriter) {
+      historyWriter->flush();
+    }
+    if constexpr (consoleOutput) {
+      printFinalStandings();
+    }
+  }
+
+  /* Will print out all players with their chips etc.
+   * Indicates the end of the program.
+   */
+  void printFinalStandings() const {
+    std::cout << "==========================================" << std::endl;
+    std::cout << "                Game Over                  " << std::endl;
+    std::cout << "==========================================" << std::endl;
+    std::cout << "Final Standings:" << std::endl;
+
+    std::cout << std::left << std::setw(4) << "#" << std::setw(15) << "Name"
+              << std::setw(10) << "Chips" << std::endl;
+    std::cout << "------------------------------------------" << std::endl;
+
+    // Convert deque to vector using vector's range constructor
+    std::vector<std::shared_ptr<Player>> sortedPlayers(players.begin(),
+                                                       players.end());
+
+    std::sort(sortedPlayers.begin(), sortedPlayers.end(),
+              [](const std::shared_ptr<Player> &a,
+                 const std::shared_ptr<Player> &b) -> bool {
+                return a->getChips() > b->getChips();
+              });
+
+    // Display each player's final chips
+    int rank = 1;
+    for (const auto &player : sortedPlayers) {
+      std::cout << std::left << std::setw(4) << rank << std::setw(15)
+                << player->getName() << std::setw(10) << player->getChips()
+                << std::endl;
+      rank++;
+    }
+
+    std::cout << "------------------------------------------" << std::endl;
+
+    // Identify the winner(s)
+    if (!sortedPlayers.empty()) {
+      money topChips = sortedPlayers.front()->getChips();
+      std::vector<std::string> winners;
+
+      for (const auto &player : sortedPlayers) {
+        if (player->getChips() == topChips and topChips > 0) {
+          winners.push_back(player->getName());
+        } else {
+          break;
+        }
+      }
+
+      // Announce the winner(s)
+      if (winners.size() == 1) {
+        std::cout << "Winner: " << winners.front() << " with " << topChips
+                  << " chips!" << std::endl;
+      } else if (winners.size() > 1) {
+        std::cout << "Winners: ";
+        for (size_t i = 0; i < winners.size(); ++i) {
+          std::cout << winners[i];
+          if (i < winners.size() - 1) {
+            std::cout << ", ";
+          }
+        }
+        std::cout << " each with " << topChips << " chips!" << std::endl;
+      } else {
+        std::cout << "No winners. All players are out of chips." << std::endl;
+      }
+    } else {
+      std::cout << "No players participated in the game." << std::endl;
+    }
+
+    std::cout << "==========================================" << std::endl;
+  }
+
+  /* Error catching function. We can't assign the same player to be a SB and a
+   * BB. The game has to terminate as something clearly went wrong.
+   */
+  void handleTooFewPlayers() {
+    throw std::runtime_error("Too few players to continue the game.");
+  }
+
+  position findNextValidPos(position start) {
+    // Count active players
+    if (activePlayers() < 3) {
+      return INVALID_POS;
+    }
+
+    start = start % players.size();
+    position initial = start;
+
+    do {
+      if (players[start] and players[start]->getIsActive()) {
+        return start;
+      }
+      start = (start + 1) % players.size();
+    } while (start != initial);
+
+    return INVALID_POS;
+  }
+
+  /* For a betRound, move the dealer button. This will indirectly move the SB
+   * and BB
+   */
+  void arrangePlayersPosition() {
+    if (activePlayers() < 3) {
+      return handleTooFewPlayers();
+    }
+
+    // Clear all blinds first
+    for (auto &player : players) {
+      player->setBlind(Blind::notBlind);
+    }
+
+    // Set new positions with validation
+    position newDealerIndex = findNextValidPos(
+        (specialPositions.dealerPosition + 1) % players.size());
+    if (newDealerIndex == INVALID_POS) {
+      handleTooFewPlayers();
+      return;
+    }
+
+    position newSBIndex =
+        findNextValidPos((newDealerIndex + 1) % players.size());
+    if (newSBIndex == INVALID_POS or newSBIndex == newDealerIndex) {
+      handleTooFewPlayers();
+      return;
+    }
+
+    position newBBIndex = findNextValidPos((newSBIndex + 1) % players.size());
+    if (newBBIndex == INVALID_POS or newBBIndex == newDealerIndex or
+        newBBIndex == newSBIndex) {
+      handleTooFewPlayers();
+      return;
+    }
+
+    // Set new positions and blinds
+    specialPositions.dealerPosition = newDealerIndex;
+    specialPositions.posSB = newSBIndex;
+    specialPositions.posBB = newBBIndex;
+
+    players[newDealerIndex]->setBlind(Blind::dealer);
+    players[newSBIndex]->setBlind(Blind::smallBlind);
+    players[newBBIndex]->setBlind(Blind::bigBlind);
+  }
+
+  /* If a player has no chips more, remove them from the game as they can't do
+   * anyhting. This will ensure that no funny things happen when moving around
+   * the dealersButton.
+   * We set the player to inActive.
+   */
+  void decidePlayersLifeCycle() {
+    for (auto &player : players) {
+      if (player->getChips() == 0) {
+        player->setIsActive(false);
+        log(player->getName() + "is out of chips and inactive. ");
+      }
+    }
+  }
+};
+
+export using Manager = BasicManager<consoleIO>;
+export using HeadlessManager = BasicManager<silentIO>;
+
+export struct ManagerTest {
+  static void printBlindValues(const Manager &manager) {
+    std::cout << "Current blind values:\n";
+    for (size_t i = 0; i < manager.players.size(); i++) {
+      std::cout << "Player " << i << " (" << manager.names[i] << ") blind: "
+                << static_cast<int>(manager.players[i]->getBlind())
+                << " Active status " << manager.players[i]->getIsActive()
+                << "\n";
+    }
+    std::cout << std::endl;
+  }
+
+  /* Helper function to set player activity */
+  static void setPlayerActive(Manager &manager, size_t playerIndex,
+                              bool isActive) {
+    if (playerIndex < manager.players.size()) {
+      manager.players[playerIndex]->setIsActive(isActive);
+    }
+  }
+
+  /* Test Case 1: All Players Active */
+  static void testAllPlayersActive() {
+    std::cout << "Test Case 1: All Players Active\n";
+    Manager manager;
+
+    // Ensure all players are active
+    for (size_t i = 0; i < manager.players.size(); i++) {
+      manager.players[i]->setIsActive(true);
+    }
+
+    // Print blind values
+    std::cout << "After initialization:\n";
+    printBlindValues(manager);
+
+    // Verify initial positions
+    auto initialPos = manager.getSpecialPositions();
+    assert(manager.players[initialPos->dealerPosition]->getBlind() ==
+           Blind::dealer);
+    assert(manager.players[initialPos->posSB]->getBlind() == Blind::smallBlind);
+    assert(manager.players[initialPos->posBB]->getBlind() == Blind::bigBlind);
+
+    // Test rotation
+    manager.arrangePlayersPosition();
+
+    // Print blind values after rotation
+    std::cout << "After rotation:\n";
+    printBlindValues(manager);
+
+    // Verify rotated positions
+    auto newPos = manager.getSpecialPositions();
+    assert(newPos->dealerPosition == 1); // Should move to position 1
+    assert(newPos->posSB == 2);          // Should move to position 2
+    assert(newPos->posBB == 3);          // Should move to position 3
+
+    std::cout << "Test Case 1 Passed!\n\n";
+  }
+
+  /* Test Case 2: Some Players Inactive */
+  static void testSomePlayersInactive() {
+    std::cout << "Test Case 2: Some Players Inactive\n";
+    Manager manager;
+
+    // Initial blind assignment is already done in the Manager constructor via
+    // initalizeSpecialPositions()
+
+    // Print initial blind values
+    std::cout << "Initial blind assignment:\n";
+    printBlindValues(manager);
+
+    // 1. First Rotation: Rotate blinds once
+    manager.arrangePlayersPosition();
+    std::cout << "After first rotation:\n";
+    printBlindValues(manager);
+
+    // 2. Set players 1 and 3 as inactive
+    setPlayerActive(manager, 1, false); // Assuming player index 1 is "Doyle"
+    setPlayerActive(manager, 3, false); // Assuming player index 3 is "Chris"
+    std::cout << "After setting players 1 and 3 as inactive:\n";
+    printBlindValues(manager);
+
+    // 3. Second Rotation: Rotate blinds again
+    manager.arrangePlayersPosition();
+    std::cout << "After second rotation with some players inactive:\n";
+    printBlindValues(manager);
+
+    // 4. Verify rotated positions
+    auto newPos = manager.getSpecialPositions();
+    assert(newPos->dealerPosition == 2); // Should move to position 2 ("Daniel")
+    assert(newPos->posSB == 4);          // Should move to position 4 ("Johnny")
+    assert(newPos->posBB == 5);          // Should move to position 5 ("You")
+
+    std::cout << "Test Case 2 Passed!\n\n";
+  }
+
+  /* Test Case 3: Minimum Active Players (3 Players) */
+  static void testMinimumActivePlayers() {
+    std::cout << "Test Case 3: Minimum Active Players (2 Players)\n";
+    Manager manager;
+
+    // Set players 3, 4, 5 as inactive
+    for (size_t i = 3; i < manager.players.size(); i++) {
+      setPlayerActive(manager, i, false);
+    }
+
+    // Assign blinds based on current active players
+    manager.arrangePlayersPosition();
+
+    // Print blind values after blind assignment
+    std::cout << "After assigning blinds with minimum active players:\n";
+    printBlindValues(manager);
+
+    // Verify rotated positions
+    auto newPos = manager.getSpecialPositions();
+    assert(newPos->dealerPosition == 1); // Should move to position 1
+    assert(newPos->posSB == 2);          // Should move to position 0
+    assert(newPos->posBB == 0); // Should move to position 1 (Dealer also as BB)
+
+    std::cout << "Test Case 3 Passed!\n\n";
+  }
+
+  /* Test Case 4: Multiple Rotations */
+  static void testMultipleRotations() {
+    std::cout << "Test Case 4: Multiple Rotations\n";
+    Manager manager;
+
+    // Ensure all players are active initially
+    for (size_t i = 0; i < manager.players.size(); i++) {
+      manager.players[i]->setIsActive(true);
+    }
+
+    std::cout << "Initial setup:\n";
+    printBlindValues(manager);
+
+    // Perform multiple rotations and verify positions
+    for (int rotation = 1; rotation <= 3; rotation++) {
+      std::cout << "\nRotation " << rotation << ":\n";
+
+      manager.arrangePlayersPosition();
+      auto pos = manager.getSpecialPositions();
+
+      printBlindValues(manager);
+
+      // Verify blinds are assigned correctly
+      assert(manager.players[pos->dealerPosition]->getBlind() == Blind::dealer);
+      assert(manager.players[pos->posSB]->getBlind() == Blind::smallBlind);
+      assert(manager.players[pos->posBB]->getBlind() == Blind::bigBlind);
+
+      // Verify positions are different
+      assert(pos->dealerPosition != pos->posSB);
+      assert(pos->dealerPosition != pos->posBB);
+      assert(pos->posSB != pos->posBB);
+
+      // After second rotation, deactivate some players
+      if (rotation == 2) {
+        setPlayerActive(manager, 1, false);
+        setPlayerActive(manager, 3, false);
+        std::cout << "Deactivated players 1 and 3\n";
+      }
+    }
+
+    std::cout << "Test Case 4 Passed!\n\n";
+  }
+
+  // Update runAllTests
+  static void runAllTests() {
+    testAllPlayersActive();
+    testSomePlayersInactive();
+    testMinimumActivePlayers();
+    testMultipleRotations();
+    std::cout << "All ManagerTest cases passed successfully!\n";
+  }
+};
@@ -0,0 +1,70 @@
+/* This file implements the memory a hand allocates from.
+ * HandArena: A std::pmr::monotonic_buffer_resource over a buffer inside the
+ * arena itself. Allocations only bump a pointer, deallocations do nothing
+ * and release hands the whole buffer back at the end of a hand.
+ *    -When a hand needs more than the buffer, the arena takes blocks from the
+ * heap. Those are counted, heapAllocations and lastHandHeapAllocations show
+ * whether a hand stayed off the heap (the goal once the game is warmed up).
+ *    -An arena can't be copied or moved, everything allocated from it points
+ * into its buffer.
+ */
+module;
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+export module handArena;
+
+export constexpr std::size_t HAND_ARENA_BYTES = 4096;
+
+export class HandArena {
+private:
+  // Forwards to the heap and counts the blocks the arena takes from it.
+  class CountingResource : public std::pmr::memory_resource {
+  public:
+    std::uint64_t allocations = 0;
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+      allocations++;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *pointer, std::size_t bytes,
+                       std::size_t alignment) override {
+      std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+    bool do_is_equal(
+        const std::pmr::memory_resource &other) const noexcept override {
+      return this == &other;
+    }
+  };
+
+  alignas(std::max_align_t) std::array<std::byte, HAND_ARENA_BYTES> buffer;
+  CountingResource heap;
+  std::pmr::monotonic_buffer_resource arena{buffer.data(), buffer.size(),
+                                            &heap};
+  std::uint64_t handStart = 0; // heap.allocations when the hand began.
+  std::uint64_t lastHand = 0;
+
+public:
+  HandArena() = default;
+  HandArena(const HandArena &) = delete;
+  HandArena &operator=(const HandArena &) = delete;
+
+  std::pmr::memory_resource *resource() { return &arena; }
+
+  /* Frees everything of the hand at once. Nothing allocated from the arena
+   * may be used afterwards.
+   */
+  void release() {
+    arena.release();
+    lastHand = heap.allocations - handStart;
+    handStart = heap.allocations;
+  }
+
+  // Blocks taken from the heap since the arena was made.
+  std::uint64_t heapAllocations() const { return heap.allocations; }
+  // Blocks taken from the heap by the hand released last.
+  std::uint64_t lastHandHeapAllocations() const { return lastHand; }
+};
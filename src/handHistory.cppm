@@ -0,0 +1,399 @@
+/* This file implements a binary log of every action taken at the table.
+ * HistoryRecord: One action, every field has a fixed width.
+ * HandHistoryWriter: Appends records to a file. Records are buffered column
+ * by column and written a block at a time, so append itself is a few stores.
+ * HandHistoryReader: Memory maps a log and decodes it block by block, a
+ * single column can be decoded without touching the others.
+ *
+ * File layout (little endian):
+ *    -Header, 16 bytes: magic "PKHH", uint16 version, uint16 column count,
+ * uint32 block capacity, uint32 reserved.
+ *    -Blocks, each: uint32 record count, uint32 payload words, a 16 byte
+ * descriptor per column (uint64 base, uint8 bit width, 7 bytes padding) and
+ * the payload.
+ *    -Every column of a block is compressed with frame of reference bit
+ * packing: the block stores the smallest value as base and every record as
+ * its difference to base in `bit width` bits. Hand numbers, seats, streets
+ * and actions take a few bits per record this way.
+ *    -Every block and every column payload is a whole number of 64-bit
+ * words, so all words in the mapped file are aligned.
+ */
+module;
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+export module handHistory;
+
+export constexpr std::uint16_t HISTORY_LOG_VERSION = 1;
+export constexpr std::uint32_t DEFAULT_HISTORY_BLOCK = 4096;
+
+export struct HistoryRecord {
+  std::uint64_t hand;   // Number of the hand, handed out by the writer.
+  std::uint32_t player; // Player::getId().
+  std::uint8_t seat;
+  std::uint8_t street; // gameStates of the game.
+  std::uint8_t action; // actions of the game.
+  std::uint32_t bet;
+  std::uint32_t round; // Action::roundCounter.
+};
+
+export enum class HistoryColumn : std::uint8_t {
+  hand,
+  player,
+  seat,
+  street,
+  action,
+  bet,
+  round
+};
+export constexpr std::size_t HISTORY_COLUMNS = 7;
+
+namespace {
+
+constexpr std::array<char, 4> HISTORY_MAGIC = {'P', 'K', 'H', 'H'};
+constexpr std::size_t FILE_HEADER_BYTES = 16;
+constexpr std::size_t BLOCK_HEADER_BYTES = 8 + 16 * HISTORY_COLUMNS;
+
+std::size_t packedWords(std::size_t records, int width) {
+  return (records * static_cast<std::size_t>(width) + 63) / 64;
+}
+
+std::uint64_t loadWord(const unsigned char *at) {
+  std::uint64_t word;
+  std::memcpy(&word, at, sizeof(word));
+  return word;
+}
+
+std::uint32_t loadWord32(const unsigned char *at) {
+  std::uint32_t word;
+  std::memcpy(&word, at, sizeof(word));
+  return word;
+}
+
+} // namespace
+
+/* Streams records into a log file. Not thread safe, use one writer per
+ * thread or per file.
+ */
+export class HandHistoryWriter {
+private:
+  std::FILE *file;
+  std::uint32_t capacity;
+  std::size_t buffered = 0;
+  std::uint64_t nextHand = 0;
+  std::uint64_t written = 0;
+  std::array<std::vector<std::uint64_t>, HISTORY_COLUMNS> columns;
+  std::vector<std::uint64_t> payload;
+
+  void put(const void *data, std::size_t bytes) {
+    if (std::fwrite(data, 1, bytes, file) != bytes) {
+      throw std::runtime_error("Failed to write the hand history.");
+    }
+  }
+
+  void writeBlock() {
+    if (buffered == 0) {
+      return;
+    }
+    std::array<std::uint64_t, HISTORY_COLUMNS> bases;
+    std::array<int, HISTORY_COLUMNS> widths;
+    std::size_t words = 0;
+    for (std::size_t c = 0; c < HISTORY_COLUMNS; c++) {
+      std::uint64_t low = columns[c][0];
+      std::uint64_t high = columns[c][0];
+      for (std::size_t i = 1; i < buffered; i++) {
+        low = std::min(low, columns[c][i]);
+        high = std::max(high, columns[c][i]);
+      }
+      bases[c] = low;
+      widths[c] = std::bit_width(high - low);
+      words += packedWords(buffered, widths[c]);
+    }
+
+    payload.assign(words, 0);
+    std::size_t offset = 0;
+    for (std::size_t c = 0; c < HISTORY_COLUMNS; c++) {
+      const int width = widths[c];
+      for (std::size_t i = 0; i < buffered and width > 0; i++) {
+        std::uint64_t delta = columns[c][i] - bases[c];
+        std::size_t bit = i * static_cast<std::size_t>(width);
+        std::size_t word = offset + bit / 64;
+        int shift = static_cast<int>(bit % 64);
+        payload[word] |= delta << shift;
+        if (shift + width > 64) {
+          payload[word + 1] |= delta >> (64 - shift);
+        }
+      }
+      offset += packedWords(buffered, width);
+    }
+
+    std::uint32_t header[2] = {static_cast<std::uint32_t>(buffered),
+                               static_cast<std::uint32_t>(words)};
+    put(header, sizeof(header));
+    for (std::size_t c = 0; c < HISTORY_COLUMNS; c++) {
+      unsigned char descriptor[16] = {};
+      std::memcpy(descriptor, &bases[c], sizeof(bases[c]));
+      descriptor[8] = static_cast<unsigned char>(widths[c]);
+      put(descriptor, sizeof(descriptor));
+    }
+    put(payload.data(), words * sizeof(std::uint64_t));
+    written += buffered;
+    buffered = 0;
+  }
+
+public:
+  explicit HandHistoryWriter(const std::string &path,
+                             std::uint32_t blockRecords = DEFAULT_HISTORY_BLOCK)
+      : file(std::fopen(path.c_str(), "wb")), capacity(blockRecords) {
+    if (file == nullptr) {
+      throw std::runtime_error("Can't open " + path + " for writing.");
+    }
+    if (capacity == 0) {
+      std::fclose(file);
+      throw std::invalid_argument("A block has to hold at least 1 record.");
+    }
+    for (auto &column : columns) {
+      column.resize(capacity);
+    }
+
+    unsigned char header[FILE_HEADER_BYTES] = {};
+    std::memcpy(header, HISTORY_MAGIC.data(), HISTORY_MAGIC.size());
+    std::uint16_t version = HISTORY_LOG_VERSION;
+    std::uint16_t columnCount = HISTORY_COLUMNS;
+    std::memcpy(header + 4, &version, sizeof(version));
+    std::memcpy(header + 6, &columnCount, sizeof(columnCount));
+    std::memcpy(header + 8, &capacity, sizeof(capacity));
+    put(header, sizeof(header));
+  }
+
+  ~HandHistoryWriter() {
+    try {
+      writeBlock();
+    } catch (...) {
+      // A destructor can't report the failure, flush() can.
+    }
+    std::fclose(file);
+  }
+
+  HandHistoryWriter(const HandHistoryWriter &) = delete;
+  HandHistoryWriter &operator=(const HandHistoryWriter &) = delete;
+
+  /* Returns the number for the next hand, records of a hand share it. */
+  std::uint64_t beginHand() { return nextHand++; }
+
+  void append(const HistoryRecord &record) {
+    columns[0][buffered] = record.hand;
+    columns[1][buffered] = record.player;
+    columns[2][buffered] = record.seat;
+    columns[3][buffered] = record.street;
+    columns[4][buffered] = record.action;
+    columns[5][buffered] = record.bet;
+    columns[6][buffered] = record.round;
+    if (++buffered == capacity) {
+      writeBlock();
+    }
+  }
+
+  /* Writes the records buffered so far as a (possibly short) block. */
+  void flush() {
+    writeBlock();
+    if (std::fflush(file) != 0) {
+      throw std::runtime_error("Failed to write the hand history.");
+    }
+  }
+
+  // Amount of records appended, written or still buffered.
+  std::uint64_t size() const { return written + buffered; }
+};
+
+/* Read only view of a log file. */
+export class HandHistoryReader {
+private:
+  struct BlockInfo {
+    const unsigned char *start;
+    std::uint32_t records;
+  };
+
+  const unsigned char *data = nullptr;
+  std::size_t bytes = 0;
+  std::vector<BlockInfo> blocks;
+  std::uint64_t records = 0;
+
+  void fail(const char *message) {
+    if (data != nullptr) {
+      munmap(const_cast<unsigned char *>(data), bytes);
+    }
+    throw std::runtime_error(message);
+  }
+
+  void indexBlocks() {
+    if (bytes < FILE_HEADER_BYTES or
+        std::memcmp(data, HISTORY_MAGIC.data(), HISTORY_MAGIC.size()) != 0) {
+      fail("Not a hand history log.");
+    }
+    std::uint16_t version;
+    std::uint16_t columnCount;
+    std::memcpy(&version, data + 4, sizeof(version));
+    std::memcpy(&columnCount, data + 6, sizeof(columnCount));
+    if (version != HISTORY_LOG_VERSION or columnCount != HISTORY_COLUMNS) {
+      fail("Unsupported hand history version.");
+    }
+
+    std::size_t at = FILE_HEADER_BYTES;
+    while (at < bytes) {
+      if (bytes - at < BLOCK_HEADER_BYTES) {
+        fail("Hand history ends in the middle of a block.");
+      }
+      std::uint32_t count = loadWord32(data + at);
+      std::uint64_t words = loadWord32(data + at + 4);
+      std::uint64_t expected = 0;
+      for (std::size_t c = 0; c < HISTORY_COLUMNS; c++) {
+        int width = data[at + 8 + 16 * c + 8];
+        if (width > 64) {
+          fail("Hand history holds an invalid block.");
+        }
+        expected += packedWords(count, width);
+      }
+      if (count == 0 or words != expected or
+          (bytes - at - BLOCK_HEADER_BYTES) / 8 < words) {
+        fail("Hand history holds an invalid block.");
+      }
+      blocks.push_back({data + at, count});
+      records += count;
+      at += BLOCK_HEADER_BYTES + words * 8;
+    }
+  }
+
+public:
+  explicit HandHistoryReader(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Can't open " + path + ".");
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+      close(fd);
+      throw std::runtime_error("Can't read " + path + ".");
+    }
+    bytes = static_cast<std::size_t>(info.st_size);
+    if (bytes > 0) {
+      void *mapped = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("Can't map " + path + ".");
+      }
+      data = static_cast<const unsigned char *>(mapped);
+      madvise(mapped, bytes, MADV_SEQUENTIAL);
+    }
+    close(fd);
+    indexBlocks();
+  }
+
+  ~HandHistoryReader() {
+    if (data != nullptr) {
+      munmap(const_cast<unsigned char *>(data), bytes);
+    }
+  }
+
+  HandHistoryReader(const HandHistoryReader &) = delete;
+  HandHistoryReader &operator=(const HandHistoryReader &) = delete;
+
+  std::uint64_t size() const { return records; }
+  std::size_t blockCount() const { return blocks.size(); }
+  std::size_t blockSize(std::size_t block) const {
+    return blocks[block].records;
+  }
+
+  /* Decodes one column of a block into out, which needs room for
+   * blockSize(block) values. Blocks are independent, so different threads
+   * can decode different blocks.
+   */
+  void readColumn(std::size_t block, HistoryColumn column,
+                  std::uint64_t *out) const {
+    const BlockInfo &info = blocks[block];
+    const auto c = static_cast<std::size_t>(column);
+    std::size_t offset = 0;
+    for (std::size_t before = 0; before < c; before++) {
+      offset += packedWords(info.records, info.start[8 + 16 * before + 8]);
+    }
+    const unsigned char *descriptor = info.start + 8 + 16 * c;
+    const std::uint64_t base = loadWord(descriptor);
+    const int width = descriptor[8];
+    if (width == 0) {
+      std::fill(out, out + info.records, base);
+      return;
+    }
+
+    const unsigned char *words = info.start + BLOCK_HEADER_BYTES + offset * 8;
+    const std::uint64_t mask =
+        width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+    for (std::size_t i = 0; i < info.records; i++) {
+      std::size_t bit = i * static_cast<std::size_t>(width);
+      int shift = static_cast<int>(bit % 64);
+      std::uint64_t value = loadWord(words + bit / 64 * 8) >> shift;
+      if (shift + width > 64) {
+        value |= loadWord(words + (bit / 64 + 1) * 8) << (64 - shift);
+      }
+      out[i] = base + (value & mask);
+    }
+  }
+
+  /* Decodes a whole block into out. */
+  void readBlock(std::size_t block, std::vector<HistoryRecord> &out) const {
+    const std::size_t count = blocks[block].records;
+    std::vector<std::uint64_t> values(count);
+    out.resize(count);
+    readColumn(block, HistoryColumn::hand, values.data());
+    for (std::size_t i = 0; i < count; i++) {
+      out[i].hand = values[i];
+    }
+    readColumn(block, HistoryColumn::player, values.data());
+    for (std::size_t i = 0; i < count; i++) {
+      out[i].player = static_cast<std::uint32_t>(values[i]);
+    }
+    readColumn(block, HistoryColumn::seat, values.data());
+    for (std::size_t i = 0; i < count; i++) {
+      out[i].seat = static_cast<std::uint8_t>(values[i]);
+    }
+    readColumn(block, HistoryColumn::street, values.data());
+    for (std::size_t i = 0; i < count; i++) {
+      out[i].street = static_cast<std::uint8_t>(values[i]);
+    }
+    readColumn(block, HistoryColumn::action, values.data());
+    for (std::size_t i = 0; i < count; i++) {
+      out[i].action = static_cast<std::uint8_t>(values[i]);
+    }
+    readColumn(block, HistoryColumn::bet, values.data());
+    for (std::size_t i = 0; i < count; i++) {
+      out[i].bet = static_cast<std::uint32_t>(values[i]);
+    }
+    readColumn(block, HistoryColumn::round, values.data());
+    for (std::size_t i = 0; i < count; i++) {
+      out[i].round = static_cast<std::uint32_t>(values[i]);
+    }
+  }
+
+  /* Calls visit for every record in the order they were written. */
+  template <typename Visitor> void forEach(Visitor &&visit) const {
+    std::vector<HistoryRecord> block;
+    for (std::size_t b = 0; b < blocks.size(); b++) {
+      readBlock(b, block);
+      for (const auto &record : block) {
+        visit(record);
+      }
+    }
+  }
+};
@@ -0,0 +1,364 @@
+/* This file implements the engine log.
+ * logTrace, logDebug, logInfo, logWarn, logError: Queue one record, a format
+ * with {} placeholders and its arguments, for example
+ *    logDebug("Next player in sequence is seat {} ({})", seat, name);
+ *    -Levels below COMPILED_LOG_LEVEL are compiled out, the call is empty.
+ * The level comes from POKER_LOG_LEVEL (0 trace to 5 off, info by default),
+ * which CMake sets from the cache variable of the same name.
+ *    -The caller only copies the arguments into the record, strings up to
+ * LOG_TEXT_BYTES characters. Formatting and writing happen on the thread of
+ * the Logger.
+ *    -format has to outlive the program, a string literal.
+ * Logger: Owns a bounded lock-free ring buffer of records (Vyukov's
+ * multi-producer queue, one sequence number per slot) and the thread that
+ * drains it into the sink, std::clog by default.
+ *    -Any amount of threads can log at once. When the ring is full the record
+ * is dropped and counted instead of blocking the engine.
+ *    -The thread starts on the first record, so a program that never logs
+ * never starts it. On exit the remaining records are written.
+ */
+module;
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+#ifndef POKER_LOG_LEVEL
+#define POKER_LOG_LEVEL 2
+#endif
+
+export module logger;
+
+export enum class LogLevel : std::uint8_t { trace, debug, info, warn, error, off };
+
+export constexpr LogLevel COMPILED_LOG_LEVEL =
+    static_cast<LogLevel>(POKER_LOG_LEVEL);
+
+export constexpr bool logEnabled(LogLevel level) {
+  return level >= COMPILED_LOG_LEVEL and level != LogLevel::off;
+}
+
+export constexpr std::size_t LOG_TEXT_BYTES = 39;
+export constexpr std::size_t LOG_PAYLOAD_BYTES = 96;
+export constexpr std::size_t LOG_RING_RECORDS = 4096;
+
+/* A string argument copied into the record, cut at LOG_TEXT_BYTES. */
+struct LogText {
+  std::uint8_t length = 0;
+  char text[LOG_TEXT_BYTES];
+
+  LogText() = default;
+  explicit LogText(std::string_view from)
+      : length(static_cast<std::uint8_t>(
+            std::min(from.size(), LOG_TEXT_BYTES))) {
+    std::memcpy(text, from.data(), length);
+  }
+};
+
+/* What a record keeps of an argument of type T. */
+template <typename T> struct LogStored {
+  using type = T;
+};
+template <> struct LogStored<std::string> {
+  using type = LogText;
+};
+template <> struct LogStored<std::string_view> {
+  using type = LogText;
+};
+template <> struct LogStored<const char *> {
+  using type = LogText;
+};
+template <> struct LogStored<char *> {
+  using type = LogText;
+};
+template <std::size_t N> struct LogStored<char[N]> {
+  using type = LogText;
+};
+
+template <typename T>
+using LogStoredType = typename LogStored<std::remove_cvref_t<T>>::type;
+
+void appendArgument(std::string &out, const LogText &value) {
+  out.append(value.text, value.length);
+}
+void appendArgument(std::string &out, bool value) {
+  out += value ? "true" : "false";
+}
+void appendArgument(std::string &out, char value) { out += value; }
+void appendArgument(std::string &out, double value) {
+  char buffer[32];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, result.ptr);
+}
+template <typename T>
+  requires std::is_integral_v<T> or std::is_enum_v<T>
+void appendArgument(std::string &out, T value) {
+  char buffer[24];
+  std::to_chars_result result;
+  if constexpr (std::is_enum_v<T>) {
+    result = std::to_chars(buffer, buffer + sizeof(buffer),
+                           static_cast<std::underlying_type_t<T>>(value));
+  } else {
+    result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  }
+  out.append(buffer, result.ptr);
+}
+
+template <typename T> constexpr std::size_t alignedOffset(std::size_t at) {
+  return (at + alignof(T) - 1) / alignof(T) * alignof(T);
+}
+
+// Bytes the arguments take in a record, packed one after the other.
+template <typename... Stored> constexpr std::size_t payloadBytes() {
+  std::size_t at = 0;
+  ((at = alignedOffset<Stored>(at) + sizeof(Stored)), ...);
+  return at;
+}
+
+/* Writes format into out with the i-th {} replaced by the i-th argument
+ * packed in payload.
+ */
+template <typename... Stored>
+void formatRecord(std::string &out, const char *format,
+                  const std::byte *payload) {
+  std::string_view rest(format);
+  std::size_t at = 0;
+  [[maybe_unused]] auto next = [&]<typename S>(std::type_identity<S>) {
+    at = alignedOffset<S>(at);
+    S value;
+    std::memcpy(static_cast<void *>(&value), payload + at, sizeof(S));
+    at += sizeof(S);
+    const std::size_t placeholder = rest.find("{}");
+    if (placeholder == std::string_view::npos) {
+      return;
+    }
+    out.append(rest.substr(0, placeholder));
+    appendArgument(out, value);
+    rest.remove_prefix(placeholder + 2);
+  };
+  (next(std::type_identity<Stored>{}), ...);
+  out.append(rest);
+}
+
+struct LogRecord {
+  using formatter = void (*)(std::string &, const char *, const std::byte *);
+
+  std::uint64_t micros; // Since the Logger started.
+  const char *format;
+  formatter render; // formatRecord of the argument types.
+  LogLevel level;
+  alignas(8) std::byte payload[LOG_PAYLOAD_BYTES];
+};
+
+export class Logger {
+private:
+  struct alignas(64) Slot {
+    std::atomic<std::uint64_t> sequence;
+    LogRecord record;
+  };
+
+  Slot *ring;
+  alignas(64) std::atomic<std::uint64_t> enqueuePosition{0};
+  alignas(64) std::uint64_t dequeuePosition = 0; // Only the thread moves it.
+  std::atomic<std::uint64_t> consumed{0};
+  std::atomic<std::uint64_t> droppedRecords{0};
+  std::atomic<bool> stopping{false};
+  std::chrono::steady_clock::time_point start;
+  std::mutex sinkMutex;
+  std::ostream *sink = &std::clog;
+  std::thread writer;
+
+  Logger() : ring(new Slot[LOG_RING_RECORDS]) {
+    for (std::size_t i = 0; i < LOG_RING_RECORDS; i++) {
+      ring[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    start = std::chrono::steady_clock::now();
+    writer = std::thread([this] { drain(); });
+  }
+
+  ~Logger() {
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+    delete[] ring;
+  }
+
+  static const char *levelName(LogLevel level) {
+    static constexpr const char *NAMES[] = {"TRACE", "DEBUG", "INFO",
+                                            "WARN",  "ERROR", "OFF"};
+    return NAMES[static_cast<int>(level)];
+  }
+
+  // Takes one record off the ring, false when it is empty.
+  bool pop(LogRecord &record) {
+    Slot &slot = ring[dequeuePosition % LOG_RING_RECORDS];
+    if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1) {
+      return false;
+    }
+    record = slot.record;
+    slot.sequence.store(dequeuePosition + LOG_RING_RECORDS,
+                        std::memory_order_release);
+    dequeuePosition++;
+    return true;
+  }
+
+  void drain() {
+    std::string line;
+    LogRecord record;
+    while (true) {
+      const bool stop = stopping.load(std::memory_order_acquire);
+      std::size_t written = 0;
+      {
+        std::lock_guard lock(sinkMutex);
+        while (pop(record)) {
+          line.clear();
+          line += '[';
+          line += levelName(record.level);
+          line += ' ';
+          appendArgument(line, record.micros);
+          line += "us] ";
+          record.render(line, record.format, record.payload);
+          line += '\n';
+          sink->write(line.data(), static_cast<std::streamsize>(line.size()));
+          written++;
+        }
+        if (written > 0) {
+          sink->flush();
+        }
+      }
+      consumed.fetch_add(written, std::memory_order_release);
+      if (stop) {
+        return;
+      }
+      if (written == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    }
+  }
+
+public:
+  Logger(const Logger &) = delete;
+  Logger &operator=(const Logger &) = delete;
+
+  static Logger &instance() {
+    static Logger logger;
+    return logger;
+  }
+
+  /* Queues a record of level, see logDebug. Never blocks, a full ring drops
+   * the record.
+   */
+  template <typename... Args>
+  void write(LogLevel level, const char *format, const Args &...args) {
+    static_assert(payloadBytes<LogStoredType<Args>...>() <= LOG_PAYLOAD_BYTES,
+                  "Too many log arguments for one record.");
+    static_assert((std::is_trivially_copyable_v<LogStoredType<Args>> and ...),
+                  "Log arguments are numbers, enums or strings.");
+
+    std::uint64_t position = enqueuePosition.load(std::memory_order_relaxed);
+    Slot *slot;
+    while (true) {
+      slot = &ring[position % LOG_RING_RECORDS];
+      const std::uint64_t sequence =
+          slot->sequence.load(std::memory_order_acquire);
+      if (sequence == position) {
+        if (enqueuePosition.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (sequence < position) {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return;
+      } else {
+        position = enqueuePosition.load(std::memory_order_relaxed);
+      }
+    }
+
+    LogRecord &record = slot->record;
+    record.micros = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+    record.format = format;
+    record.render = &formatRecord<LogStoredType<Args>...>;
+    record.level = level;
+    std::size_t at = 0;
+    [[maybe_unused]] auto store = [&]<typename S>(const S &value) {
+      at = alignedOffset<S>(at);
+      std::memcpy(record.payload + at, static_cast<const void *>(&value),
+                  sizeof(S));
+      at += sizeof(S);
+    };
+    (store(LogStoredType<Args>(args)), ...);
+    slot->sequence.store(position + 1, std::memory_order_release);
+  }
+
+  /* Waits until every record queued before the call is written. */
+  void flush() {
+    // Dropped records never took a position, so they aren't waited for.
+    const std::uint64_t target =
+        enqueuePosition.load(std::memory_order_acquire);
+    while (consumed.load(std::memory_order_acquire) < target) {
+      std::this_thread::yield();
+    }
+  }
+
+  // Where the records go from now on, after the queued ones were written.
+  void setSink(std::ostream &out) {
+    flush();
+    std::lock_guard lock(sinkMutex);
+    sink = &out;
+  }
+
+  std::uint64_t dropped() const {
+    return droppedRecords.load(std::memory_order_relaxed);
+  }
+  std::uint64_t written() const {
+    return consumed.load(std::memory_order_acquire);
+  }
+};
+
+export template <typename... Args>
+void logTrace(const char *format, const Args &...args) {
+  if constexpr (logEnabled(LogLevel::trace)) {
+    Logger::instance().write(LogLevel::trace, format, args...);
+  }
+}
+
+export template <typename... Args>
+void logDebug(const char *format, const Args &...args) {
+  if constexpr (logEnabled(LogLevel::debug)) {
+    Logger::instance().write(LogLevel::debug, format, args...);
+  }
+}
+
+export template <typename... Args>
+void logInfo(const char *format, const Args &...args) {
+  if constexpr (logEnabled(LogLevel::info)) {
+    Logger::instance().write(LogLevel::info, format, args...);
+  }
+}
+
+export template <typename... Args>
+void logWarn(const char *format, const Args &...args) {
+  if constexpr (logEnabled(LogLevel::warn)) {
+    Logger::instance().write(LogLevel::warn, format, args...);
+  }
+}
+
+export template <typename... Args>
+void logError(const char *format, const Args &...args) {
+  if constexpr (logEnabled(LogLevel::error)) {
+    Logger::instance().write(LogLevel::error, format, args...);
+  }
+}
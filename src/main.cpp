@@ -1 +1,8 @@
-int main() {}
\ No newline at end of file
+import game;
+
+int main() {
+  ManagerTest::runAllTests();
+  Manager mng;
+  mng.startGame();
+  return 0;
+}
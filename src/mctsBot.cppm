@@ -0,0 +1,327 @@
+/* This file implements a bot that decides by Monte Carlo tree search.
+ * MctsBot: Information set MCTS from the GameState of a decision.
+ *    -Every iteration determinizes the hand: the hole cards of the other
+ * seats and the cards still to come are dealt at random from the cards the
+ * bot hasn't seen. The hole cards the game exported for the other seats are
+ * never looked at.
+ *    -The tree is over sequences of moves. Which moves are legal only depends
+ * on chips and bets, so every determinization walks the same tree and only
+ * the rewards differ. A node picks its child by UCB1 on the rewards of the
+ * seat choosing there.
+ *    -The moves of a node (searchMoves) are the legal actions, bets and raises
+ * at the minimum and at the size of the pot. Folding is left out when a check
+ * is free.
+ *    -A new leaf is played to the end of the hand by the default policy:
+ * random moves that mostly check and call, without any search.
+ *    -Rewards are the chips a seat wins or loses from the decision on, divided
+ * by the chips the deciding seat has at stake.
+ *    -Root parallel: every thread of the pool grows its own tree with its own
+ * generator until settings.budget runs out (or after settings.iterations),
+ * then the visits of the root moves are added up and the most visited move
+ * is played. A decision always takes about the budget and plays the best
+ * move found by then.
+ * mctsStrategy: A strategy that asks a bot, for BasicGame::setStrategy.
+ */
+module;
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+export module mctsBot;
+import cards;
+import game;
+import prng;
+import seatTable;
+import threadPool;
+
+export constexpr int MAX_SEARCH_MOVES = 8;
+// Nodes of one tree, a tree that is full only runs more rollouts.
+export constexpr std::size_t MAX_MCTS_NODES = std::size_t{1} << 20;
+
+/* The moves a node of the tree considers, in the order of the actions enum
+ * with the smaller amount first.
+ */
+export struct SearchMoves {
+  std::array<Action, MAX_SEARCH_MOVES> moves{};
+  int count = 0;
+
+  void add(actions act, money amount) {
+    moves[count++] = Action{act, amount, 0};
+  }
+};
+
+export SearchMoves searchMoves(const GameState &state) {
+  SearchMoves result;
+  const LegalMoves legal = state.legalActions();
+  for (actions act : legal) {
+    if (act == actions::fold and legal.isLegal(actions::check)) {
+      continue;
+    }
+    const money least = legal.minAmount(act);
+    result.add(act, least);
+    if (act == actions::bet or act == actions::raise) {
+      // A pot sized bet, a raise to the call plus the pot after calling.
+      money potSized = state.pot;
+      if (act == actions::raise) {
+        potSized = state.highestBet * 2 + state.pot - state.bets[state.actor];
+      }
+      if (potSized > least and potSized < legal.maxAmount(act)) {
+        result.add(act, potSized);
+      }
+    }
+  }
+  return result;
+}
+
+export struct MctsSettings {
+  std::chrono::microseconds budget = std::chrono::milliseconds(50);
+  std::uint64_t iterations = 0; // Per thread, 0 for as many as fit.
+  double exploration = 0.7;
+  std::uint64_t seed = 0;
+};
+
+/* What a search found: the root moves with their visits and mean reward,
+ * summed over all trees.
+ */
+export struct MctsResult {
+  Action action{};
+  SearchMoves moves;
+  std::array<std::uint64_t, MAX_SEARCH_MOVES> visits{};
+  std::array<double, MAX_SEARCH_MOVES> reward{};
+  std::uint64_t iterations = 0;
+};
+
+struct MctsNode {
+  double reward = 0; // Sum of the rewards of the seat moving into the node.
+  std::uint32_t visits = 0;
+  std::int32_t firstChild = -1;
+  std::uint8_t children = 0;
+  std::int8_t mover = -1;
+};
+
+/* The other seats get random hole cards and the deck is what's left, the
+ * generator of the state deals the rest of the board from it.
+ */
+GameState determinize(const GameState &root, Xoshiro256 &rng) {
+  GameState state = root;
+  const int hero = root.actor;
+  CardSet unseen(~std::uint64_t{0});
+  unseen -= CardSet(root.holeCards[hero]);
+  unseen -= CardSet(root.communityCards());
+  state.deck = Deck(unseen);
+  for (int seat = 0; seat < root.seats; seat++) {
+    if (seat != hero and (root.active & (seatMask{1} << seat))) {
+      state.holeCards[seat] = {state.deck.dealCard(rng),
+                               state.deck.dealCard(rng)};
+    }
+  }
+  state.rng = Xoshiro256(rng());
+  return state;
+}
+
+// The default policy: calls and checks three times as often as it bets.
+Action rolloutMove(const GameState &state, Xoshiro256 &rng) {
+  static constexpr std::array<std::uint32_t, ACTION_COUNT> WEIGHTS = {
+      1, 6, 6, 2, 1, 2}; // fold, check, call, raise, allIn, bet
+  const LegalMoves legal = state.legalActions();
+  std::uint32_t total = 0;
+  for (actions act : legal) {
+    if (act != actions::fold or !legal.isLegal(actions::check)) {
+      total += WEIGHTS[static_cast<int>(act)];
+    }
+  }
+  std::uint32_t pick = uniformBelow(rng, total);
+  for (actions act : legal) {
+    if (act == actions::fold and legal.isLegal(actions::check)) {
+      continue;
+    }
+    const std::uint32_t weight = WEIGHTS[static_cast<int>(act)];
+    if (pick < weight) {
+      return Action{act, legal.minAmount(act), 0};
+    }
+    pick -= weight;
+  }
+  return Action{actions::fold, 0, 0};
+}
+
+/* One tree of the root parallel search, grown until deadline or after
+ * iterations.
+ */
+class MctsTree {
+private:
+  const GameState &root;
+  double exploration;
+  double scale; // What the deciding seat has at stake.
+  std::vector<MctsNode> nodes;
+  std::vector<std::int32_t> path;
+
+  void expand(std::int32_t node, const GameState &state) {
+    const SearchMoves moves = searchMoves(state);
+    nodes[node].firstChild = static_cast<std::int32_t>(nodes.size());
+    nodes[node].children = static_cast<std::uint8_t>(moves.count);
+    for (int i = 0; i < moves.count; i++) {
+      MctsNode child;
+      child.mover = state.actor;
+      nodes.push_back(child);
+    }
+  }
+
+  // UCB1 over the children of node, an unvisited child first.
+  int select(std::int32_t node) const {
+    const MctsNode &parent = nodes[node];
+    const double logVisits = std::log(static_cast<double>(parent.visits));
+    int best = 0;
+    double bestScore = -1e300;
+    for (int i = 0; i < parent.children; i++) {
+      const MctsNode &child = nodes[parent.firstChild + i];
+      if (child.visits == 0) {
+        return i;
+      }
+      const double visits = static_cast<double>(child.visits);
+      const double score = child.reward / visits +
+                           exploration * std::sqrt(logVisits / visits);
+      if (score > bestScore) {
+        bestScore = score;
+        best = i;
+      }
+    }
+    return best;
+  }
+
+public:
+  MctsTree(const GameState &root, double exploration)
+      : root(root), exploration(exploration),
+        scale(static_cast<double>(root.chips[root.actor] + root.pot)) {
+    nodes.reserve(4096);
+    nodes.emplace_back();
+    expand(0, root);
+  }
+
+  void iterate(Xoshiro256 &rng) {
+    GameState state = determinize(root, rng);
+    std::int32_t node = 0;
+    path.clear();
+    path.push_back(node);
+    while (!state.isTerminal()) {
+      if (nodes[node].firstChild < 0) {
+        if (nodes.size() + MAX_SEARCH_MOVES > MAX_MCTS_NODES) {
+          break;
+        }
+        expand(node, state);
+      }
+      const int pick = select(node);
+      state.apply(searchMoves(state).moves[pick]);
+      node = nodes[node].firstChild + pick;
+      path.push_back(node);
+      if (nodes[node].visits == 0) {
+        break;
+      }
+    }
+    while (!state.isTerminal()) {
+      state.apply(rolloutMove(state, rng));
+    }
+
+    for (std::int32_t visited : path) {
+      MctsNode &at = nodes[visited];
+      at.visits++;
+      if (at.mover >= 0) {
+        at.reward += (static_cast<double>(state.chips[at.mover]) -
+                      static_cast<double>(root.chips[at.mover])) /
+                     scale;
+      }
+    }
+  }
+
+  const MctsNode &rootChild(int move) const {
+    return nodes[nodes[0].firstChild + move];
+  }
+  std::uint64_t iterations() const { return nodes[0].visits; }
+};
+
+export class MctsBot {
+private:
+  MctsSettings settings;
+  ThreadPool pool;
+  std::atomic<std::uint64_t> searches{0};
+
+public:
+  explicit MctsBot(const MctsSettings &settings = {},
+                   std::size_t threads = std::thread::hardware_concurrency())
+      : settings(settings), pool(threads) {}
+
+  std::size_t threads() const { return pool.size(); }
+
+  /* Searches the decision of state.actor. Throws std::invalid_argument when
+   * the hand of state is over.
+   */
+  MctsResult search(const GameState &state) {
+    if (state.isTerminal()) {
+      throw std::invalid_argument("The hand of the state is over.");
+    }
+    MctsResult result;
+    result.moves = searchMoves(state);
+    result.action = result.moves.moves[0];
+    if (result.moves.count == 1) {
+      return result;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + settings.budget;
+    const std::uint64_t search = searches.fetch_add(1);
+    std::vector<std::unique_ptr<MctsTree>> trees(pool.size());
+    pool.parallelFor(trees.size(), [&](std::size_t index) {
+      Xoshiro256 rng(settings.seed ^ search, index);
+      trees[index] = std::make_unique<MctsTree>(state, settings.exploration);
+      MctsTree &tree = *trees[index];
+      for (std::uint64_t i = 0;
+           settings.iterations == 0 or i < settings.iterations; i++) {
+        // The clock is only read every 16 iterations.
+        if (i % 16 == 0 and std::chrono::steady_clock::now() >= deadline) {
+          break;
+        }
+        tree.iterate(rng);
+      }
+    });
+
+    int best = 0;
+    for (int move = 0; move < result.moves.count; move++) {
+      for (const auto &tree : trees) {
+        const MctsNode &child = tree->rootChild(move);
+        result.visits[move] += child.visits;
+        result.reward[move] += child.reward;
+      }
+      if (result.visits[move] > 0) {
+        result.reward[move] /= static_cast<double>(result.visits[move]);
+      }
+      if (result.visits[move] > result.visits[best] or
+          (result.visits[move] == result.visits[best] and
+           result.reward[move] > result.reward[best])) {
+        best = move;
+      }
+    }
+    for (const auto &tree : trees) {
+      result.iterations += tree->iterations();
+    }
+    result.action = result.moves.moves[best];
+    return result;
+  }
+
+  Action decide(const GameState &state) { return search(state).action; }
+};
+
+/* Lets bot decide every turn of the seat, bot can be shared by several seats
+ * and games that don't decide at the same time.
+ */
+export strategy mctsStrategy(std::shared_ptr<MctsBot> bot) {
+  return [bot](const turnInfo &info) {
+    Action action = bot->decide(info.state());
+    action.roundCounter = info.currentRound;
+    return action;
+  };
+}
@@ -137,11 +137,17 @@ public:
   // Does nothing.
   void check();
 
+  // Matches globalCurrentBet, or puts in all chips when that isn't enough.
+  // Returns the chips paid.
   int call(int globalCurrentBet) {
-    money toCall = globalCurrentBet - currentBet;
-    deductChips(globalCurrentBet);
-    currentBet += globalCurrentBet; // Update player's current bet
-    return globalCurrentBet;
+    money target = static_cast<money>(globalCurrentBet);
+    money toCall = target > currentBet ? target - currentBet : 0;
+    if (toCall > chips) {
+      toCall = chips;
+    }
+    deductChips(toCall);
+    currentBet += toCall; // Update player's current bet
+    return toCall;
   }
 
   void fold() { hasFolded = true; }
@@ -0,0 +1,201 @@
+/* Plays bots that run as processes of their own against each other, the way
+ * chess engines speak UCI. Every bot command is started once through /bin/sh
+ * and plays its seat in every tournament, the protocol is the one of the
+ * botProtocol module.
+ * Usage: poker_arena [--binary] [--tables <n>] [--hands <n>] [--seed <n>]
+ *                    [--timeout-ms <n>] <bot command> <bot command> ...
+ *        poker_arena --bot
+ * The first form needs 3 to 6 bot commands. Each table is a tournament of up
+ * to --hands hands (1000) from fresh stacks, a move that takes longer than
+ * --timeout-ms (1000) checks or folds. For every bot it reports the tables
+ * won, the chips over all tables, the faults and timeouts and how long a
+ * decision took from sending the turn to reading the answer.
+ * The second form is a reference bot that checks and calls down in either
+ * mode, a starting point for the bots of other teams:
+ *    poker_arena "poker_arena --bot" "poker_arena --bot" "poker_arena --bot"
+ */
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unistd.h>
+import game;
+import decisionSource;
+import botProtocol;
+import tournament;
+
+static bool writeAll(std::string_view bytes) {
+  while (!bytes.empty()) {
+    const ssize_t wrote = ::write(STDOUT_FILENO, bytes.data(), bytes.size());
+    if (wrote <= 0) {
+      return false;
+    }
+    bytes.remove_prefix(static_cast<std::size_t>(wrote));
+  }
+  return true;
+}
+
+/* The reference bot, on blocking stdin and stdout. Reads the handshake line,
+ * then answers every turn until stdin is closed.
+ */
+static int runReferenceBot() {
+  std::string inbox;
+  char buffer[4096];
+  auto fill = [&]() {
+    const ssize_t got = ::read(STDIN_FILENO, buffer, sizeof(buffer));
+    if (got <= 0) {
+      return false;
+    }
+    inbox.append(buffer, static_cast<std::size_t>(got));
+    return true;
+  };
+  auto nextLine = [&](std::string &line) {
+    std::size_t end;
+    while ((end = inbox.find('\n')) == std::string::npos) {
+      if (!fill()) {
+        return false;
+      }
+    }
+    line.assign(inbox, 0, end);
+    inbox.erase(0, end + 1);
+    return true;
+  };
+
+  std::string line;
+  if (!nextLine(line) or !writeAll("ready\n")) {
+    return 1;
+  }
+  const bool binary = line == "poker binary";
+  std::string answer;
+  while (true) {
+    answer.clear();
+    if (binary) {
+      while (inbox.size() < TURN_FRAME_BYTES) {
+        if (!fill()) {
+          return 0;
+        }
+      }
+      const TurnMessage turn = readTurnPayload(
+          std::string_view(inbox).substr(4, TURN_PAYLOAD_BYTES));
+      inbox.erase(0, TURN_FRAME_BYTES);
+      appendActionFrame(answer, callDown(turn.moves), 0);
+    } else {
+      if (!nextLine(line)) {
+        return 0;
+      }
+      answer = formatAnswer(callDown(parseMoves(line)), 0);
+      answer += '\n';
+    }
+    if (!writeAll(answer)) {
+      return 0;
+    }
+  }
+}
+
+static void printUsage(const char *program) {
+  std::cerr << "Usage: " << program
+            << " [--binary] [--tables <n>] [--hands <n>] [--seed <n>]"
+               " [--timeout-ms <n>] <bot command> <bot command> ...\n"
+            << "       " << program << " --bot" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc == 2 and std::string(argv[1]) == "--bot") {
+    return runReferenceBot();
+  }
+
+  ProtocolMode mode = ProtocolMode::line;
+  std::size_t tables = 1;
+  gameSettings settings;
+  settings.maximumRounds = 1000;
+  std::uint64_t seed = 1;
+  std::chrono::milliseconds timeout(1000);
+  std::vector<std::string> commands;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if (arg == "--binary") {
+      mode = ProtocolMode::binary;
+    } else if (arg == "--tables" and hasValue) {
+      tables = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--hands" and hasValue) {
+      settings.maximumRounds = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--seed" and hasValue) {
+      seed = std::strtoull(argv[++i], nullptr, 10);
+    } else if (arg == "--timeout-ms" and hasValue) {
+      timeout =
+          std::chrono::milliseconds(std::strtoull(argv[++i], nullptr, 10));
+    } else if (arg.rfind("--", 0) == 0) {
+      printUsage(argv[0]);
+      return 1;
+    } else {
+      commands.push_back(arg);
+    }
+  }
+  if (commands.size() < 3 or commands.size() > 6 or tables == 0) {
+    printUsage(argv[0]);
+    return 1;
+  }
+  settings.maxAmountPlayers = commands.size();
+
+  try {
+    std::vector<std::shared_ptr<ProcessSource>> bots;
+    for (const std::string &command : commands) {
+      bots.push_back(std::make_shared<ProcessSource>(command, mode, timeout));
+    }
+
+    std::vector<std::size_t> wins(bots.size(), 0);
+    std::vector<std::uint64_t> chips(bots.size(), 0);
+    std::size_t hands = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (std::size_t table = 0; table < tables; table++) {
+      HeadlessManager manager(settings, tableSeed(seed, table));
+      for (std::size_t seat = 0; seat < bots.size(); seat++) {
+        manager.setStrategy(static_cast<position>(seat),
+                            sourceStrategy(bots[seat]));
+      }
+      manager.startGame();
+      hands += manager.getCurrentRound();
+      std::size_t winner = 0;
+      for (std::size_t seat = 0; seat < bots.size(); seat++) {
+        chips[seat] += manager.players[seat]->getChips();
+        if (manager.players[seat]->getChips() >
+            manager.players[winner]->getChips()) {
+          winner = seat;
+        }
+      }
+      wins[winner]++;
+    }
+    const std::chrono::duration<double> seconds =
+        std::chrono::steady_clock::now() - start;
+
+    std::uint64_t decisions = 0;
+    std::cout << "Played " << tables << " tables (" << hands << " hands) in "
+              << seconds.count() << " s\n";
+    for (std::size_t seat = 0; seat < bots.size(); seat++) {
+      const ProcessSource &bot = *bots[seat];
+      decisions += bot.decisions();
+      std::cout << "Seat " << seat << " \"" << commands[seat] << "\": "
+                << wins[seat] << " tables won, " << chips[seat] << " chips, "
+                << bot.decisions() << " decisions, " << bot.faults()
+                << " faults (" << bot.timeouts() << " timeouts), "
+                << std::fixed << std::setprecision(2)
+                << bot.meanRoundTrip().count() / 1000.0
+                << " us per decision" << std::defaultfloat
+                << (bot.isBroken() ? ", broken" : "") << "\n";
+    }
+    std::cout << "Decisions/sec: " << decisions / seconds.count() << std::endl;
+  } catch (const std::exception &error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
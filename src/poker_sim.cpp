@@ -0,0 +1,174 @@
+/* Plays hands without a human at the table and reports the throughput.
+ * Every seat is driven by a strategy that picks a random valid action, the
+ * game itself is a HeadlessGame so no console output happens per action.
+ * Every hand starts from fresh stacks with the dealer button moved one seat.
+ * Usage: poker_sim <amount of hands> <seed> [replay log to write]
+ *        poker_sim --replay <replay log>
+ *        poker_sim --tournaments <amount of tables> <seed> [threads] [--rules]
+ * The second form plays every hand of a log again and reports the first hand
+ * that doesn't end like it was recorded.
+ * The third form plays whole tournaments of up to 1000 hands on independent
+ * tables, spread over all cores (or threads), and reports tables/sec. With
+ * --rules every seat is a RuleBot (all sharing one) instead of random.
+ */
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+import player;
+import game;
+import prng;
+import replay;
+import ruleBot;
+import threadPool;
+import tournament;
+
+// Replays every hand of the log at path, returns the process exit code.
+static int replayLog(const char *path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    std::cerr << "Can't open " << path << std::endl;
+    return 1;
+  }
+
+  std::size_t hands = 0;
+  auto start = std::chrono::steady_clock::now();
+  try {
+    ReplayReader reader(file);
+    HandRecord record;
+    while (reader.next(record)) {
+      replayHand(record);
+      hands++;
+    }
+  } catch (const std::exception &error) {
+    std::cerr << "Hand " << hands << ": " << error.what() << std::endl;
+    return 1;
+  }
+  auto stop = std::chrono::steady_clock::now();
+
+  double seconds = std::chrono::duration<double>(stop - start).count();
+  std::cout << "Replayed " << hands << " hands in " << seconds << " s\n";
+  std::cout << "Hands/sec: " << static_cast<double>(hands) / seconds
+            << std::endl;
+  return 0;
+}
+
+// Plays tables tournaments with threads threads and prints the aggregate.
+static int runTables(std::size_t tables, std::uint64_t seed,
+                     std::size_t threads, bool rules) {
+  gameSettings settings;
+  settings.maximumRounds = 1000;
+  ThreadPool pool(threads);
+  std::shared_ptr<const RuleBot> bot;
+  if (rules) {
+    bot = std::make_shared<const RuleBot>();
+  }
+  TournamentResults results = runTournaments(
+      pool, tables, seed, settings, [&bot](position, Xoshiro256 &rng) {
+        return bot ? ruleStrategy(bot) : randomStrategy(rng);
+      });
+
+  std::cout << "Played " << tables << " tournaments (" << results.hands
+            << " hands) on " << pool.size() << " threads in "
+            << results.seconds << " s\n";
+  std::cout << "Tables/sec: " << results.tablesPerSecond() << "\n";
+  std::cout << "Hands/sec: " << results.handsPerSecond() << "\n";
+  for (std::size_t seat = 0; seat < results.wins.size(); seat++) {
+    std::cout << "Seat " << seat << " won " << results.wins[seat]
+              << " tables\n";
+  }
+  return 0;
+}
+
+int main(int argc, char **argv) {
+  if (argc == 3 and std::string(argv[1]) == "--replay") {
+    return replayLog(argv[2]);
+  }
+  if (argc >= 4 and std::string(argv[1]) == "--tournaments") {
+    const bool rules = std::string(argv[argc - 1]) == "--rules";
+    if (rules) {
+      argc--;
+    }
+    const std::size_t threads = argc > 4
+                                    ? std::strtoull(argv[4], nullptr, 10)
+                                    : std::thread::hardware_concurrency();
+    return runTables(std::strtoull(argv[2], nullptr, 10),
+                     std::strtoull(argv[3], nullptr, 10), threads, rules);
+  }
+  if (argc < 3) {
+    std::cerr << "Usage: " << argv[0]
+              << " <amount of hands> <seed> [replay log to write]\n"
+              << "       " << argv[0] << " --replay <replay log>\n"
+              << "       " << argv[0]
+              << " --tournaments <amount of tables> <seed> [threads] [--rules]"
+              << std::endl;
+    return 1;
+  }
+  const std::size_t hands = std::strtoull(argv[1], nullptr, 10);
+  const std::uint64_t seed = std::strtoull(argv[2], nullptr, 10);
+
+  std::ofstream logFile;
+  std::unique_ptr<ReplayWriter> writer;
+  if (argc > 3) {
+    logFile.open(argv[3], std::ios::binary);
+    if (!logFile) {
+      std::cerr << "Can't open " << argv[3] << std::endl;
+      return 1;
+    }
+    writer = std::make_unique<ReplayWriter>(logFile);
+  }
+
+  gameSettings settings;
+  const std::vector<std::string> names = {"Phill", "Doyle",  "Daniel",
+                                          "Chris", "Johnny", "You"};
+  playersPool players;
+  for (const auto &name : names) {
+    players.push_back(std::make_shared<Player>(name, settings.startingChips));
+  }
+  const position seats = static_cast<position>(players.size());
+
+  Xoshiro256 decisions(seed);
+  std::uint64_t potChecksum = 0;
+
+  // One game for every hand keeps its allocations warm.
+  HeadlessGame game(players, settings, positions{}, seed);
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t hand = 0; hand < hands; hand++) {
+    for (auto &player : players) {
+      player->setChips(settings.startingChips);
+      player->resetCurrentBet();
+    }
+
+    positions pos;
+    pos.dealerPosition = static_cast<position>(hand % seats);
+    pos.posSB = (pos.dealerPosition + 1) % seats;
+    pos.posBB = (pos.dealerPosition + 2) % seats;
+
+    game.newHand(pos, seed + hand);
+    for (position seat = 0; seat < seats; seat++) {
+      game.setStrategy(seat, randomStrategy(decisions));
+    }
+    if (writer) {
+      writer->write(recordHand(game));
+    } else {
+      game.simulateHand();
+    }
+    potChecksum += game.getPot();
+  }
+  auto stop = std::chrono::steady_clock::now();
+
+  double seconds = std::chrono::duration<double>(stop - start).count();
+  std::cout << "Simulated " << hands << " hands in " << seconds << " s\n";
+  std::cout << "Hands/sec: " << static_cast<double>(hands) / seconds << "\n";
+  std::cout << "Hands/min: " << 60.0 * static_cast<double>(hands) / seconds
+            << "\n";
+  std::cout << "Pot checksum: " << potChecksum << std::endl;
+  return 0;
+}
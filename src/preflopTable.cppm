@@ -0,0 +1,393 @@
+/* This file implements a precomputed table of preflop all-in equities.
+ * startingHand: Maps two hole cards onto one of the 169 starting hands.
+ * Ranks count from 0 (Two) to 12 (Ace), a pair is high * 13 + high, a suited
+ * hand high * 13 + low and an offsuit hand low * 13 + high.
+ * generatePreflopTable: Estimates for every starting hand
+ *    -its heads-up equity against every other starting hand,
+ *    -its equity against 1 to 5 random hands (2 to 6 players, the range of
+ * gameSettings).
+ * Every entry is sampled from random suits for both starting hands and a
+ * random board, the entries are spread over a ThreadPool and seeded by their
+ * own stream so the table only depends on the seed.
+ * writePreflopTable / PreflopTable: A binary file of the table, which
+ * PreflopTable memory maps. A lookup is one load from the mapping.
+ *
+ * File layout (little endian):
+ *    -Header, 32 bytes: magic "PKPF", uint16 version, uint16 starting hands
+ * (169), uint16 most players (6), uint16 reserved, uint32 samples per entry,
+ * uint64 seed, uint32 FNV-1a checksum of the payload, uint32 reserved.
+ *    -float32 headsUp[169][169], headsUp[hero][villain] being the share of
+ * the pot hero wins.
+ *    -float32 versusRandom[169][5], versusRandom[hand][players - 2].
+ */
+module;
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+export module preflopTable;
+import cards;
+import bestHand;
+import prng;
+import threadPool;
+
+static_assert(std::endian::native == std::endian::little,
+              "The preflop table is stored little endian.");
+
+export constexpr std::uint16_t PREFLOP_TABLE_VERSION = 1;
+export constexpr int STARTING_HANDS = 169;
+export constexpr int MIN_TABLE_PLAYERS = 2;
+export constexpr int MAX_TABLE_PLAYERS = 6;
+export constexpr int TABLE_PLAYER_COUNTS =
+    MAX_TABLE_PLAYERS - MIN_TABLE_PLAYERS + 1;
+
+export int startingHand(Card first, Card second) {
+  int high = static_cast<int>(first.getRank()) - static_cast<int>(Rank::Two);
+  int low = static_cast<int>(second.getRank()) - static_cast<int>(Rank::Two);
+  if (high < low) {
+    std::swap(high, low);
+  }
+  if (first.getSuit() == second.getSuit() or high == low) {
+    return high * 13 + low;
+  }
+  return low * 13 + high;
+}
+
+/* "AA", "AKs" or "72o". */
+export std::string startingHandName(int hand) {
+  static constexpr char RANKS[] = "23456789TJQKA";
+  const int row = hand / 13;
+  const int column = hand % 13;
+  std::string name{RANKS[std::max(row, column)], RANKS[std::min(row, column)]};
+  if (row > column) {
+    name += 's';
+  } else if (row < column) {
+    name += 'o';
+  }
+  return name;
+}
+
+// Amount of card combinations of a starting hand: 6 pairs, 4 suited, 12 off.
+export int startingHandCombos(int hand) {
+  const int row = hand / 13;
+  const int column = hand % 13;
+  return row == column ? 6 : (row > column ? 4 : 12);
+}
+
+/* The equities of all starting hands, as generatePreflopTable returns them
+ * and writePreflopTable stores them.
+ */
+export struct PreflopTableData {
+  std::uint32_t samples = 0;
+  std::uint64_t seed = 0;
+  std::vector<float> headsUp;      // [hero * 169 + villain]
+  std::vector<float> versusRandom; // [hand * 5 + players - 2]
+};
+
+namespace {
+
+constexpr std::array<char, 4> TABLE_MAGIC = {'P', 'K', 'P', 'F'};
+constexpr std::size_t TABLE_HEADER_BYTES = 32;
+constexpr std::size_t HEADS_UP_ENTRIES = STARTING_HANDS * STARTING_HANDS;
+constexpr std::size_t VERSUS_RANDOM_ENTRIES =
+    STARTING_HANDS * TABLE_PLAYER_COUNTS;
+constexpr std::size_t TABLE_PAYLOAD_BYTES =
+    (HEADS_UP_ENTRIES + VERSUS_RANDOM_ENTRIES) * sizeof(float);
+
+/* The card combinations of every starting hand, as 2-bit masks. */
+std::array<std::vector<std::uint64_t>, STARTING_HANDS> combosByHand() {
+  std::array<std::vector<std::uint64_t>, STARTING_HANDS> combos;
+  for (int a = 0; a < DECK_SIZE; a++) {
+    for (int b = a + 1; b < DECK_SIZE; b++) {
+      combos[startingHand(Card::fromIndex(a), Card::fromIndex(b))].push_back(
+          (std::uint64_t{1} << a) | (std::uint64_t{1} << b));
+    }
+  }
+  return combos;
+}
+
+// A random card that is not in dead, added to dead.
+template <typename Generator>
+std::uint64_t drawCard(Generator &rng, std::uint64_t &dead) {
+  while (true) {
+    const std::uint64_t card = std::uint64_t{1} << uniformBelow(rng, DECK_SIZE);
+    if ((dead & card) == 0) {
+      dead |= card;
+      return card;
+    }
+  }
+}
+
+template <typename Generator>
+std::uint64_t drawBoard(Generator &rng, std::uint64_t &dead) {
+  std::uint64_t board = 0;
+  for (std::size_t i = 0; i < 5; i++) {
+    board |= drawCard(rng, dead);
+  }
+  return board;
+}
+
+template <typename Generator>
+std::uint64_t pickCombo(Generator &rng, const std::vector<std::uint64_t> &combos,
+                        std::uint64_t dead) {
+  while (true) {
+    const std::uint64_t combo = combos[uniformBelow(
+        rng, static_cast<std::uint32_t>(combos.size()))];
+    if ((dead & combo) == 0) {
+      return combo;
+    }
+  }
+}
+
+std::uint32_t fnv1a(const unsigned char *data, std::size_t bytes) {
+  std::uint32_t hash = 2166136261u;
+  for (std::size_t i = 0; i < bytes; i++) {
+    hash = (hash ^ data[i]) * 16777619u;
+  }
+  return hash;
+}
+
+} // namespace
+
+/* Samples the heads-up equity of hero against villain, both starting hands.
+ * The suits of villain are picked among the combinations that don't share a
+ * card with hero. Every combination of hero leaves the same amount of those,
+ * so every possible pair of combinations is equally likely.
+ */
+export double sampleHeadsUp(int hero, int villain, std::uint32_t samples,
+                            Xoshiro256 &rng) {
+  static const auto combos = combosByHand();
+  std::uint64_t won = 0; // In half pots.
+  for (std::uint32_t s = 0; s < samples; s++) {
+    const std::uint64_t heroCards = pickCombo(rng, combos[hero], 0);
+    const std::uint64_t villainCards =
+        pickCombo(rng, combos[villain], heroCards);
+    std::uint64_t dead = heroCards | villainCards;
+    const CardSet board(drawBoard(rng, dead));
+    const HandValue heroValue = evaluateHand(CardSet(heroCards) | board);
+    const HandValue villainValue = evaluateHand(CardSet(villainCards) | board);
+    won += heroValue > villainValue ? 2 : (heroValue == villainValue ? 1 : 0);
+  }
+  return static_cast<double>(won) / (2.0 * samples);
+}
+
+/* Samples the equity of hand against players - 1 random hands. */
+export double sampleVersusRandom(int hand, int players,
+                                 std::uint32_t samples, Xoshiro256 &rng) {
+  static const auto combos = combosByHand();
+  double won = 0;
+  for (std::uint32_t s = 0; s < samples; s++) {
+    const std::uint64_t heroCards = pickCombo(rng, combos[hand], 0);
+    std::uint64_t dead = heroCards;
+    std::array<std::uint64_t, MAX_TABLE_PLAYERS> opponents;
+    for (int p = 1; p < players; p++) {
+      opponents[p] = drawCard(rng, dead) | drawCard(rng, dead);
+    }
+    const CardSet board(drawBoard(rng, dead));
+
+    const HandValue heroValue = evaluateHand(CardSet(heroCards) | board);
+    int sharing = 1;
+    for (int p = 1; p < players; p++) {
+      const HandValue value = evaluateHand(CardSet(opponents[p]) | board);
+      if (value > heroValue) {
+        sharing = 0;
+        break;
+      }
+      sharing += value == heroValue;
+    }
+    won += sharing > 0 ? 1.0 / sharing : 0.0;
+  }
+  return won / samples;
+}
+
+/* Fills the whole table with samples per entry. Heads-up entries are sampled
+ * once per unordered pair, the mirrored entry is 1 minus it.
+ */
+export PreflopTableData generatePreflopTable(ThreadPool &pool,
+                                             std::uint32_t samples,
+                                             std::uint64_t seed) {
+  if (samples == 0) {
+    throw std::invalid_argument("Every entry needs at least 1 sample.");
+  }
+  PreflopTableData table;
+  table.samples = samples;
+  table.seed = seed;
+  table.headsUp.assign(HEADS_UP_ENTRIES, 0.5f);
+  table.versusRandom.assign(VERSUS_RANDOM_ENTRIES, 0.0f);
+
+  // Task hero samples hero against every villain from hero on, the rows get
+  // shorter towards the end and work stealing evens that out.
+  pool.parallelFor(STARTING_HANDS, [&](std::size_t task) {
+    const int hero = static_cast<int>(task);
+    for (int villain = hero + 1; villain < STARTING_HANDS; villain++) {
+      Xoshiro256 rng(seed, hero * STARTING_HANDS + villain);
+      const double equity = sampleHeadsUp(hero, villain, samples, rng);
+      table.headsUp[hero * STARTING_HANDS + villain] =
+          static_cast<float>(equity);
+      table.headsUp[villain * STARTING_HANDS + hero] =
+          static_cast<float>(1 - equity);
+    }
+  });
+  pool.parallelFor(VERSUS_RANDOM_ENTRIES, [&](std::size_t entry) {
+    Xoshiro256 rng(seed, HEADS_UP_ENTRIES + entry);
+    const int hand = static_cast<int>(entry / TABLE_PLAYER_COUNTS);
+    const int players =
+        static_cast<int>(entry % TABLE_PLAYER_COUNTS) + MIN_TABLE_PLAYERS;
+    table.versusRandom[entry] = static_cast<float>(
+        sampleVersusRandom(hand, players, samples, rng));
+  });
+  return table;
+}
+
+export void writePreflopTable(const std::string &path,
+                              const PreflopTableData &table) {
+  if (table.headsUp.size() != HEADS_UP_ENTRIES or
+      table.versusRandom.size() != VERSUS_RANDOM_ENTRIES) {
+    throw std::invalid_argument("Preflop table has the wrong size.");
+  }
+  std::vector<unsigned char> payload(TABLE_PAYLOAD_BYTES);
+  std::memcpy(payload.data(), table.headsUp.data(),
+              HEADS_UP_ENTRIES * sizeof(float));
+  std::memcpy(payload.data() + HEADS_UP_ENTRIES * sizeof(float),
+              table.versusRandom.data(), VERSUS_RANDOM_ENTRIES * sizeof(float));
+
+  unsigned char header[TABLE_HEADER_BYTES] = {};
+  std::memcpy(header, TABLE_MAGIC.data(), TABLE_MAGIC.size());
+  const std::uint16_t version = PREFLOP_TABLE_VERSION;
+  const std::uint16_t hands = STARTING_HANDS;
+  const std::uint16_t players = MAX_TABLE_PLAYERS;
+  const std::uint32_t checksum = fnv1a(payload.data(), payload.size());
+  std::memcpy(header + 4, &version, sizeof(version));
+  std::memcpy(header + 6, &hands, sizeof(hands));
+  std::memcpy(header + 8, &players, sizeof(players));
+  std::memcpy(header + 12, &table.samples, sizeof(table.samples));
+  std::memcpy(header + 16, &table.seed, sizeof(table.seed));
+  std::memcpy(header + 24, &checksum, sizeof(checksum));
+
+  std::FILE *file = std::fopen(path.c_str(), "wb");
+  if (file == nullptr) {
+    throw std::runtime_error("Can't open " + path + " for writing.");
+  }
+  const bool written =
+      std::fwrite(header, 1, sizeof(header), file) == sizeof(header) and
+      std::fwrite(payload.data(), 1, payload.size(), file) == payload.size();
+  if (std::fclose(file) != 0 or !written) {
+    throw std::runtime_error("Failed to write the preflop table.");
+  }
+}
+
+/* Read only, memory mapped view of a preflop table file. */
+export class PreflopTable {
+private:
+  const unsigned char *data = nullptr;
+  std::size_t bytes = 0;
+  const float *headsUpEntries = nullptr;
+  const float *versusRandomEntries = nullptr;
+  std::uint32_t sampleCount = 0;
+  std::uint64_t tableSeed = 0;
+
+  [[noreturn]] void fail(const std::string &message) {
+    if (data != nullptr) {
+      munmap(const_cast<unsigned char *>(data), bytes);
+    }
+    throw std::runtime_error(message);
+  }
+
+  void validate() {
+    if (bytes < TABLE_HEADER_BYTES or
+        std::memcmp(data, TABLE_MAGIC.data(), TABLE_MAGIC.size()) != 0) {
+      fail("Not a preflop table.");
+    }
+    std::uint16_t version;
+    std::uint16_t hands;
+    std::uint16_t players;
+    std::uint32_t checksum;
+    std::memcpy(&version, data + 4, sizeof(version));
+    std::memcpy(&hands, data + 6, sizeof(hands));
+    std::memcpy(&players, data + 8, sizeof(players));
+    std::memcpy(&sampleCount, data + 12, sizeof(sampleCount));
+    std::memcpy(&tableSeed, data + 16, sizeof(tableSeed));
+    std::memcpy(&checksum, data + 24, sizeof(checksum));
+    if (version != PREFLOP_TABLE_VERSION or hands != STARTING_HANDS or
+        players != MAX_TABLE_PLAYERS) {
+      fail("Unsupported preflop table version.");
+    }
+    if (bytes != TABLE_HEADER_BYTES + TABLE_PAYLOAD_BYTES) {
+      fail("Preflop table has the wrong size.");
+    }
+    if (fnv1a(data + TABLE_HEADER_BYTES, TABLE_PAYLOAD_BYTES) != checksum) {
+      fail("Preflop table is corrupt.");
+    }
+    // The mapping is page aligned and the header 32 bytes, so the floats
+    // are aligned.
+    headsUpEntries = reinterpret_cast<const float *>(data + TABLE_HEADER_BYTES);
+    versusRandomEntries = headsUpEntries + HEADS_UP_ENTRIES;
+  }
+
+public:
+  explicit PreflopTable(const std::string &path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw std::runtime_error("Can't open " + path + ".");
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+      close(fd);
+      throw std::runtime_error("Can't read " + path + ".");
+    }
+    bytes = static_cast<std::size_t>(info.st_size);
+    if (bytes > 0) {
+      void *mapped = mmap(nullptr, bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (mapped == MAP_FAILED) {
+        close(fd);
+        throw std::runtime_error("Can't map " + path + ".");
+      }
+      data = static_cast<const unsigned char *>(mapped);
+    }
+    close(fd);
+    validate();
+  }
+
+  ~PreflopTable() {
+    if (data != nullptr) {
+      munmap(const_cast<unsigned char *>(data), bytes);
+    }
+  }
+
+  PreflopTable(const PreflopTable &) = delete;
+  PreflopTable &operator=(const PreflopTable &) = delete;
+
+  std::uint32_t samples() const { return sampleCount; }
+  std::uint64_t seed() const { return tableSeed; }
+
+  /* Share of the pot hero wins all-in preflop against villain, both
+   * starting hands in [0, 169).
+   */
+  float headsUp(int hero, int villain) const {
+    return headsUpEntries[hero * STARTING_HANDS + villain];
+  }
+
+  /* Share of the pot hand wins all-in preflop against players - 1 random
+   * hands, players in [2, 6].
+   */
+  float versusRandom(int hand, int players) const {
+    return versusRandomEntries[hand * TABLE_PLAYER_COUNTS + players -
+                               MIN_TABLE_PLAYERS];
+  }
+
+  float versusRandom(Card first, Card second, int players) const {
+    return versusRandom(startingHand(first, second), players);
+  }
+};
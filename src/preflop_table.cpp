@@ -0,0 +1,49 @@
+/* Generates the preflop equity table and writes it to a file PreflopTable
+ * can map.
+ * Usage: preflop_table <output file> [samples per entry] [seed] [threads]
+ * With the default 20000 samples per entry an equity is off by about 0.3%
+ * (one standard error).
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <thread>
+import threadPool;
+import preflopTable;
+
+int main(int argc, char **argv) {
+  if (argc < 2) {
+    std::cerr << "Usage: " << argv[0]
+              << " <output file> [samples per entry] [seed] [threads]"
+              << std::endl;
+    return 1;
+  }
+  const std::uint32_t samples =
+      argc > 2 ? static_cast<std::uint32_t>(std::strtoul(argv[2], nullptr, 10))
+               : 20000;
+  const std::uint64_t seed = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : 1;
+  ThreadPool pool(argc > 4 ? std::strtoull(argv[4], nullptr, 10)
+                           : std::thread::hardware_concurrency());
+
+  try {
+    auto start = std::chrono::steady_clock::now();
+    PreflopTableData table = generatePreflopTable(pool, samples, seed);
+    auto stop = std::chrono::steady_clock::now();
+    writePreflopTable(argv[1], table);
+
+    PreflopTable check(argv[1]);
+    std::cout << "Wrote " << argv[1] << " with " << samples
+              << " samples per entry in "
+              << std::chrono::duration<double>(stop - start).count()
+              << " s\n";
+    std::cout << "AA vs KK: " << check.headsUp(12 * 13 + 12, 11 * 13 + 11)
+              << ", AA against 1 random hand: "
+              << check.versusRandom(12 * 13 + 12, 2) << std::endl;
+  } catch (const std::exception &error) {
+    std::cerr << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
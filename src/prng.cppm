@@ -0,0 +1,129 @@
+/* This file implements small and fast pseudo random number generators. All of
+ * them satisfy UniformRandomBitGenerator, so they can be used with the
+ * standard library as well as with Deck.
+ * SplitMix64: 64-bit state, mostly used to expand one seed into the state of
+ * the other generators.
+ * Xoshiro256: xoshiro256**, 256-bit state, the default generator of the
+ * engine. Seeded with (seed, stream) so every thread can get its own stream.
+ * Pcg32: PCG-XSH-RR with 64-bit state and 32-bit output.
+ * uniformBelow: maps one output of any of them onto [0, bound) with a single
+ * multiplication instead of a division.
+ */
+module;
+#include <bit>
+#include <cstdint>
+#include <limits>
+
+export module prng;
+
+export class SplitMix64 {
+private:
+  std::uint64_t state;
+
+public:
+  using result_type = std::uint64_t;
+
+  explicit constexpr SplitMix64(std::uint64_t seed = 0) : state(seed) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr result_type operator()() {
+    std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+  }
+};
+
+export class Xoshiro256 {
+private:
+  std::uint64_t s[4];
+
+public:
+  using result_type = std::uint64_t;
+
+  /* Different streams of the same seed start from unrelated states. */
+  explicit constexpr Xoshiro256(std::uint64_t seed = 0,
+                                std::uint64_t stream = 0)
+      : s{} {
+    SplitMix64 expand(seed ^ (stream * 0xD1B54A32D192ED03ull));
+    for (auto &word : s) {
+      word = expand();
+    }
+  }
+
+  // Starts from an explicit state, used to check the reference output.
+  static constexpr Xoshiro256 fromState(std::uint64_t a, std::uint64_t b,
+                                        std::uint64_t c, std::uint64_t d) {
+    Xoshiro256 generator;
+    generator.s[0] = a;
+    generator.s[1] = b;
+    generator.s[2] = c;
+    generator.s[3] = d;
+    return generator;
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr result_type operator()() {
+    const std::uint64_t result = std::rotl(s[1] * 5, 7) * 9;
+    const std::uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = std::rotl(s[3], 45);
+    return result;
+  }
+};
+
+export class Pcg32 {
+private:
+  std::uint64_t state;
+  std::uint64_t increment;
+
+public:
+  using result_type = std::uint32_t;
+
+  explicit constexpr Pcg32(std::uint64_t seed = 0, std::uint64_t stream = 0)
+      : state(0), increment((stream << 1) | 1) {
+    (*this)();
+    state += seed;
+    (*this)();
+  }
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() {
+    return std::numeric_limits<result_type>::max();
+  }
+
+  constexpr result_type operator()() {
+    std::uint64_t old = state;
+    state = old * 6364136223846793005ull + increment;
+    auto xorShifted = static_cast<std::uint32_t>(((old >> 18) ^ old) >> 27);
+    auto rotation = static_cast<int>(old >> 59);
+    return std::rotr(xorShifted, rotation);
+  }
+};
+
+/* Returns a number in [0, bound) from the top 32 bits of one output. The
+ * bias is below bound / 2^32, which is invisible for card dealing.
+ */
+export template <typename Generator>
+constexpr std::uint32_t uniformBelow(Generator &g, std::uint32_t bound) {
+  static_assert(Generator::min() == 0, "Generator has to start at 0");
+  constexpr int bits = std::bit_width(
+      static_cast<std::uint64_t>(Generator::max()));
+  static_assert(bits >= 32, "Generator has to produce at least 32 bits");
+  auto top = static_cast<std::uint64_t>(
+      static_cast<std::uint32_t>(static_cast<std::uint64_t>(g()) >>
+                                 (bits - 32)));
+  return static_cast<std::uint32_t>((top * bound) >> 32);
+}
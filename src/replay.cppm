@@ -0,0 +1,287 @@
+/* This file implements recording and deterministic replay of hands.
+ * A hand is fully decided by the seed of the game (which cards get dealt) and
+ * the actions the players took, so that is all a HandRecord keeps next to
+ * the table setup.
+ * recordHand: Plays a hand and captures every action passed to performAction.
+ * replayHand: Plays a recorded hand again in a HeadlessGame, every seat
+ * answers with the next recorded action. Throws ReplayMismatch as soon as the
+ * game asks a different seat, wants more actions than were recorded or ends
+ * with other stacks than the recording.
+ * ReplayWriter / ReplayReader: A compact binary log of HandRecords.
+ *    -The log starts with the magic "PKRP" and a version byte.
+ *    -Numbers are stored as LEB128 varints, the seed as 8 little endian bytes.
+ *    -An action takes one byte for seat and action plus a varint for the bet,
+ * a typical hand is well below 100 bytes.
+ */
+module;
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+export module replay;
+import player;
+import game;
+
+export constexpr std::uint8_t REPLAY_LOG_VERSION = 1;
+export constexpr std::size_t MAX_REPLAY_SEATS = 32;
+export constexpr std::size_t MAX_REPLAY_ACTIONS = 1 << 16;
+
+export struct RecordedAction {
+  position seat;
+  actions action;
+  money bet;
+};
+
+export struct HandRecord {
+  std::uint64_t seed = 0;
+  money minBet = 0;
+  positions pos;
+  std::uint32_t activeSeats = 0; // bit i is set when seat i plays the hand
+  std::vector<money> startStacks;
+  std::vector<RecordedAction> actions;
+  std::vector<money> endStacks;
+};
+
+/* Thrown when a replay doesn't play out like the recording. */
+export class ReplayMismatch : public std::runtime_error {
+public:
+  using std::runtime_error::runtime_error;
+};
+
+namespace {
+
+constexpr std::array<char, 4> REPLAY_MAGIC = {'P', 'K', 'R', 'P'};
+
+void writeVarint(std::ostream &out, std::uint64_t value) {
+  while (value >= 0x80) {
+    out.put(static_cast<char>((value & 0x7F) | 0x80));
+    value >>= 7;
+  }
+  out.put(static_cast<char>(value));
+}
+
+std::uint8_t readByte(std::istream &in) {
+  int byte = in.get();
+  if (byte == std::char_traits<char>::eof()) {
+    throw std::runtime_error("Replay log ends in the middle of a hand.");
+  }
+  return static_cast<std::uint8_t>(byte);
+}
+
+std::uint64_t readVarint(std::istream &in) {
+  std::uint64_t value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    std::uint8_t byte = readByte(in);
+    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+  throw std::runtime_error("Replay log holds an invalid number.");
+}
+
+} // namespace
+
+// Not in the anonymous namespace, recordHand is instantiated outside of it.
+std::vector<money> stacksOf(const playersPool &players) {
+  std::vector<money> stacks;
+  stacks.reserve(players.size());
+  for (const auto &player : players) {
+    stacks.push_back(player->getChips());
+  }
+  return stacks;
+}
+
+/* Plays one hand of game and returns its recording. The game has to be
+ * freshly constructed or readied with newHand, its action listener is taken
+ * over for the hand.
+ */
+export template <typename IO, typename Source>
+HandRecord recordHand(BasicGame<IO, Source> &game) {
+  const playersPool &players = game.getPlayers();
+  if (players.size() > MAX_REPLAY_SEATS) {
+    throw std::invalid_argument("Too many seats to record.");
+  }
+
+  HandRecord record;
+  record.seed = game.getSeed();
+  record.minBet = game.getSettings().minBet;
+  record.pos = game.getPositions();
+  for (std::size_t seat = 0; seat < players.size(); seat++) {
+    if (players[seat]->getIsActive()) {
+      record.activeSeats |= std::uint32_t{1} << seat;
+    }
+  }
+  record.startStacks = stacksOf(players);
+
+  game.setActionListener([&record](position seat, const Action &action) {
+    record.actions.push_back({seat, action.action, action.bet});
+  });
+  game.simulateHand();
+  game.setActionListener(nullptr);
+
+  record.endStacks = stacksOf(players);
+  return record;
+}
+
+/* Plays record again without a console. Returns the stacks after the hand,
+ * which equal record.endStacks, or throws ReplayMismatch.
+ */
+export std::vector<money> replayHand(const HandRecord &record) {
+  gameSettings settings;
+  settings.minBet = record.minBet;
+
+  playersPool players;
+  for (std::size_t seat = 0; seat < record.startStacks.size(); seat++) {
+    auto player = std::make_shared<Player>("Seat " + std::to_string(seat),
+                                           record.startStacks[seat]);
+    player->setIsActive((record.activeSeats >> seat) & 1);
+    players.push_back(std::move(player));
+  }
+
+  HeadlessGame game(players, settings, record.pos, record.seed);
+  std::size_t next = 0;
+  strategy scripted = [&record, &next](const turnInfo &info) {
+    if (next == record.actions.size()) {
+      throw ReplayMismatch("Replay asks for more actions than recorded.");
+    }
+    const RecordedAction &recorded = record.actions[next++];
+    if (recorded.seat != info.seat) {
+      throw ReplayMismatch("Replay asks seat " + std::to_string(info.seat) +
+                           " to act, the recording has seat " +
+                           std::to_string(recorded.seat) + ".");
+    }
+    return Action{recorded.action, recorded.bet, info.currentRound};
+  };
+  for (std::size_t seat = 0; seat < players.size(); seat++) {
+    game.setStrategy(static_cast<position>(seat), scripted);
+  }
+  game.simulateHand();
+
+  if (next != record.actions.size()) {
+    throw ReplayMismatch("Replay ended before every recorded action was used.");
+  }
+  std::vector<money> stacks = stacksOf(players);
+  if (!record.endStacks.empty() and stacks != record.endStacks) {
+    throw ReplayMismatch("Replay ended with different stacks.");
+  }
+  return stacks;
+}
+
+/* Appends hands to a binary replay log. */
+export class ReplayWriter {
+private:
+  std::ostream &out;
+
+public:
+  explicit ReplayWriter(std::ostream &out) : out(out) {
+    out.write(REPLAY_MAGIC.data(), REPLAY_MAGIC.size());
+    out.put(static_cast<char>(REPLAY_LOG_VERSION));
+  }
+
+  void write(const HandRecord &record) {
+    if (record.startStacks.size() > MAX_REPLAY_SEATS or
+        record.endStacks.size() > record.startStacks.size()) {
+      throw std::invalid_argument("Hand record has an invalid amount of "
+                                  "seats.");
+    }
+    for (int i = 0; i < 8; i++) {
+      out.put(static_cast<char>(record.seed >> (8 * i)));
+    }
+    writeVarint(out, record.minBet);
+    out.put(static_cast<char>(record.startStacks.size()));
+    out.put(static_cast<char>(record.pos.dealerPosition));
+    out.put(static_cast<char>(record.pos.posSB));
+    out.put(static_cast<char>(record.pos.posBB));
+    writeVarint(out, record.activeSeats);
+    for (money stack : record.startStacks) {
+      writeVarint(out, stack);
+    }
+
+    writeVarint(out, record.actions.size());
+    for (const auto &recorded : record.actions) {
+      // 5 bits of seat, 3 bits of action.
+      out.put(static_cast<char>((recorded.seat << 3) |
+                                static_cast<int>(recorded.action)));
+      writeVarint(out, recorded.bet);
+    }
+
+    out.put(static_cast<char>(!record.endStacks.empty()));
+    for (money stack : record.endStacks) {
+      writeVarint(out, stack);
+    }
+    if (!out) {
+      throw std::runtime_error("Failed to write the replay log.");
+    }
+  }
+};
+
+/* Reads the hands of a binary replay log in the order they were written. */
+export class ReplayReader {
+private:
+  std::istream &in;
+
+public:
+  explicit ReplayReader(std::istream &in) : in(in) {
+    std::array<char, 4> magic{};
+    in.read(magic.data(), magic.size());
+    if (!in or magic != REPLAY_MAGIC) {
+      throw std::runtime_error("Not a replay log.");
+    }
+    if (readByte(in) != REPLAY_LOG_VERSION) {
+      throw std::runtime_error("Unsupported replay log version.");
+    }
+  }
+
+  /* Reads the next hand into record. Returns false at the end of the log.
+   */
+  bool next(HandRecord &record) {
+    if (in.peek() == std::char_traits<char>::eof()) {
+      return false;
+    }
+    record.seed = 0;
+    for (int i = 0; i < 8; i++) {
+      record.seed |= static_cast<std::uint64_t>(readByte(in)) << (8 * i);
+    }
+    record.minBet = static_cast<money>(readVarint(in));
+    std::size_t seats = readByte(in);
+    if (seats > MAX_REPLAY_SEATS) {
+      throw std::runtime_error("Replay log holds too many seats.");
+    }
+    record.pos.dealerPosition = readByte(in);
+    record.pos.posSB = readByte(in);
+    record.pos.posBB = readByte(in);
+    record.activeSeats = static_cast<std::uint32_t>(readVarint(in));
+    record.startStacks.resize(seats);
+    for (money &stack : record.startStacks) {
+      stack = static_cast<money>(readVarint(in));
+    }
+
+    std::uint64_t actionCount = readVarint(in);
+    if (actionCount > MAX_REPLAY_ACTIONS) {
+      throw std::runtime_error("Replay log holds too many actions.");
+    }
+    record.actions.resize(actionCount);
+    for (auto &recorded : record.actions) {
+      std::uint8_t packed = readByte(in);
+      if ((packed & 7) > static_cast<int>(actions::bet)) {
+        throw std::runtime_error("Replay log holds an unknown action.");
+      }
+      recorded.seat = packed >> 3;
+      recorded.action = static_cast<actions>(packed & 7);
+      recorded.bet = static_cast<money>(readVarint(in));
+    }
+
+    record.endStacks.resize(readByte(in) ? seats : 0);
+    for (money &stack : record.endStacks) {
+      stack = static_cast<money>(readVarint(in));
+    }
+    return true;
+  }
+};
@@ -0,0 +1,253 @@
+/* This file implements a cheap rule based bot for simulating many hands.
+ * RuleBot: Decides from hand strength, pot odds and position with a handful
+ * of table lookups, no sampling and no allocation per decision.
+ *    -Hand strength preflop is the equity of the starting hand against the
+ * other players still in the hand, from a PreflopTable or sampled once when
+ * the bot is made.
+ *    -Postflop it is the share of random hands of as many cards that the hand
+ * of the player beats (a table over the 7462 hand values per street, sampled
+ * once), to the power of the amount of opponents. The share is counted from
+ * what the board alone is worth (boardFloor), so a hand that only plays the
+ * board is worth nothing and a board nobody can beat is a split.
+ *    -Position adds up to settings.positionBonus to the equity of the dealer
+ * and takes as much from the first seat after the dealer, the seats in
+ * between get their share.
+ *    -With at least settings.valueShare times its fair share of the pot (1
+ * over the players in the hand) it bets half the pot or raises the pot.
+ * Otherwise it calls when the equity beats the pot odds and checks or folds
+ * when it doesn't.
+ * ruleStrategy: A strategy for a game that asks a bot. A bot never changes
+ * after it is made, so one bot can serve every seat of every thread.
+ */
+module;
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <span>
+#include <vector>
+
+export module ruleBot;
+import cards;
+import bestHand;
+import game;
+import prng;
+import preflopTable;
+
+export constexpr int HAND_VALUE_CLASSES = 7462;
+
+export struct RuleBotSettings {
+  float valueShare = 1.6f;     // Fair shares of the pot to bet or raise with.
+  float callMargin = 0.02f;    // Equity needed above the pot odds to call.
+  float positionBonus = 0.04f; // Equity of the dealer position.
+  std::uint32_t strengthSamples = 1 << 18; // Hands per street table.
+  std::uint64_t seed = 1;
+};
+
+export class RuleBot {
+private:
+  using StrengthTable = std::array<float, HAND_VALUE_CLASSES + 1>;
+
+  RuleBotSettings settings;
+  // versusRandom[hand * 5 + players - 2] of a PreflopTable.
+  std::array<float, STARTING_HANDS * TABLE_PLAYER_COUNTS> preflop{};
+  // strength[board cards - 3][value]: share of random hands below value.
+  std::array<StrengthTable, 3> strength{};
+
+  /* Sorts settings.strengthSamples random hands of board + 2 cards by value,
+   * ties count half.
+   */
+  void sampleStrength(Xoshiro256 &rng) {
+    for (int board = 3; board <= 5; board++) {
+      std::vector<std::uint32_t> counts(HAND_VALUE_CLASSES + 1, 0);
+      Deck deck;
+      for (std::uint32_t s = 0; s < settings.strengthSamples; s++) {
+        deck.resetDeck();
+        std::array<Card, 7> cards;
+        for (int i = 0; i < board + 2; i++) {
+          cards[i] = deck.dealCard(rng);
+        }
+        counts[evaluateHand(cards.data(), board + 2)]++;
+      }
+      StrengthTable &table = strength[board - 3];
+      double below = 0;
+      for (int value = 0; value <= HAND_VALUE_CLASSES; value++) {
+        table[value] = static_cast<float>(
+            (below + counts[value] / 2.0) / settings.strengthSamples);
+        below += counts[value];
+      }
+    }
+  }
+
+  /* The least any hand on board is worth: the board filled up to five cards
+   * with the lowest ranks that neither pair it, make a flush nor a straight.
+   * A flush only counts when the board holds one, most hands on a board with
+   * four cards of a suit don't hold a fifth. One to a few evaluations.
+   */
+  static HandValue boardFloor(std::span<const Card> board) {
+    std::array<Card, 7> cards;
+    std::copy(board.begin(), board.end(), cards.begin());
+    const std::size_t count = board.size();
+    std::array<int, 4> suits{};
+    std::uint32_t ranks = 0;
+    for (Card card : board) {
+      suits[static_cast<int>(card.getSuit())]++;
+      ranks |= 1u << static_cast<int>(card.getRank());
+    }
+    if (count == 5) {
+      return evaluateHand(cards.data(), count);
+    }
+    HandValue lowest = std::numeric_limits<HandValue>::max();
+
+    // Ranks not on the board, in the suit with the fewest board cards.
+    const Suit padSuit = static_cast<Suit>(
+        std::min_element(suits.begin(), suits.end()) - suits.begin());
+    std::array<Card, 13> pads;
+    int padCount = 0;
+    for (int rank = 2; rank <= 14; rank++) {
+      if (!(ranks >> rank & 1)) {
+        pads[padCount++] = Card(padSuit, static_cast<Rank>(rank));
+      }
+    }
+    // Lower pads leave a lower hand, the first one without a straight is it.
+    auto padsWithoutStraight = [&]() {
+      const HandValue value = evaluateHand(cards.data(), 5);
+      lowest = std::min(lowest, value);
+      return categoryOf(value) != HandCategory::Straight;
+    };
+    for (int high = 0; high < padCount; high++) {
+      cards[count] = pads[high];
+      if (count == 4 and padsWithoutStraight()) {
+        return lowest;
+      }
+      for (int low = 0; count == 3 and low < high; low++) {
+        cards[4] = pads[low];
+        if (padsWithoutStraight()) {
+          return lowest;
+        }
+      }
+    }
+    return lowest;
+  }
+
+  static int preflopPlayers(int playersInHand) {
+    return std::clamp(playersInHand, MIN_TABLE_PLAYERS, MAX_TABLE_PLAYERS);
+  }
+
+public:
+  /* Takes the preflop equities from table. */
+  explicit RuleBot(const PreflopTable &table,
+                   const RuleBotSettings &settings = {})
+      : settings(settings) {
+    for (int hand = 0; hand < STARTING_HANDS; hand++) {
+      for (int players = MIN_TABLE_PLAYERS; players <= MAX_TABLE_PLAYERS;
+           players++) {
+        preflop[hand * TABLE_PLAYER_COUNTS + players - MIN_TABLE_PLAYERS] =
+            table.versusRandom(hand, players);
+      }
+    }
+    Xoshiro256 rng(settings.seed);
+    sampleStrength(rng);
+  }
+
+  /* Samples the preflop equities itself, preflopSamples per entry (a few
+   * percent off with the default, enough for a bot).
+   */
+  explicit RuleBot(const RuleBotSettings &settings = {},
+                   std::uint32_t preflopSamples = 400)
+      : settings(settings) {
+    Xoshiro256 rng(settings.seed);
+    for (int hand = 0; hand < STARTING_HANDS; hand++) {
+      for (int players = MIN_TABLE_PLAYERS; players <= MAX_TABLE_PLAYERS;
+           players++) {
+        preflop[hand * TABLE_PLAYER_COUNTS + players - MIN_TABLE_PLAYERS] =
+            static_cast<float>(
+                sampleVersusRandom(hand, players, preflopSamples, rng));
+      }
+    }
+    sampleStrength(rng);
+  }
+
+  /* The share of the pot the hand of the player is worth against the
+   * others in the hand, before position.
+   */
+  float equity(const std::vector<Card> &hand, std::span<const Card> board,
+               int playersInHand) const {
+    if (board.size() < 3) {
+      return preflop[startingHand(hand[0], hand[1]) * TABLE_PLAYER_COUNTS +
+                     preflopPlayers(playersInHand) - MIN_TABLE_PLAYERS];
+    }
+    std::array<Card, 7> cards;
+    std::copy(board.begin(), board.end(), cards.begin());
+    cards[board.size()] = hand[0];
+    cards[board.size() + 1] = hand[1];
+    const StrengthTable &table = strength[board.size() - 3];
+    const float boardBeats = table[boardFloor(board)];
+    if (1 - boardBeats < 1e-4f) {
+      // Nothing beats the board, everyone splits.
+      return 1.0f / static_cast<float>(std::max(playersInHand, 1));
+    }
+    const float beats = std::clamp(
+        (table[evaluateHand(cards.data(), board.size() + 2)] - boardBeats) /
+            (1 - boardBeats),
+        0.0f, 1.0f);
+    float share = 1;
+    for (int opponent = 1; opponent < playersInHand; opponent++) {
+      share *= beats;
+    }
+    return share;
+  }
+
+  Action decide(const turnInfo &info) const {
+    const LegalMoves &moves = info.validMoves;
+    const int players = std::max(info.playersInHand, 2);
+
+    // 0 for the first seat after the dealer up to 1 for the dealer.
+    const int afterDealer =
+        (info.seat - info.gamePositions.dealerPosition - 1 + info.seats) %
+        info.seats;
+    const float lateness =
+        info.seats > 1 ? static_cast<float>(afterDealer) / (info.seats - 1)
+                       : 1.0f;
+    const float value =
+        equity(info.player.getHand(), info.communityCards, players) +
+        settings.positionBonus * (2 * lateness - 1);
+
+    const money alreadyBet = info.player.getCurrentBet();
+    const money toCall =
+        info.highestBet > alreadyBet ? info.highestBet - alreadyBet : 0;
+    const bool strong = value * static_cast<float>(players) >=
+                        settings.valueShare;
+
+    auto play = [&](actions act, money amount) {
+      amount = std::clamp(amount, moves.minAmount(act), moves.maxAmount(act));
+      return Action{act, amount, info.currentRound};
+    };
+
+    if (moves.isLegal(actions::check)) {
+      if (strong and moves.isLegal(actions::bet)) {
+        return play(actions::bet, info.pot / 2);
+      }
+      return play(actions::check, 0);
+    }
+    if (strong and moves.isLegal(actions::raise)) {
+      return play(actions::raise, info.highestBet * 2 + info.pot - alreadyBet);
+    }
+    const float potOdds =
+        static_cast<float>(toCall) / static_cast<float>(info.pot + toCall);
+    if (value >= potOdds + settings.callMargin) {
+      if (moves.isLegal(actions::call)) {
+        return play(actions::call, info.highestBet);
+      }
+      // Not enough chips to call, all in is the only way to stay in.
+      return play(actions::allIn, 0);
+    }
+    return play(actions::fold, 0);
+  }
+};
+
+export strategy ruleStrategy(std::shared_ptr<const RuleBot> bot) {
+  return [bot](const turnInfo &info) { return bot->decide(info); };
+}
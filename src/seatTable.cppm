@@ -0,0 +1,164 @@
+/* This file implements the table state the game loop works on during a hand.
+ * SeatTable: Chips, current bets, what every seat committed to the pot this
+ * hand and blinds as flat arrays indexed by seat, the active and folded flags
+ * as one bit per seat.
+ *    -load copies the Players in at the start of a hand, store writes chips,
+ * bets and folds back into them.
+ *    -activeCount, inHandCount and nextInHand are a popcount or a count
+ * trailing zeros on the masks instead of a walk over the players.
+ *    -bet, raise and call follow the rules of the Player methods with the
+ * same name.
+ */
+module;
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <stdexcept>
+
+export module seatTable;
+import player;
+
+export constexpr int MAX_SEATS = 32;
+export using seatMask = std::uint32_t;
+
+export class SeatTable {
+private:
+  using money = std::uint32_t;
+
+  std::array<money, MAX_SEATS> chips{};
+  std::array<money, MAX_SEATS> currentBet{};
+  std::array<money, MAX_SEATS> committed{};
+  std::array<Blind, MAX_SEATS> blind{};
+  seatMask active = 0;
+  seatMask folded = 0;
+  int seats = 0;
+
+  static constexpr seatMask bit(int seat) { return seatMask{1} << seat; }
+
+public:
+  /* Copies the state of every player in, seat i is players[i]. */
+  void load(const std::deque<std::shared_ptr<Player>> &players) {
+    if (players.size() > MAX_SEATS) {
+      throw std::invalid_argument("A table has at most 32 seats.");
+    }
+    seats = static_cast<int>(players.size());
+    active = 0;
+    folded = 0;
+    for (int seat = 0; seat < seats; seat++) {
+      const Player &player = *players[seat];
+      chips[seat] = player.getChips();
+      currentBet[seat] = player.getCurrentBet();
+      committed[seat] = 0;
+      blind[seat] = player.getBlind();
+      active |= player.getIsActive() ? bit(seat) : 0;
+      folded |= player.hasPlayerFolded() ? bit(seat) : 0;
+    }
+  }
+
+  // Writes chips, current bet and folded of seat back into player.
+  void store(int seat, Player &player) const {
+    player.setChips(chips[seat]);
+    player.setCurrentBet(currentBet[seat]);
+    player.setHasFolded(hasFolded(seat));
+  }
+
+  void store(const std::deque<std::shared_ptr<Player>> &players) const {
+    for (int seat = 0; seat < seats; seat++) {
+      store(seat, *players[seat]);
+    }
+  }
+
+  int size() const { return seats; }
+  money chipsOf(int seat) const { return chips[seat]; }
+  money betOf(int seat) const { return currentBet[seat]; }
+  // Everything seat put in the pot this hand, over all streets.
+  money committedOf(int seat) const { return committed[seat]; }
+  Blind blindOf(int seat) const { return blind[seat]; }
+  bool isActive(int seat) const { return active & bit(seat); }
+  bool hasFolded(int seat) const { return folded & bit(seat); }
+
+  seatMask activeSeats() const { return active; }
+  // Active players who haven't folded.
+  seatMask inHandSeats() const { return active & ~folded; }
+  int activeCount() const { return std::popcount(active); }
+  int inHandCount() const { return std::popcount(inHandSeats()); }
+
+  /* The first seat still in the hand at or after start, going round the
+   * table. -1 when nobody is left.
+   */
+  int firstInHandFrom(int start) const {
+    const seatMask inHand = inHandSeats();
+    const seatMask fromStart = inHand & (~seatMask{0} << start);
+    if (fromStart != 0) {
+      return std::countr_zero(fromStart);
+    }
+    return inHand != 0 ? std::countr_zero(inHand) : -1;
+  }
+
+  /* The next seat after seat still in the hand, seat itself when it's the
+   * only one.
+   */
+  int nextInHand(int seat) const {
+    return firstInHandFrom((seat + 1) % seats);
+  }
+
+  /* Overwrites the hand of seat, used to continue a hand from a snapshot
+   * after load.
+   */
+  void restore(int seat, money chipsLeft, money bet, money committedChips,
+               bool seatActive, bool seatFolded) {
+    chips[seat] = chipsLeft;
+    currentBet[seat] = bet;
+    committed[seat] = committedChips;
+    active = (active & ~bit(seat)) | (seatActive ? bit(seat) : 0);
+    folded = (folded & ~bit(seat)) | (seatFolded ? bit(seat) : 0);
+  }
+
+  void fold(int seat) { folded |= bit(seat); }
+  void addChips(int seat, money amount) { chips[seat] += amount; }
+
+  money bet(int seat, money amount) {
+    if (amount > chips[seat]) {
+      throw std::invalid_argument("Bet amount exceeds available chips");
+    }
+    chips[seat] -= amount;
+    currentBet[seat] += amount;
+    committed[seat] += amount;
+    return amount;
+  }
+
+  // Raises the bet of seat to totalRaise, returns the extra chips paid.
+  money raise(int seat, money totalRaise) {
+    money diff = totalRaise - currentBet[seat];
+    if (diff > chips[seat]) {
+      throw std::invalid_argument("Not enough chips to raise by that amount.");
+    }
+    chips[seat] -= diff;
+    currentBet[seat] = totalRaise;
+    committed[seat] += diff;
+    return diff;
+  }
+
+  // Matches target, or puts in all chips when that isn't enough.
+  money call(int seat, money target) {
+    money toCall = target > currentBet[seat] ? target - currentBet[seat] : 0;
+    if (toCall > chips[seat]) {
+      toCall = chips[seat];
+    }
+    chips[seat] -= toCall;
+    currentBet[seat] += toCall;
+    committed[seat] += toCall;
+    return toCall;
+  }
+
+  void resetBets() { currentBet.fill(0); }
+
+  void resetHand() {
+    resetBets();
+    committed.fill(0);
+    folded = 0;
+  }
+};
@@ -0,0 +1,155 @@
+/* This file implements splitting the pot of a hand into a main pot and side
+ * pots and paying them out.
+ * Pot: An amount of chips and the seats that can win it.
+ * SidePots: Built from what every seat committed to the hand (SeatTable keeps
+ * that per street and per hand).
+ *    -build and settle take any table with the SeatTable methods size,
+ * committedOf, inHandSeats and addChips, the GameState of the game module
+ * settles its hands with them too.
+ *    -build sorts the seats by contribution (at most 32, insertion sort) and
+ * sweeps over them once. Every distinct contribution of a seat still in the
+ * hand closes a pot, chips of folded seats end up in the pots their
+ * contribution reaches.
+ *    -settle pays the pots from the last side pot down to the main pot. The
+ * seats that can win a pot only grow in that direction, so the best hand is
+ * kept up to date by looking at every seat once.
+ *    -A split pot gives every winner the same share, the odd chips go one at
+ * a time to the winners closest to the left of the button.
+ * Nothing allocates, all state lives in fixed size arrays.
+ */
+module;
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+export module sidePots;
+import seatTable;
+import bestHand;
+
+export struct Pot {
+  std::uint32_t total;
+  seatMask contributors; // Seats still in the hand that can win this pot.
+};
+
+export class SidePots {
+private:
+  using money = std::uint32_t;
+
+  std::array<Pot, MAX_SEATS> pots{};
+  int count = 0;
+
+  static constexpr seatMask bit(int seat) { return seatMask{1} << seat; }
+
+  /* Splits amount evenly over winners, the remainder goes chip by chip
+   * round the table starting at seat start.
+   */
+  template <typename Table>
+  static void pay(Table &seats, money amount, seatMask winners, int start) {
+    const money share = amount / static_cast<money>(std::popcount(winners));
+    money oddChips = amount % static_cast<money>(std::popcount(winners));
+    for (seatMask left = winners; left != 0; left &= left - 1) {
+      seats.addChips(std::countr_zero(left), share);
+    }
+
+    const seatMask fromStart = winners & (~seatMask{0} << start);
+    for (seatMask order : {fromStart, winners & ~fromStart}) {
+      for (; order != 0 and oddChips > 0; order &= order - 1) {
+        seats.addChips(std::countr_zero(order), 1);
+        oddChips--;
+      }
+    }
+  }
+
+public:
+  /* Builds the pots from SeatTable::committedOf and the seats still in the
+   * hand. The pots add up to everything committed.
+   */
+  template <typename Table> void build(const Table &seats) {
+    const int n = seats.size();
+    std::array<std::uint8_t, MAX_SEATS> order;
+    for (int seat = 0; seat < n; seat++) {
+      int at = seat;
+      while (at > 0 and
+             seats.committedOf(order[at - 1]) > seats.committedOf(seat)) {
+        order[at] = order[at - 1];
+        at--;
+      }
+      order[at] = static_cast<std::uint8_t>(seat);
+    }
+
+    const seatMask inHand = seats.inHandSeats();
+    seatMask eligible = inHand;
+    money previous = 0;
+    int swept = 0; // order[0, swept) committed at most previous.
+    count = 0;
+    for (int k = 0; k < n; k++) {
+      const int seat = order[k];
+      if (!(inHand & bit(seat))) {
+        continue;
+      }
+      const money level = seats.committedOf(seat);
+      if (level > previous) {
+        money amount = 0;
+        while (swept < n and seats.committedOf(order[swept]) <= level) {
+          amount += seats.committedOf(order[swept]) - previous;
+          swept++;
+        }
+        amount += (level - previous) * static_cast<money>(n - swept);
+        pots[count++] = {amount, eligible};
+        previous = level;
+      }
+      eligible &= ~bit(seat);
+    }
+
+    // Folded seats that put in more than anyone still in the hand.
+    money rest = 0;
+    for (; swept < n; swept++) {
+      rest += seats.committedOf(order[swept]) - previous;
+    }
+    if (count > 0) {
+      pots[count - 1].total += rest;
+    } else if (rest > 0) {
+      pots[count++] = {rest, inHand};
+    }
+  }
+
+  int size() const { return count; }
+  const Pot &operator[](int index) const { return pots[index]; }
+
+  money total() const {
+    money sum = 0;
+    for (int i = 0; i < count; i++) {
+      sum += pots[i].total;
+    }
+    return sum;
+  }
+
+  /* Pays every pot to the best hand among its contributors. values holds
+   * the hand of every seat still in the hand (any value when only one seat
+   * is left), button is the dealer position.
+   */
+  template <typename Table>
+  void settle(Table &seats, const std::array<HandValue, MAX_SEATS> &values,
+              int button) const {
+    const int start = (button + 1) % seats.size();
+    HandValue best = 0;
+    seatMask winners = 0;
+    seatMask seen = 0;
+    for (int k = count - 1; k >= 0; k--) {
+      for (seatMask added = pots[k].contributors & ~seen; added != 0;
+           added &= added - 1) {
+        const int seat = std::countr_zero(added);
+        if (winners == 0 or values[seat] > best) {
+          best = values[seat];
+          winners = bit(seat);
+        } else if (values[seat] == best) {
+          winners |= bit(seat);
+        }
+      }
+      seen |= pots[k].contributors;
+      pay(seats, pots[k].total, winners, start);
+    }
+  }
+};
@@ -0,0 +1,202 @@
+/* This file implements a fixed size pool of worker threads.
+ * ThreadPool: Keeps its threads alive between jobs so short jobs don't pay
+ * for thread creation.
+ *    -size returns the amount of threads working on a job, the calling thread
+ * included.
+ *    -parallelFor runs task(i) for every i in [0, tasks). It returns once
+ * every task finished and rethrows the first exception a task threw.
+ *    -Work stealing: every thread starts with an equal slice of the indices
+ * and takes them from the front of its own slice. A thread that runs out
+ * steals the back half of the slice of another thread, so uneven tasks (like
+ * tournaments of different length) still keep every thread busy while the
+ * threads hardly ever touch the same cache line.
+ */
+module;
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+export module threadPool;
+
+export class ThreadPool {
+private:
+  /* The indices [begin, end) a thread still has to run, begin in the low and
+   * end in the high 32 bits so both change with one compare exchange. Owner
+   * and thieves both only ever shrink a slice, the owner from the front and
+   * thieves from the back.
+   */
+  struct alignas(64) Slice {
+    std::atomic<std::uint64_t> bounds{0};
+  };
+
+  static constexpr std::uint64_t pack(std::uint64_t begin, std::uint64_t end) {
+    return begin | (end << 32);
+  }
+  static constexpr std::uint32_t beginOf(std::uint64_t bounds) {
+    return static_cast<std::uint32_t>(bounds);
+  }
+  static constexpr std::uint32_t endOf(std::uint64_t bounds) {
+    return static_cast<std::uint32_t>(bounds >> 32);
+  }
+
+  std::vector<std::thread> workers;
+  std::unique_ptr<Slice[]> slices; // Slice 0 belongs to the calling thread.
+
+  std::mutex submitMutex; // One job at a time.
+  std::mutex stateMutex;
+  std::condition_variable jobStarted;
+  std::condition_variable jobFinished;
+  std::uint64_t generation = 0;
+  std::size_t busyWorkers = 0;
+  bool stopping = false;
+
+  const std::function<void(std::size_t)> *task = nullptr;
+  std::exception_ptr firstError;
+
+  // Takes the first index of the slice of thread, false when it is empty.
+  bool takeOwn(std::size_t thread, std::size_t &index) {
+    std::atomic<std::uint64_t> &bounds = slices[thread].bounds;
+    std::uint64_t current = bounds.load(std::memory_order_acquire);
+    while (beginOf(current) < endOf(current)) {
+      if (bounds.compare_exchange_weak(
+              current, pack(beginOf(current) + 1, endOf(current)),
+              std::memory_order_acq_rel)) {
+        index = beginOf(current);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /* Moves the back half of the first non empty slice after thread into the
+   * slice of thread and takes the first index of it. The stolen part is never
+   * empty, so a slice can't return to an earlier state and a compare
+   * exchange with stale bounds always fails.
+   */
+  bool steal(std::size_t thread, std::size_t &index) {
+    const std::size_t threads = size();
+    for (std::size_t offset = 1; offset < threads; offset++) {
+      std::atomic<std::uint64_t> &victim =
+          slices[(thread + offset) % threads].bounds;
+      std::uint64_t current = victim.load(std::memory_order_acquire);
+      while (beginOf(current) < endOf(current)) {
+        const std::uint32_t begin = beginOf(current);
+        const std::uint32_t end = endOf(current);
+        const std::uint32_t middle = begin + (end - begin) / 2;
+        if (victim.compare_exchange_weak(current, pack(begin, middle),
+                                         std::memory_order_acq_rel)) {
+          slices[thread].bounds.store(pack(middle + 1, end),
+                                      std::memory_order_release);
+          index = middle;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  void runTasks(std::size_t thread) {
+    std::size_t index;
+    while (takeOwn(thread, index) or steal(thread, index)) {
+      try {
+        (*task)(index);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(stateMutex);
+        if (!firstError) {
+          firstError = std::current_exception();
+        }
+      }
+    }
+  }
+
+  void workerLoop(std::size_t thread) {
+    std::uint64_t seen = 0;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        jobStarted.wait(lock,
+                        [&] { return stopping or generation != seen; });
+        if (stopping) {
+          return;
+        }
+        seen = generation;
+      }
+
+      runTasks(thread);
+
+      std::lock_guard<std::mutex> lock(stateMutex);
+      if (--busyWorkers == 0) {
+        jobFinished.notify_one();
+      }
+    }
+  }
+
+public:
+  explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency()) {
+    if (threads == 0) {
+      threads = 1;
+    }
+    slices = std::make_unique<Slice[]>(threads);
+    workers.reserve(threads - 1);
+    for (std::size_t i = 1; i < threads; i++) {
+      workers.emplace_back([this, i] { workerLoop(i); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> lock(stateMutex);
+      stopping = true;
+    }
+    jobStarted.notify_all();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+  }
+
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+
+  std::size_t size() const { return workers.size() + 1; }
+
+  void parallelFor(std::size_t tasks,
+                   const std::function<void(std::size_t)> &work) {
+    if (tasks >= std::numeric_limits<std::uint32_t>::max()) {
+      throw std::length_error("Too many tasks for one parallelFor.");
+    }
+    std::lock_guard<std::mutex> submit(submitMutex);
+    {
+      std::lock_guard<std::mutex> lock(stateMutex);
+      task = &work;
+      const std::size_t threads = size();
+      for (std::size_t thread = 0; thread < threads; thread++) {
+        slices[thread].bounds.store(pack(tasks * thread / threads,
+                                         tasks * (thread + 1) / threads),
+                                    std::memory_order_relaxed);
+      }
+      firstError = nullptr;
+      busyWorkers = workers.size();
+      generation++;
+    }
+    jobStarted.notify_all();
+
+    // The calling thread works along instead of just waiting.
+    runTasks(0);
+
+    std::unique_lock<std::mutex> lock(stateMutex);
+    jobFinished.wait(lock, [&] { return busyWorkers == 0; });
+    task = nullptr;
+    if (firstError) {
+      std::rethrow_exception(firstError);
+    }
+  }
+};
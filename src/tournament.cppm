@@ -0,0 +1,110 @@
+/* This file implements running many independent tournaments at once.
+ * Every table is a HeadlessManager that plays until settings.maximumRounds
+ * hands are played or fewer than 3 players have chips left.
+ * runTournaments: Shards the tables over a ThreadPool, its work stealing
+ * keeps every thread busy although tables take very different amounts of
+ * hands.
+ *    -Table i gets the seed tableSeed(seed, i) for its cards and its own
+ * Xoshiro256 for the strategies, so every table plays out the same no matter
+ * how many threads run or which thread picks it up.
+ *    -Tables share nothing while they play, the results are only aggregated
+ * once every table finished.
+ */
+module;
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+export module tournament;
+import player;
+import game;
+import prng;
+import threadPool;
+
+/* Builds the strategy of seat, rng belongs to the table and lives as long as
+ * its tournament. Gets called from all threads of the pool at once.
+ */
+export using strategyFactory =
+    std::function<strategy(position seat, Xoshiro256 &rng)>;
+
+export struct TableResult {
+  std::uint64_t seed = 0;
+  std::size_t hands = 0;
+  position winner = 0;       // The seat with the most chips, first on a tie.
+  std::vector<money> stacks; // Chips of every seat after the last hand.
+};
+
+export struct TournamentResults {
+  std::vector<TableResult> tables;
+  std::vector<std::size_t> wins; // Tables won, by seat.
+  std::size_t hands = 0;
+  double seconds = 0;
+
+  double tablesPerSecond() const {
+    return static_cast<double>(tables.size()) / seconds;
+  }
+  double handsPerSecond() const {
+    return static_cast<double>(hands) / seconds;
+  }
+};
+
+/* The seed of table, different tables of one seed get unrelated seeds. */
+export std::uint64_t tableSeed(std::uint64_t seed, std::size_t table) {
+  Xoshiro256 expand(seed, table);
+  return expand();
+}
+
+/* Plays one tournament on a fresh table. */
+export TableResult playTable(const gameSettings &settings, std::uint64_t seed,
+                             const strategyFactory &makeStrategy) {
+  HeadlessManager manager(settings, seed);
+  Xoshiro256 decisions(seed, 1);
+  for (position seat = 0;
+       seat < static_cast<position>(manager.players.size()); seat++) {
+    manager.setStrategy(seat, makeStrategy(seat, decisions));
+  }
+  manager.startGame();
+
+  TableResult result;
+  result.seed = seed;
+  result.hands = manager.getCurrentRound();
+  result.stacks.reserve(manager.players.size());
+  for (const auto &player : manager.players) {
+    result.stacks.push_back(player->getChips());
+  }
+  for (std::size_t seat = 1; seat < result.stacks.size(); seat++) {
+    if (result.stacks[seat] > result.stacks[result.winner]) {
+      result.winner = static_cast<position>(seat);
+    }
+  }
+  return result;
+}
+
+/* Plays tables tournaments in parallel on pool and aggregates them. */
+export TournamentResults runTournaments(ThreadPool &pool, std::size_t tables,
+                                        std::uint64_t seed,
+                                        const gameSettings &settings,
+                                        const strategyFactory &makeStrategy) {
+  TournamentResults results;
+  results.tables.resize(tables);
+
+  auto start = std::chrono::steady_clock::now();
+  pool.parallelFor(tables, [&](std::size_t table) {
+    results.tables[table] =
+        playTable(settings, tableSeed(seed, table), makeStrategy);
+  });
+  auto stop = std::chrono::steady_clock::now();
+  results.seconds = std::chrono::duration<double>(stop - start).count();
+
+  for (const auto &table : results.tables) {
+    results.hands += table.hands;
+    if (table.winner >= static_cast<position>(results.wins.size())) {
+      results.wins.resize(table.winner + 1);
+    }
+    results.wins[table.winner]++;
+  }
+  return results;
+}
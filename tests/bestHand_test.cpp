@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <array>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <vector>
+import cards;
+import player;
+import bestHand;
+
+#include <gtest/gtest.h>
+
+static Card cardAt(int index) { return Card::fromIndex(index); }
+
+// Enumerates every 5-card hand and checks the well known category counts.
+TEST(HandEvaluatorTest, FiveCardCategoryFrequencies) {
+  std::map<HandCategory, int> frequencies;
+  std::set<HandValue> distinct;
+  std::array<Card, 5> hand{cardAt(0), cardAt(0), cardAt(0), cardAt(0),
+                           cardAt(0)};
+
+  for (int a = 0; a < 52; a++)
+    for (int b = a + 1; b < 52; b++)
+      for (int c = b + 1; c < 52; c++)
+        for (int d = c + 1; d < 52; d++)
+          for (int e = d + 1; e < 52; e++) {
+            hand = {cardAt(a), cardAt(b), cardAt(c), cardAt(d), cardAt(e)};
+            HandValue value = evaluateHand(hand.data(), hand.size());
+            frequencies[categoryOf(value)]++;
+            distinct.insert(value);
+          }
+
+  EXPECT_EQ(distinct.size(), 7462u);
+  EXPECT_EQ(*distinct.begin(), 1);
+  EXPECT_EQ(*distinct.rbegin(), 7462);
+  EXPECT_EQ(frequencies[HandCategory::StraightFlush], 40);
+  EXPECT_EQ(frequencies[HandCategory::FourOfAKind], 624);
+  EXPECT_EQ(frequencies[HandCategory::FullHouse], 3744);
+  EXPECT_EQ(frequencies[HandCategory::Flush], 5108);
+  EXPECT_EQ(frequencies[HandCategory::Straight], 10200);
+  EXPECT_EQ(frequencies[HandCategory::ThreeOfAKind], 54912);
+  EXPECT_EQ(frequencies[HandCategory::TwoPair], 123552);
+  EXPECT_EQ(frequencies[HandCategory::OnePair], 1098240);
+  EXPECT_EQ(frequencies[HandCategory::HighCard], 1302540);
+}
+
+// A 7-card hand has to be worth exactly its best 5-card subset.
+TEST(HandEvaluatorTest, SevenCardsMatchBestFiveCardSubset) {
+  std::mt19937 rng(42);
+  std::vector<int> indices(52);
+  for (int i = 0; i < 52; i++) {
+    indices[i] = i;
+  }
+
+  for (int trial = 0; trial < 20000; trial++) {
+    std::shuffle(indices.begin(), indices.end(), rng);
+    std::vector<Card> seven;
+    for (int i = 0; i < 7; i++) {
+      seven.push_back(cardAt(indices[i]));
+    }
+
+    HandValue best = 0;
+    for (int skipA = 0; skipA < 7; skipA++) {
+      for (int skipB = skipA + 1; skipB < 7; skipB++) {
+        std::vector<Card> five;
+        for (int i = 0; i < 7; i++) {
+          if (i != skipA and i != skipB) {
+            five.push_back(seven[i]);
+          }
+        }
+        best = std::max(best, evaluateHand(five));
+      }
+    }
+    ASSERT_EQ(evaluateHand(seven), best);
+    ASSERT_EQ(evaluateHand(CardSet(seven)), best);
+  }
+}
+
+TEST(HandEvaluatorTest, OrdersSpecificHands) {
+  std::vector<Card> wheel = {
+      Card(Suit::Hearts, Rank::Ace), Card(Suit::Clubs, Rank::Two),
+      Card(Suit::Spades, Rank::Three), Card(Suit::Hearts, Rank::Four),
+      Card(Suit::Diamonds, Rank::Five)};
+  std::vector<Card> sixHigh = {
+      Card(Suit::Hearts, Rank::Six), Card(Suit::Clubs, Rank::Two),
+      Card(Suit::Spades, Rank::Three), Card(Suit::Hearts, Rank::Four),
+      Card(Suit::Diamonds, Rank::Five)};
+  std::vector<Card> acesWithKing = {
+      Card(Suit::Hearts, Rank::Ace), Card(Suit::Clubs, Rank::Ace),
+      Card(Suit::Spades, Rank::King), Card(Suit::Hearts, Rank::Four),
+      Card(Suit::Diamonds, Rank::Two)};
+  std::vector<Card> acesWithQueen = {
+      Card(Suit::Diamonds, Rank::Ace), Card(Suit::Spades, Rank::Ace),
+      Card(Suit::Spades, Rank::Queen), Card(Suit::Clubs, Rank::Jack),
+      Card(Suit::Diamonds, Rank::Nine)};
+
+  EXPECT_EQ(categoryOf(evaluateHand(wheel)), HandCategory::Straight);
+  EXPECT_LT(evaluateHand(wheel), evaluateHand(sixHigh));
+  EXPECT_GT(evaluateHand(acesWithKing), evaluateHand(acesWithQueen));
+  EXPECT_EQ(categoryToString(categoryOf(evaluateHand(acesWithKing))),
+            "One Pair");
+  EXPECT_THROW(evaluateHand(std::vector<Card>(wheel.begin(), wheel.end() - 1)),
+               std::invalid_argument);
+}
+
+TEST(DetermineBestHandTest, PicksStrongestActivePlayer) {
+  std::vector<Card> board = {
+      Card(Suit::Hearts, Rank::Two), Card(Suit::Hearts, Rank::Seven),
+      Card(Suit::Hearts, Rank::Nine), Card(Suit::Clubs, Rank::King),
+      Card(Suit::Spades, Rank::King)};
+
+  auto highCard = std::make_shared<Player>("High", 100);
+  highCard->receiveCards(Card(Suit::Clubs, Rank::Ace));
+  highCard->receiveCards(Card(Suit::Spades, Rank::Queen));
+
+  auto flush = std::make_shared<Player>("Flush", 100);
+  flush->receiveCards(Card(Suit::Hearts, Rank::Three));
+  flush->receiveCards(Card(Suit::Hearts, Rank::Four));
+
+  auto trips = std::make_shared<Player>("Trips", 100);
+  trips->receiveCards(Card(Suit::Diamonds, Rank::King));
+  trips->receiveCards(Card(Suit::Diamonds, Rank::Three));
+
+  std::vector<std::shared_ptr<Player>> players = {highCard, flush, trips};
+  determineBestHand calculator(players, board);
+
+  EXPECT_EQ(calculator.determineWinnerByHighestCard(), highCard);
+  EXPECT_EQ(calculator.determineWinnerByHandRank(), flush);
+
+  flush->setHasFolded(true);
+  EXPECT_EQ(calculator.determineWinnerByHandRank(), trips);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,160 @@
+#include <array>
+#include <chrono>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+import cards;
+import player;
+import game;
+import decisionSource;
+import botProtocol;
+
+#include <gtest/gtest.h>
+
+using namespace std::chrono_literals;
+
+static Player protocolHero() {
+  Player hero("Hero", 180);
+  hero.receiveCards(Card(Suit::Spades, Rank::Ace));
+  hero.receiveCards(Card(Suit::Diamonds, Rank::King));
+  return hero;
+}
+
+static LegalMoves betOrCheck() {
+  LegalMoves moves;
+  moves.allow(actions::fold, 0, 0);
+  moves.allow(actions::check, 0, 0);
+  moves.allow(actions::bet, 10, 180);
+  moves.allow(actions::allIn, 180, 180);
+  return moves;
+}
+
+static LegalMoves callOrFold() {
+  LegalMoves moves;
+  moves.allow(actions::fold, 0, 0);
+  moves.allow(actions::call, 20, 20);
+  moves.allow(actions::allIn, 180, 180);
+  return moves;
+}
+
+// Answers every line with check when it can and call otherwise.
+static const std::string LINE_BOT =
+    "read hello; echo ready; while read turn; do case \"$turn\" in "
+    "*' check'*) echo check;; *) echo call;; esac; done";
+
+TEST(BotProtocolTest, TurnFramesRoundTrip) {
+  const Player hero = protocolHero();
+  const std::array<Card, 4> board = {
+      Card(Suit::Clubs, Rank::Jack), Card(Suit::Diamonds, Rank::Seven),
+      Card(Suit::Clubs, Rank::Ten), Card(Suit::Hearts, Rank::Two)};
+  const turnInfo info{hero, 3,  betOrCheck(), std::span(board), 90, 0,
+                      gameStates::turn, 7, positions{}, 2, 6};
+
+  std::string frame;
+  appendTurnFrame(frame, info);
+  ASSERT_EQ(frame.size(), TURN_FRAME_BYTES);
+  const TurnMessage turn =
+      readTurnPayload(std::string_view(frame).substr(4));
+  EXPECT_EQ(turn.seat, 3);
+  EXPECT_EQ(turn.street, gameStates::turn);
+  EXPECT_EQ(turn.playersInHand, 2);
+  EXPECT_EQ(turn.seats, 6);
+  EXPECT_EQ(turn.round, 7u);
+  EXPECT_EQ(turn.pot, 90u);
+  EXPECT_EQ(turn.chips, 180u);
+  EXPECT_EQ(turn.hole[0].toIndex(), hero.getHand()[0].toIndex());
+  EXPECT_EQ(turn.boardCards, 4);
+  EXPECT_EQ(turn.board[3].toIndex(), board[3].toIndex());
+  EXPECT_EQ(turn.moves.mask, info.validMoves.mask);
+  EXPECT_EQ(turn.moves.max, info.validMoves.max);
+
+  EXPECT_THROW(readTurnPayload(std::string_view(frame).substr(5)),
+               std::invalid_argument);
+}
+
+TEST(BotProtocolTest, ActionFramesAreChecked) {
+  std::string frame;
+  appendActionFrame(frame, actions::bet, 40);
+  ASSERT_EQ(frame.size(), 4 + ACTION_PAYLOAD_BYTES);
+  const Action bet =
+      readActionPayload(std::string_view(frame).substr(4), betOrCheck(), 2);
+  EXPECT_EQ(bet.action, actions::bet);
+  EXPECT_EQ(bet.bet, 40u);
+  EXPECT_EQ(bet.roundCounter, 2u);
+
+  EXPECT_THROW(
+      readActionPayload(std::string_view(frame).substr(4), callOrFold(), 2),
+      std::invalid_argument);
+}
+
+TEST(BotProtocolTest, PlaysAgainstALineBot) {
+  const Player hero = protocolHero();
+  ProcessSource bot(LINE_BOT, ProtocolMode::line, 2s);
+
+  const turnInfo free{hero, 0, betOrCheck(), std::span<const Card>{}, 20, 0,
+                      gameStates::flop, 2, positions{}, 3, 3};
+  const turnInfo facing{hero, 0, callOrFold(), std::span<const Card>{}, 40,
+                        20, gameStates::flop, 2, positions{}, 3, 3};
+  EXPECT_EQ(bot.decide(free).action, actions::check);
+  EXPECT_EQ(bot.decide(facing).action, actions::call);
+  EXPECT_EQ(bot.decide(facing).bet, 20u);
+  EXPECT_EQ(bot.decisions(), 3u);
+  EXPECT_EQ(bot.faults(), 0u);
+  EXPECT_GT(bot.meanRoundTrip().count(), 0);
+}
+
+TEST(BotProtocolTest, PlaysAgainstABinaryBot) {
+  const Player hero = protocolHero();
+  // Reads a whole turn frame and answers call for the least amount.
+  ProcessSource bot("read hello; echo ready; while head -c " +
+                        std::to_string(TURN_FRAME_BYTES) +
+                        " | grep -q ''; do printf "
+                        "'\\005\\000\\000\\000\\002\\000\\000\\000\\000'; done",
+                    ProtocolMode::binary, 2s);
+
+  const turnInfo facing{hero, 0, callOrFold(), std::span<const Card>{}, 40,
+                        20, gameStates::flop, 2, positions{}, 3, 3};
+  for (int i = 0; i < 3; i++) {
+    const Action action = bot.decide(facing);
+    EXPECT_EQ(action.action, actions::call);
+    EXPECT_EQ(action.bet, 20u);
+  }
+  EXPECT_EQ(bot.faults(), 0u);
+}
+
+/* The bot only answers the first turn once the second one arrived, so the
+ * first answer is always late. It is dropped and the second turn gets its
+ * own answer, without relying on how fast the machine is.
+ */
+TEST(BotProtocolTest, LateAnswersAreDropped) {
+  const Player hero = protocolHero();
+  ProcessSource bot("read hello; echo ready; read first; read second; "
+                    "echo bet; echo fold; while read turn; do echo fold; done",
+                    ProtocolMode::line, 500ms);
+
+  const turnInfo free{hero, 0, betOrCheck(), std::span<const Card>{}, 20, 0,
+                      gameStates::flop, 2, positions{}, 3, 3};
+  EXPECT_EQ(bot.decide(free).action, actions::check);
+  EXPECT_EQ(bot.timeouts(), 1u);
+
+  EXPECT_EQ(bot.decide(free).action, actions::fold);
+  EXPECT_EQ(bot.decide(free).action, actions::fold);
+  EXPECT_EQ(bot.timeouts(), 1u);
+  EXPECT_EQ(bot.faults(), 1u);
+}
+
+TEST(BotProtocolTest, SurvivesBotsThatExit) {
+  EXPECT_THROW(ProcessSource("exit 0", ProtocolMode::line, 50ms),
+               std::runtime_error);
+
+  const Player hero = protocolHero();
+  ProcessSource bot("read hello; echo ready", ProtocolMode::line, 1s);
+  const turnInfo facing{hero, 0, callOrFold(), std::span<const Card>{}, 40,
+                        20, gameStates::flop, 2, positions{}, 3, 3};
+  EXPECT_EQ(bot.decide(facing).action, actions::fold);
+  EXPECT_EQ(bot.decide(facing).action, actions::fold);
+  EXPECT_TRUE(bot.isBroken());
+  EXPECT_EQ(bot.faults(), 2u);
+  EXPECT_EQ(bot.timeouts(), 0u);
+}
@@ -1,5 +1,10 @@
 // tests/cards_test.cpp
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 import cards; // Import the 'cards' module
+import prng;
 
 #include <gtest/gtest.h>
 
@@ -77,6 +82,217 @@ TEST(DeckTest, BurnCardThrowsOnEmptyDeck) {
   EXPECT_THROW(deck.burnCard(), std::out_of_range);
 }
 
+TEST(DeckTest, SeededDealingIsReproducible) {
+  Deck deck1;
+  Deck deck2;
+  Xoshiro256 g1(123);
+  Xoshiro256 g2(123);
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(deck1.dealCard(g1).toIndex(), deck2.dealCard(g2).toIndex());
+  }
+  EXPECT_EQ(deck1.size(), 42u);
+}
+
+TEST(DeckTest, RandomDealsEveryCardOnce) {
+  Deck deck;
+  Pcg32 g(7);
+  CardSet dealt;
+  for (int i = 0; i < 52; ++i) {
+    dealt.add(deck.dealCard(g));
+  }
+  EXPECT_EQ(dealt, CardSet::fullDeck());
+  EXPECT_THROW(deck.dealCard(g), std::out_of_range);
+}
+
+TEST(DeckTest, ResetPutsDealtCardsBack) {
+  Deck deck;
+  Xoshiro256 g(5);
+  for (int i = 0; i < 20; ++i) {
+    deck.dealCard(g);
+  }
+  deck.resetDeck();
+  EXPECT_EQ(deck.size(), 52u);
+
+  CardSet dealt;
+  for (int i = 0; i < 52; ++i) {
+    dealt.add(deck.dealCard());
+  }
+  EXPECT_EQ(dealt, CardSet::fullDeck());
+}
+
+TEST(DeckTest, ResetKeepsTheCardsOfTheSet) {
+  CardSet left = CardSet::fullDeck();
+  left -= CardSet({Card(Suit::Spades, Rank::Ace), Card(Suit::Hearts, Rank::Ace),
+                   Card(Suit::Clubs, Rank::Two)});
+  Deck deck(left);
+  EXPECT_EQ(deck.size(), 49u);
+
+  Xoshiro256 g(3);
+  for (int i = 0; i < 10; ++i) {
+    deck.dealCard(g);
+  }
+  deck.resetDeck();
+  EXPECT_EQ(deck.size(), 49u);
+
+  CardSet dealt;
+  for (int i = 0; i < 49; ++i) {
+    const Card card = deck.dealCard(g);
+    EXPECT_FALSE(dealt.contains(card));
+    dealt.add(card);
+  }
+  EXPECT_EQ(dealt, left);
+  EXPECT_THROW(deck.dealCard(g), std::out_of_range);
+}
+
+// Test the CardSet class
+TEST(CardSetTest, IndexRoundTrip) {
+  for (int i = 0; i < 52; ++i) {
+    EXPECT_EQ(Card::fromIndex(i).toIndex(), i);
+  }
+  EXPECT_EQ(Card(Suit::Clubs, Rank::Two).toIndex(), 0);
+  EXPECT_EQ(Card(Suit::Spades, Rank::Ace).toIndex(), 51);
+}
+
+TEST(CardSetTest, AddRemoveContains) {
+  CardSet set;
+  EXPECT_TRUE(set.empty());
+
+  Card aceOfHearts(Suit::Hearts, Rank::Ace);
+  set.add(aceOfHearts);
+  set.add(aceOfHearts);
+  EXPECT_EQ(set.size(), 1);
+  EXPECT_TRUE(set.contains(aceOfHearts));
+  EXPECT_FALSE(set.contains(Card(Suit::Spades, Rank::Ace)));
+
+  set.remove(aceOfHearts);
+  EXPECT_TRUE(set.empty());
+}
+
+TEST(CardSetTest, SetOperations) {
+  CardSet deck = CardSet::fullDeck();
+  EXPECT_EQ(deck.size(), 52);
+
+  CardSet dead{Card(Suit::Clubs, Rank::Two), Card(Suit::Hearts, Rank::King)};
+  CardSet live = deck - dead;
+  EXPECT_EQ(live.size(), 50);
+  EXPECT_TRUE((live & dead).empty());
+  EXPECT_EQ(live | dead, deck);
+  EXPECT_EQ(~live, dead);
+  EXPECT_EQ(dead.suitMask(Suit::Hearts), 1u << 11);
+  EXPECT_EQ(dead.suitMask(Suit::Clubs), 1u);
+}
+
+TEST(CardSetTest, IteratesInIndexOrder) {
+  std::vector<Card> cards = {Card(Suit::Spades, Rank::Ace),
+                             Card(Suit::Clubs, Rank::Three),
+                             Card(Suit::Diamonds, Rank::Ten)};
+  CardSet set(cards);
+
+  std::vector<Card> back = set.toVector();
+  ASSERT_EQ(back.size(), 3u);
+  EXPECT_EQ(back[0].cardToString(), "Three of Clubs");
+  EXPECT_EQ(back[1].cardToString(), "Ten of Diamonds");
+  EXPECT_EQ(back[2].cardToString(), "Ace of Spades");
+
+  int counted = 0;
+  for (Card card : CardSet::fullDeck()) {
+    EXPECT_EQ(card.toIndex(), counted);
+    counted++;
+  }
+  EXPECT_EQ(counted, 52);
+}
+
+TEST(HandIndexerTest, SizesPerRound) {
+  HandIndexer indexer;
+  EXPECT_EQ(indexer.size(0), 169u);
+  EXPECT_EQ(indexer.size(1), 1286792u);
+  EXPECT_EQ(indexer.size(2), 13960050u);
+  EXPECT_EQ(indexer.size(3), 123156254u);
+  EXPECT_EQ(HandIndexer::cardsIn(3), 7);
+}
+
+TEST(HandIndexerTest, PreflopCoversEveryIndex) {
+  HandIndexer indexer;
+  std::vector<int> combos(indexer.size(0), 0);
+  for (int a = 0; a < DECK_SIZE; a++) {
+    for (int b = a + 1; b < DECK_SIZE; b++) {
+      const Card cards[2] = {Card::fromIndex(a), Card::fromIndex(b)};
+      const std::uint64_t index = indexer.index(cards, 0);
+      ASSERT_LT(index, indexer.size(0));
+      combos[index]++;
+      EXPECT_EQ(indexer.index(std::vector<Card>{cards[1], cards[0]}, {}),
+                index);
+    }
+  }
+  // Pairs have 6 combos, suited hands 4 and offsuit hands 12.
+  int pairs = 0, suited = 0, offsuit = 0;
+  for (int count : combos) {
+    pairs += count == 6;
+    suited += count == 4;
+    offsuit += count == 12;
+  }
+  EXPECT_EQ(pairs, 13);
+  EXPECT_EQ(suited, 78);
+  EXPECT_EQ(offsuit, 78);
+}
+
+TEST(HandIndexerTest, EveryFlopIndexRoundTrips) {
+  HandIndexer indexer;
+  Card cards[7];
+  for (std::uint64_t index = 0; index < indexer.size(1); index++) {
+    indexer.unindex(1, index, cards);
+    ASSERT_EQ(indexer.index(cards, 1), index);
+  }
+}
+
+TEST(HandIndexerTest, RandomHandsRoundTripAndIgnoreSuits) {
+  HandIndexer indexer;
+  Xoshiro256 rng(15);
+  Card cards[7], permuted[7], canonical[7];
+  for (int hand = 0; hand < 20000; hand++) {
+    std::uint64_t dealt = 0;
+    for (Card &card : cards) {
+      int at;
+      do {
+        at = static_cast<int>(uniformBelow(rng, DECK_SIZE));
+      } while (dealt >> at & 1);
+      dealt |= std::uint64_t{1} << at;
+      card = Card::fromIndex(at);
+    }
+    int suits[4] = {0, 1, 2, 3};
+    for (int i = 3; i > 0; i--) {
+      std::swap(suits[i], suits[uniformBelow(rng, i + 1)]);
+    }
+    for (int i = 0; i < 7; i++) {
+      permuted[i] = Card(static_cast<Suit>(suits[static_cast<int>(
+                             cards[i].getSuit())]),
+                         cards[i].getRank());
+    }
+    // Order within the board of a round doesn't matter either.
+    std::swap(permuted[2], permuted[4]);
+
+    for (int round = 0; round < HAND_ROUNDS; round++) {
+      const std::uint64_t index = indexer.index(cards, round);
+      ASSERT_LT(index, indexer.size(round));
+      EXPECT_EQ(indexer.index(permuted, round), index);
+      indexer.unindex(round, index, canonical);
+      EXPECT_EQ(indexer.index(canonical, round), index);
+    }
+  }
+}
+
+TEST(HandIndexerTest, RejectsInvalidHands) {
+  HandIndexer indexer;
+  const Card ace(Suit::Spades, Rank::Ace);
+  const Card king(Suit::Spades, Rank::King);
+  EXPECT_THROW(indexer.index(std::vector<Card>{ace, ace}, {}),
+               std::invalid_argument);
+  EXPECT_THROW(indexer.index(std::vector<Card>{ace, king}, {ace}),
+               std::invalid_argument);
+  Card cards[2];
+  EXPECT_THROW(indexer.unindex(0, indexer.size(0), cards), std::out_of_range);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
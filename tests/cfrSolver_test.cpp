@@ -0,0 +1,143 @@
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+import game;
+import threadPool;
+import cfrSolver;
+
+#include <gtest/gtest.h>
+
+static gameSettings shortStacks() {
+  gameSettings settings;
+  settings.minBet = 10;
+  settings.startingChips = 30;
+  return settings;
+}
+
+TEST(CfrSolverTest, TreeFollowsTheBettingRules) {
+  gameSettings settings;
+  CfrSolver solver(settings, HandBuckets::ranked(2));
+  const std::vector<CfrNode> &tree = solver.nodes();
+
+  // The small blind opens, facing the big blind of 10.
+  const CfrNode &root = tree[0];
+  EXPECT_EQ(root.kind, CfrNodeKind::player0);
+  EXPECT_EQ(root.committed, (std::array<money, 2>{5, 10}));
+  ASSERT_EQ(root.childCount, 4);
+  const CfrNode &fold = tree[root.firstChild];
+  const CfrNode &call = tree[root.firstChild + 1];
+  const CfrNode &raise = tree[root.firstChild + 2];
+  const CfrNode &allIn = tree[root.firstChild + 3];
+  EXPECT_EQ(fold.kind, CfrNodeKind::fold);
+  EXPECT_EQ(call.action, actions::call);
+  EXPECT_EQ(call.bet, 10u);
+  EXPECT_EQ(raise.action, actions::raise);
+  EXPECT_EQ(raise.bet, 20u);
+  EXPECT_EQ(allIn.action, actions::allIn);
+  EXPECT_EQ(allIn.bet, 95u);
+
+  // After the call the big blind still has the option, then the flop starts
+  // with the big blind and nothing bet.
+  ASSERT_EQ(call.kind, CfrNodeKind::player1);
+  const CfrNode &option = tree[call.firstChild + 1];
+  EXPECT_EQ(option.action, actions::call);
+  ASSERT_EQ(option.kind, CfrNodeKind::player1);
+  EXPECT_EQ(option.street, 1);
+  EXPECT_EQ(option.committed, (std::array<money, 2>{10, 10}));
+  ASSERT_EQ(option.childCount, 4);
+  EXPECT_EQ(tree[option.firstChild + 1].action, actions::check);
+  EXPECT_EQ(tree[option.firstChild + 2].action, actions::bet);
+
+  // Against an all-in only fold and call are left.
+  ASSERT_EQ(allIn.kind, CfrNodeKind::player1);
+  ASSERT_EQ(allIn.childCount, 2);
+  EXPECT_EQ(tree[allIn.firstChild + 1].kind, CfrNodeKind::showdown);
+
+  for (std::size_t n = 0; n < tree.size(); n++) {
+    for (int a = 0; a < tree[n].childCount; a++) {
+      EXPECT_GT(tree[n].firstChild, n);
+    }
+  }
+}
+
+TEST(CfrSolverTest, Converges) {
+  ThreadPool pool(2);
+  CfrSolver solver(shortStacks(), HandBuckets::ranked(6));
+  SolveReport start = solver.solve(pool, 10);
+  SolveReport end = solver.solve(pool, 2000);
+  EXPECT_EQ(solver.iterations(), 2010u);
+  EXPECT_GT(end.iterationsPerSecond, 0);
+  EXPECT_GE(end.exploitability, 0);
+  EXPECT_LT(end.exploitability, start.exploitability);
+  EXPECT_LT(end.exploitability, 0.01);
+}
+
+TEST(CfrSolverTest, BestHandNeverFoldsToABet) {
+  ThreadPool pool(1);
+  CfrSolver solver(shortStacks(), HandBuckets::ranked(6));
+  solver.iterate(pool, 2000);
+  const CfrNode &root = solver.nodes()[0];
+  const std::size_t raised = root.firstChild + 2;
+  std::array<float, MAX_CFR_ACTIONS> strategy = solver.strategyAt(raised, 5);
+  EXPECT_LT(strategy[0], 0.01f);
+  strategy = solver.strategyAt(0, 0);
+  EXPECT_NEAR(strategy[0] + strategy[1] + strategy[2] + strategy[3], 1.0f,
+              1e-4);
+}
+
+TEST(CfrSolverTest, ThreadsDontChangeTheResult) {
+  ThreadPool single(1);
+  ThreadPool several(3);
+  CfrSolver first(shortStacks(), HandBuckets::ranked(40));
+  CfrSolver second(shortStacks(), HandBuckets::ranked(40));
+  first.iterate(single, 50);
+  second.iterate(several, 50);
+  for (std::size_t n = 0; n < first.nodes().size(); n++) {
+    if (first.nodes()[n].childCount == 0) {
+      continue;
+    }
+    for (std::size_t bucket = 0; bucket < 40; bucket++) {
+      EXPECT_EQ(first.strategyAt(n, bucket), second.strategyAt(n, bucket));
+    }
+  }
+  EXPECT_EQ(first.exploitability(single), second.exploitability(several));
+}
+
+TEST(CfrSolverTest, SubtreesDontChangeTheResult) {
+  // The default game of cfr_solve, 16 buckets are one block, so the threads
+  // only share the work through the subtrees.
+  gameSettings settings;
+  ThreadPool single(1);
+  ThreadPool several(4);
+  CfrSolver first(settings, HandBuckets::ranked(16));
+  CfrSolver second(settings, HandBuckets::ranked(16));
+  first.iterate(single, 20);
+  second.iterate(several, 20);
+  for (std::size_t n = 0; n < first.nodes().size(); n++) {
+    if (first.nodes()[n].childCount == 0) {
+      continue;
+    }
+    for (std::size_t bucket = 0; bucket < 16; bucket++) {
+      ASSERT_EQ(first.strategyAt(n, bucket), second.strategyAt(n, bucket));
+    }
+  }
+  EXPECT_EQ(first.exploitability(single), second.exploitability(several));
+}
+
+TEST(CfrSolverTest, RejectsBrokenGames) {
+  gameSettings settings;
+  HandBuckets oneSided = HandBuckets::ranked(2);
+  oneSided.equity[1] = 1.0f; // 0 beats 1 and 1 beats 0.
+  EXPECT_THROW(CfrSolver(settings, oneSided), std::invalid_argument);
+  EXPECT_THROW(CfrSolver(settings, HandBuckets{}), std::invalid_argument);
+
+  settings.startingChips = settings.minBet;
+  EXPECT_THROW(CfrSolver(settings, HandBuckets::ranked(2)),
+               std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
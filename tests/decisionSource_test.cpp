@@ -0,0 +1,207 @@
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+import cards;
+import player;
+import game;
+import decisionSource;
+
+#include <gtest/gtest.h>
+#include "testHelpers.hpp"
+
+static money chipsOf(const playersPool &players) {
+  money total = 0;
+  for (const auto &player : players) {
+    total += player->getChips();
+  }
+  return total;
+}
+
+static LegalMoves facingBet() {
+  LegalMoves moves;
+  moves.allow(actions::fold, 0, 0);
+  moves.allow(actions::call, 20, 20);
+  moves.allow(actions::raise, 30, 180);
+  moves.allow(actions::allIn, 180, 180);
+  return moves;
+}
+
+// CallDownBot, counting its decisions.
+struct CountingBot {
+  int decisions = 0;
+
+  Action decide(const turnInfo &info) {
+    decisions++;
+    return CallDownBot{}.decide(info);
+  }
+};
+
+TEST(DecisionSourceTest, FormatsTheTurnAsOneLine) {
+  Player hero("Hero", 180);
+  hero.receiveCards(Card(Suit::Spades, Rank::Ace));
+  hero.receiveCards(Card(Suit::Diamonds, Rank::King));
+  const std::array<Card, 3> flop = {Card(Suit::Clubs, Rank::Jack),
+                                    Card(Suit::Diamonds, Rank::Seven),
+                                    Card(Suit::Clubs, Rank::Ten)};
+  const turnInfo info{hero, 2,           facingBet(), std::span(flop), 45, 20,
+                      gameStates::flop, 3, positions{}, 3,           6};
+
+  EXPECT_EQ(formatTurn(info),
+            "turn seat 2 street flop round 3 pot 45 high 20 bet 0 chips 180 "
+            "players 3 hole AsKd board Jc7dTc moves fold call:20 "
+            "raise:30-180 allin:180");
+}
+
+TEST(DecisionSourceTest, ParsesLegalAnswers) {
+  const LegalMoves moves = facingBet();
+  const Action call = parseAction("call", moves, 4);
+  EXPECT_EQ(call.action, actions::call);
+  EXPECT_EQ(call.bet, 20u);
+  EXPECT_EQ(call.roundCounter, 4u);
+
+  const Action raise = parseAction("raise 60\r", moves, 4);
+  EXPECT_EQ(raise.action, actions::raise);
+  EXPECT_EQ(raise.bet, 60u);
+
+  EXPECT_EQ(parseAction("raise", moves, 4).bet, 30u);
+  EXPECT_THROW(parseAction("check", moves, 4), std::invalid_argument);
+  EXPECT_THROW(parseAction("raise 200", moves, 4), std::invalid_argument);
+  EXPECT_THROW(parseAction("raise 6x", moves, 4), std::invalid_argument);
+  EXPECT_THROW(parseAction("shove", moves, 4), std::invalid_argument);
+}
+
+TEST(DecisionSourceTest, BotsReadTheMovesBack) {
+  Player hero("Hero", 180);
+  hero.receiveCards(Card(Suit::Hearts, Rank::Two));
+  hero.receiveCards(Card(Suit::Clubs, Rank::Nine));
+  const LegalMoves moves = facingBet();
+  const turnInfo info{hero, 1, moves, std::span<const Card>{}, 30, 20,
+                      gameStates::preFlop, 1, positions{}, 2, 2};
+
+  const LegalMoves read = parseMoves(formatTurn(info) + "\r");
+  EXPECT_EQ(read.mask, moves.mask);
+  EXPECT_EQ(read.min, moves.min);
+  EXPECT_EQ(read.max, moves.max);
+  EXPECT_THROW(parseMoves("ready"), std::invalid_argument);
+  EXPECT_THROW(parseMoves("turn moves fold call:4294967296"),
+               std::invalid_argument);
+  EXPECT_THROW(parseMoves("turn moves raise:30-99999999999999999999"),
+               std::invalid_argument);
+  EXPECT_THROW(parseMoves("turn moves call:"), std::invalid_argument);
+  EXPECT_EQ(parseMoves("turn moves call:4294967295").minAmount(actions::call),
+            4294967295u);
+
+  EXPECT_EQ(formatAnswer(actions::raise, 60), "raise 60");
+  EXPECT_EQ(parseAction(formatAnswer(actions::allIn, 0), moves, 1).bet, 180u);
+}
+
+TEST(DecisionSourceTest, RemoteSourceFallsBackOnBadAnswers) {
+  Player hero("Hero", 180);
+  hero.receiveCards(Card(Suit::Spades, Rank::Ace));
+  hero.receiveCards(Card(Suit::Diamonds, Rank::King));
+  const turnInfo info{hero, 0, facingBet(), std::span<const Card>{}, 30, 20,
+                      gameStates::preFlop, 1, positions{}, 2, 2};
+
+  std::istringstream answers("raise 40\nraise 999\n");
+  std::ostringstream turns;
+  RemoteSource remote(answers, turns);
+
+  EXPECT_EQ(remote.decide(info).bet, 40u);
+  EXPECT_EQ(remote.decide(info).action, actions::fold);
+  // The peer has nothing left to say.
+  EXPECT_EQ(remote.decide(info).action, actions::fold);
+  EXPECT_EQ(remote.faults(), 2u);
+
+  std::istringstream sent(turns.str());
+  std::string line;
+  int lines = 0;
+  while (std::getline(sent, line)) {
+    EXPECT_EQ(line.rfind("turn seat 0 street preflop", 0), 0u);
+    lines++;
+  }
+  EXPECT_EQ(lines, 3);
+}
+
+TEST(DecisionSourceTest, HumanSourceReadsTheGivenStream) {
+  Player hero("Hero", 180);
+  hero.receiveCards(Card(Suit::Spades, Rank::Ace));
+  hero.receiveCards(Card(Suit::Diamonds, Rank::King));
+  const turnInfo info{hero, 0, facingBet(), std::span<const Card>{}, 30, 20,
+                      gameStates::preFlop, 1, positions{}, 2, 2};
+
+  // Option 3 is raise, 10 is too little and asked again.
+  std::istringstream typed("3\n10\n50\n");
+  std::ostringstream shown;
+  HumanSource human(typed, shown);
+  const Action action = human.decide(info);
+
+  EXPECT_EQ(action.action, actions::raise);
+  EXPECT_EQ(action.bet, 50u);
+  EXPECT_NE(shown.str().find("Invalid amount"), std::string::npos);
+}
+
+TEST(DecisionSourceTest, ScriptedSourcePlaysItsScript) {
+  playersPool players = makePlayers(2);
+  gameSettings settings;
+  BasicGame<silentIO, DecisionSource> game(players, settings,
+                                           positions{0, 1, 0}, 3);
+  // The first to act folds, which ends the hand.
+  ScriptedSource script({Action{actions::fold, 0, 0}});
+  game.setSource(0, script);
+  game.setSource(1, script);
+  game.simulateHand();
+
+  EXPECT_EQ(script.remaining(), 0u);
+  EXPECT_EQ(chipsOf(players), 200u);
+
+  ScriptedSource empty({});
+  const turnInfo info{*players[0], 0, facingBet(), std::span<const Card>{},
+                      30, 20, gameStates::preFlop, 1, positions{}, 2, 2};
+  EXPECT_THROW(empty.decide(info), std::out_of_range);
+}
+
+/* A Decider, the same bot behind the virtual interface and a strategy all
+ * play the same hand.
+ */
+TEST(DecisionSourceTest, EveryPolicyPlaysTheSameHand) {
+  gameSettings settings;
+  const positions pos{0, 2, 1};
+
+  playersPool direct = makePlayers(4);
+  CountingBot bot;
+  BasicGame<silentIO, CountingBot> directGame(direct, settings, pos, 11);
+  for (position seat = 0; seat < 4; seat++) {
+    directGame.setSource(seat, bot);
+  }
+  directGame.simulateHand();
+  EXPECT_GT(bot.decisions, 4);
+
+  playersPool virtualSeats = makePlayers(4);
+  BotSource<CallDownBot> source(std::make_shared<CallDownBot>());
+  BasicGame<silentIO, DecisionSource> virtualGame(virtualSeats, settings,
+                                                  pos, 11);
+  for (position seat = 0; seat < 4; seat++) {
+    virtualGame.setSource(seat, source);
+  }
+  virtualGame.simulateHand();
+
+  playersPool strategySeats = makePlayers(4);
+  HeadlessGame strategyGame(strategySeats, settings, pos, 11);
+  auto shared = std::make_shared<BotSource<CallDownBot>>(
+      std::make_shared<CallDownBot>());
+  for (position seat = 0; seat < 4; seat++) {
+    strategyGame.setStrategy(seat, sourceStrategy(shared));
+  }
+  strategyGame.simulateHand();
+
+  for (std::size_t seat = 0; seat < 4; seat++) {
+    EXPECT_EQ(direct[seat]->getChips(), virtualSeats[seat]->getChips());
+    EXPECT_EQ(direct[seat]->getChips(), strategySeats[seat]->getChips());
+  }
+  EXPECT_EQ(chipsOf(direct), 400u);
+}
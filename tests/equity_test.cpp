@@ -0,0 +1,115 @@
+#include <vector>
+import cards;
+import threadPool;
+import equity;
+
+#include <gtest/gtest.h>
+
+TEST(EquityTest, AcesAgainstKingsPreflop) {
+  ThreadPool pool(4);
+  std::vector<std::vector<Card>> hands = {
+      {Card(Suit::Hearts, Rank::Ace), Card(Suit::Spades, Rank::Ace)},
+      {Card(Suit::Diamonds, Rank::King), Card(Suit::Clubs, Rank::King)}};
+
+  EquityResult result = monteCarloEquity(hands, {}, 400000, pool, 7);
+  EXPECT_EQ(result.samples, 400000u);
+  EXPECT_NEAR(result.equity[0], 0.82, 0.01);
+  EXPECT_NEAR(result.equity[0] + result.equity[1], 1.0, 1e-9);
+}
+
+TEST(EquityTest, CompleteBoardIsExact) {
+  ThreadPool pool(2);
+  std::vector<Card> board = {
+      Card(Suit::Hearts, Rank::Two), Card(Suit::Hearts, Rank::Seven),
+      Card(Suit::Clubs, Rank::Nine), Card(Suit::Clubs, Rank::King),
+      Card(Suit::Spades, Rank::Queen)};
+  std::vector<std::vector<Card>> hands = {
+      {Card(Suit::Diamonds, Rank::Ace), Card(Suit::Spades, Rank::Three)},
+      {Card(Suit::Hearts, Rank::Ace), Card(Suit::Spades, Rank::Four)},
+      {Card(Suit::Diamonds, Rank::Jack), Card(Suit::Spades, Rank::Ten)}};
+
+  EquityResult result = monteCarloEquity(hands, board, 1000, pool);
+  EXPECT_DOUBLE_EQ(result.equity[2], 1.0);
+  EXPECT_DOUBLE_EQ(result.win[2], 1.0);
+
+  hands[2] = {Card(Suit::Diamonds, Rank::Four), Card(Suit::Spades, Rank::Five)};
+  result = monteCarloEquity(hands, board, 1000, pool);
+  EXPECT_DOUBLE_EQ(result.tie[0], 1.0);
+  EXPECT_DOUBLE_EQ(result.equity[0], 0.5);
+  EXPECT_DOUBLE_EQ(result.equity[1], 0.5);
+  EXPECT_DOUBLE_EQ(result.equity[2], 0.0);
+}
+
+TEST(EquityTest, ResultOnlyDependsOnSeed) {
+  ThreadPool single(1);
+  ThreadPool several(3);
+  std::vector<std::vector<Card>> hands = {
+      {Card(Suit::Hearts, Rank::Ten), Card(Suit::Hearts, Rank::Jack)},
+      {Card(Suit::Clubs, Rank::Six), Card(Suit::Diamonds, Rank::Six)}};
+  std::vector<Card> flop = {Card(Suit::Hearts, Rank::Two),
+                            Card(Suit::Hearts, Rank::Nine),
+                            Card(Suit::Spades, Rank::Six)};
+
+  EquityResult first = monteCarloEquity(hands, flop, 100000, single, 99);
+  EquityResult second = monteCarloEquity(hands, flop, 100000, several, 99);
+  EXPECT_EQ(first.win, second.win);
+  EXPECT_EQ(first.tie, second.tie);
+}
+
+TEST(EquityTest, RejectsDuplicateCards) {
+  ThreadPool pool(1);
+  std::vector<std::vector<Card>> hands = {
+      {Card(Suit::Hearts, Rank::Ace), Card(Suit::Spades, Rank::Ace)},
+      {Card(Suit::Hearts, Rank::Ace), Card(Suit::Clubs, Rank::King)}};
+  EXPECT_THROW(monteCarloEquity(hands, {}, 10, pool), std::invalid_argument);
+
+  hands[1] = {Card(Suit::Diamonds, Rank::Ace), Card(Suit::Clubs, Rank::King)};
+  std::vector<Card> board = {Card(Suit::Spades, Rank::Ace)};
+  EXPECT_THROW(monteCarloEquity(hands, board, 10, pool),
+               std::invalid_argument);
+}
+
+TEST(ExactEquityTest, CountsFlushOutsOnTheTurn) {
+  // Seven hearts make the flush, the Three and Queen of hearts fill the set.
+  std::vector<std::vector<Card>> hands = {
+      {Card(Suit::Hearts, Rank::Ace), Card(Suit::Hearts, Rank::King)},
+      {Card(Suit::Spades, Rank::Queen), Card(Suit::Clubs, Rank::Queen)}};
+  std::vector<Card> turn = {
+      Card(Suit::Hearts, Rank::Two), Card(Suit::Hearts, Rank::Seven),
+      Card(Suit::Diamonds, Rank::Queen), Card(Suit::Spades, Rank::Three)};
+
+  EquityResult result = exactEquity(hands, turn);
+  EXPECT_EQ(result.samples, 44u);
+  EXPECT_EQ(result.equity[0], 7.0 / 44.0);
+  EXPECT_EQ(result.equity[1], 37.0 / 44.0);
+  EXPECT_EQ(result.tie[0], 0.0);
+}
+
+TEST(ExactEquityTest, PoolAndSingleThreadAgreeBitForBit) {
+  ThreadPool pool(3);
+  std::vector<std::vector<Card>> hands = {
+      {Card(Suit::Hearts, Rank::Ten), Card(Suit::Hearts, Rank::Jack)},
+      {Card(Suit::Clubs, Rank::Six), Card(Suit::Diamonds, Rank::Six)},
+      {Card(Suit::Spades, Rank::Ace), Card(Suit::Clubs, Rank::Two)}};
+  std::vector<Card> flop = {Card(Suit::Hearts, Rank::Two),
+                            Card(Suit::Hearts, Rank::Nine),
+                            Card(Suit::Spades, Rank::Six)};
+
+  EquityResult single = exactEquity(hands, flop);
+  EquityResult parallel = exactEquity(hands, flop, pool);
+  EXPECT_EQ(single.samples, 903u); // 43 choose 2
+  EXPECT_EQ(single.samples, parallel.samples);
+  EXPECT_EQ(single.win, parallel.win);
+  EXPECT_EQ(single.tie, parallel.tie);
+  EXPECT_EQ(single.equity, parallel.equity);
+
+  EquityResult sampled = monteCarloEquity(hands, flop, 200000, pool, 3);
+  for (std::size_t p = 0; p < hands.size(); p++) {
+    EXPECT_NEAR(sampled.equity[p], single.equity[p], 0.01);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,317 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+import cards;
+import player;
+import game;
+import prng;
+
+#include <gtest/gtest.h>
+#include "testHelpers.hpp"
+
+// Every heap allocation of the test, counted like poker_bench does.
+static std::atomic<std::uint64_t> allocations{0};
+
+[[gnu::noinline]] void *operator new(std::size_t size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void *memory = std::malloc(size == 0 ? 1 : size)) {
+    return memory;
+  }
+  throw std::bad_alloc();
+}
+void *operator new[](std::size_t size) { return operator new(size); }
+
+TEST(GameTest, LegalMovesArePlainData) {
+  EXPECT_TRUE(std::is_trivially_copyable_v<LegalMoves>);
+
+  LegalMoves moves;
+  EXPECT_EQ(moves.count(), 0);
+  moves.allow(actions::raise, 20, 90);
+  moves.allow(actions::fold, 0, 0);
+  EXPECT_TRUE(moves.isLegal(actions::fold));
+  EXPECT_FALSE(moves.isLegal(actions::check));
+  EXPECT_EQ(moves.count(), 2);
+  EXPECT_EQ(moves.nth(0), actions::fold);
+  EXPECT_EQ(moves.nth(1), actions::raise);
+  EXPECT_EQ(moves.minAmount(actions::raise), 20u);
+  EXPECT_EQ(moves.maxAmount(actions::raise), 90u);
+
+  std::vector<actions> walked;
+  for (actions act : moves) {
+    walked.push_back(act);
+  }
+  EXPECT_EQ(walked, (std::vector<actions>{actions::fold, actions::raise}));
+}
+
+TEST(GameTest, LegalMovesAfterTheBlinds) {
+  playersPool players = makePlayers(3);
+  gameSettings settings;
+  positions pos{0, 2, 1};
+  HeadlessGame game(players, settings, pos, 1);
+  GameInternals::startHand(game);
+
+  // The dealer faces the big blind of 10 with 100 chips.
+  LegalMoves dealer = GameInternals::allValidAction(game, 0);
+  EXPECT_EQ(dealer.mask, LegalMoves::bit(actions::fold) |
+                             LegalMoves::bit(actions::call) |
+                             LegalMoves::bit(actions::raise) |
+                             LegalMoves::bit(actions::allIn));
+  EXPECT_EQ(dealer.minAmount(actions::call), 10u);
+  EXPECT_EQ(dealer.minAmount(actions::raise), 20u);
+  EXPECT_EQ(dealer.maxAmount(actions::raise), 100u);
+  EXPECT_EQ(dealer.minAmount(actions::allIn), 100u);
+
+  // The small blind already put in 5, its bet can still become 100.
+  LegalMoves smallBlind = GameInternals::allValidAction(game, 1);
+  EXPECT_EQ(smallBlind.maxAmount(actions::raise), 100u);
+  EXPECT_EQ(smallBlind.minAmount(actions::allIn), 95u);
+  EXPECT_FALSE(smallBlind.isLegal(actions::check));
+  EXPECT_FALSE(smallBlind.isLegal(actions::bet));
+}
+
+TEST(GameTest, ReusedGamePlaysLikeNewGames) {
+  gameSettings settings;
+  playersPool fresh = makePlayers(4);
+  playersPool reused = makePlayers(4);
+  Xoshiro256 freshRng(11);
+  Xoshiro256 reusedRng(11);
+  HeadlessGame game(reused, settings, positions{}, 0);
+  for (position seat = 0; seat < 4; seat++) {
+    game.setStrategy(seat, randomStrategy(reusedRng));
+  }
+
+  for (std::uint64_t hand = 0; hand < 200; hand++) {
+    positions pos{static_cast<position>(hand % 4),
+                  static_cast<position>((hand + 2) % 4),
+                  static_cast<position>((hand + 1) % 4)};
+    for (playersPool *players : {&fresh, &reused}) {
+      for (auto &player : *players) {
+        player->setChips(settings.startingChips);
+      }
+    }
+    HeadlessGame once(fresh, settings, pos, hand);
+    for (position seat = 0; seat < 4; seat++) {
+      once.setStrategy(seat, randomStrategy(freshRng));
+    }
+    once.simulateHand();
+    const std::uint64_t before = allocations.load(std::memory_order_relaxed);
+    game.newHand(pos, hand);
+    game.simulateHand();
+    const std::uint64_t handAllocations =
+        allocations.load(std::memory_order_relaxed) - before;
+
+    ASSERT_EQ(game.getPot(), once.getPot());
+    for (int seat = 0; seat < 4; seat++) {
+      ASSERT_EQ(reused[seat]->getChips(), fresh[seat]->getChips());
+    }
+    // Once warmed up, a reused game plays its hands without the heap.
+    if (hand > 0) {
+      EXPECT_EQ(handAllocations, 0u) << "hand " << hand;
+    }
+  }
+}
+
+// Picks a legal move from what the turn looks like, the same in every game.
+static Action deterministicDecision(const turnInfo &info) {
+  const LegalMoves &moves = info.validMoves;
+  const std::uint32_t pick =
+      (info.pot * 7 + static_cast<std::uint32_t>(info.seat) * 3 +
+       info.highestBet + static_cast<std::uint32_t>(info.currentRound)) %
+      static_cast<std::uint32_t>(moves.count());
+  const actions chosen = moves.nth(static_cast<int>(pick));
+  return Action{chosen, moves.minAmount(chosen), info.currentRound};
+}
+
+static positions positionsOfHand(std::uint64_t hand, int seats) {
+  return {static_cast<position>(hand % seats),
+          static_cast<position>((hand + 2) % seats),
+          static_cast<position>((hand + 1) % seats)};
+}
+
+/* A strategy that bets more than it has or plays a move that isn't offered
+ * checks or folds instead, the chips stay where they are.
+ */
+TEST(GameTest, IllegalDecisionsCheckOrFold) {
+  playersPool players = makePlayers(3);
+  gameSettings settings;
+  HeadlessGame game(players, settings, positions{0, 2, 1}, 6);
+  int decisions = 0;
+  for (position seat = 0; seat < 3; seat++) {
+    game.setStrategy(seat, [&](const turnInfo &info) {
+      decisions++;
+      const actions act = info.seat == 0 ? actions::raise : actions::bet;
+      return Action{act, 100000, info.currentRound};
+    });
+  }
+  game.simulateHand();
+
+  // The dealer and the small blind fold, facing the big blind.
+  EXPECT_EQ(decisions, 2);
+  money total = 0;
+  for (const auto &player : players) {
+    EXPECT_LE(player->getChips(), 300u);
+    total += player->getChips();
+  }
+  EXPECT_EQ(total, 300u);
+  EXPECT_EQ(players[2]->getChips(), 105u);
+}
+
+TEST(GameTest, GameStateIsPlainData) {
+  EXPECT_TRUE(std::is_trivially_copyable_v<GameState>);
+  EXPECT_LE(sizeof(GameState), 512u);
+}
+
+TEST(GameTest, ExportedStateMatchesTheTurn) {
+  playersPool players = makePlayers(4);
+  gameSettings settings;
+  HeadlessGame game(players, settings, positions{0, 2, 1}, 5);
+  int decisions = 0;
+  for (position seat = 0; seat < 4; seat++) {
+    game.setStrategy(seat, [&](const turnInfo &info) {
+      const GameState state = game.exportState();
+      EXPECT_EQ(state.actor, info.seat);
+      EXPECT_EQ(state.legalActions().mask, info.validMoves.mask);
+      EXPECT_EQ(state.legalActions().min, info.validMoves.min);
+      EXPECT_EQ(state.legalActions().max, info.validMoves.max);
+      EXPECT_EQ(state.pot, info.pot);
+      EXPECT_EQ(state.highestBet, info.highestBet);
+      EXPECT_EQ(state.street, info.gameState);
+      EXPECT_EQ(state.communityCards().size(), info.communityCards.size());
+      EXPECT_EQ(state.chips[info.seat], info.player.getChips());
+      decisions++;
+      return deterministicDecision(info);
+    });
+  }
+  EXPECT_THROW(game.exportState(), std::logic_error);
+  game.simulateHand();
+  EXPECT_GT(decisions, 0);
+  EXPECT_THROW(game.exportState(), std::logic_error);
+}
+
+// Applying the actions of a hand to its first state walks through the states
+// the game exported and ends where the game ended.
+TEST(GameTest, StatePlaysTheHandLikeTheGame) {
+  gameSettings settings;
+  Xoshiro256 rng(21);
+  for (std::uint64_t hand = 0; hand < 300; hand++) {
+    const int seatCount = 2 + static_cast<int>(hand % 5);
+    playersPool players = makePlayers(seatCount);
+    HeadlessGame game(players, settings, positionsOfHand(hand, seatCount),
+                      hand);
+    std::vector<GameState> states;
+    std::vector<Action> played;
+    strategy random = randomStrategy(rng);
+    for (position seat = 0; seat < seatCount; seat++) {
+      game.setStrategy(seat, [&](const turnInfo &info) {
+        states.push_back(game.exportState());
+        played.push_back(random(info));
+        return played.back();
+      });
+    }
+    game.simulateHand();
+    ASSERT_FALSE(states.empty());
+
+    GameState state = states[0];
+    for (std::size_t i = 0; i < played.size(); i++) {
+      const GameState &expected = states[i];
+      ASSERT_EQ(state.actor, expected.actor) << "hand " << hand;
+      ASSERT_EQ(state.street, expected.street);
+      ASSERT_EQ(state.pot, expected.pot);
+      ASSERT_EQ(state.chips, expected.chips);
+      ASSERT_EQ(state.bets, expected.bets);
+      ASSERT_EQ(state.folded, expected.folded);
+      ASSERT_EQ(state.legalActions().mask, expected.legalActions().mask);
+      ASSERT_EQ(CardSet(state.communityCards()),
+                CardSet(expected.communityCards()));
+      state.apply(played[i]);
+    }
+    ASSERT_TRUE(state.isTerminal()) << "hand " << hand;
+    for (int seat = 0; seat < seatCount; seat++) {
+      ASSERT_EQ(state.chips[seat], players[seat]->getChips())
+          << "hand " << hand << " seat " << seat;
+    }
+  }
+}
+
+TEST(GameTest, ImportedStateResumesTheHand) {
+  gameSettings settings;
+  for (std::uint64_t hand = 0; hand < 100; hand++) {
+    const int seatCount = 2 + static_cast<int>(hand % 5);
+    playersPool players = makePlayers(seatCount);
+    HeadlessGame game(players, settings, positionsOfHand(hand, seatCount),
+                      hand);
+    std::vector<GameState> states;
+    for (position seat = 0; seat < seatCount; seat++) {
+      game.setStrategy(seat, [&](const turnInfo &info) {
+        states.push_back(game.exportState());
+        return deterministicDecision(info);
+      });
+    }
+    game.simulateHand();
+
+    // Resuming at any decision plays the rest of the hand the same way.
+    for (const GameState &state : states) {
+      playersPool copies = makePlayers(seatCount);
+      HeadlessGame resumed(copies, settings, positions{}, 0);
+      for (position seat = 0; seat < seatCount; seat++) {
+        resumed.setStrategy(seat, deterministicDecision);
+      }
+      resumed.importState(state);
+      resumed.resumeHand();
+      for (int seat = 0; seat < seatCount; seat++) {
+        ASSERT_EQ(copies[seat]->getChips(), players[seat]->getChips())
+            << "hand " << hand << " seat " << seat;
+      }
+    }
+  }
+}
+
+TEST(GameTest, StateRejectsIllegalActions) {
+  playersPool players = makePlayers(3);
+  gameSettings settings;
+  HeadlessGame game(players, settings, positions{0, 2, 1}, 3);
+  GameState state;
+  bool exported = false;
+  for (position seat = 0; seat < 3; seat++) {
+    game.setStrategy(seat, [&](const turnInfo &info) {
+      if (!exported) {
+        state = game.exportState();
+        exported = true;
+      }
+      return Action{actions::fold, 0, info.currentRound};
+    });
+  }
+  game.simulateHand();
+  ASSERT_TRUE(exported);
+
+  // The first player faces the big blind.
+  const LegalMoves moves = state.legalActions();
+  EXPECT_THROW(state.apply({actions::check, 0, 0}), std::invalid_argument);
+  EXPECT_THROW(state.apply({actions::raise,
+                            moves.maxAmount(actions::raise) + 1, 0}),
+               std::invalid_argument);
+  EXPECT_THROW(state.apply({actions::call, moves.minAmount(actions::call) - 1,
+                            0}),
+               std::invalid_argument);
+
+  while (!state.isTerminal()) {
+    state.apply({actions::fold, 0, 0});
+  }
+  EXPECT_EQ(state.legalActions().count(), 0);
+  EXPECT_THROW(state.apply({actions::fold, 0, 0}), std::logic_error);
+  money total = 0;
+  for (int seat = 0; seat < 3; seat++) {
+    total += state.chips[seat];
+  }
+  EXPECT_EQ(total, 300u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,39 @@
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+import handArena;
+
+#include <gtest/gtest.h>
+
+TEST(HandArenaTest, SmallHandsStayInTheBuffer) {
+  HandArena arena;
+  for (int hand = 0; hand < 100; hand++) {
+    std::pmr::vector<int> values(arena.resource());
+    for (int i = 0; i < 100; i++) {
+      values.push_back(i);
+    }
+    values = std::pmr::vector<int>(arena.resource());
+    arena.release();
+    EXPECT_EQ(arena.lastHandHeapAllocations(), 0u);
+  }
+  EXPECT_EQ(arena.heapAllocations(), 0u);
+}
+
+TEST(HandArenaTest, CountsBlocksFromTheHeap) {
+  HandArena arena;
+  void *first = arena.resource()->allocate(HAND_ARENA_BYTES * 2);
+  EXPECT_NE(first, nullptr);
+  EXPECT_EQ(arena.heapAllocations(), 1u);
+  arena.release();
+  EXPECT_EQ(arena.lastHandHeapAllocations(), 1u);
+
+  EXPECT_NE(arena.resource()->allocate(64), nullptr);
+  arena.release();
+  EXPECT_EQ(arena.lastHandHeapAllocations(), 0u);
+  EXPECT_EQ(arena.heapAllocations(), 1u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+import player;
+import game;
+import prng;
+import handHistory;
+
+#include <gtest/gtest.h>
+#include "testHelpers.hpp"
+
+static std::string tempLog(const std::string &name) {
+  return (std::filesystem::temp_directory_path() / name).string();
+}
+
+static std::vector<HistoryRecord> randomRecords(std::size_t amount) {
+  Xoshiro256 rng(17);
+  std::vector<HistoryRecord> records;
+  for (std::size_t i = 0; i < amount; i++) {
+    records.push_back({i / 9, 1000 + uniformBelow(rng, 6),
+                       static_cast<std::uint8_t>(uniformBelow(rng, 6)),
+                       static_cast<std::uint8_t>(uniformBelow(rng, 4)),
+                       static_cast<std::uint8_t>(uniformBelow(rng, 6)),
+                       uniformBelow(rng, 1000),
+                       static_cast<std::uint32_t>(i % 40)});
+  }
+  // Extremes have to survive the bit packing as well.
+  records.push_back({~std::uint64_t{0}, ~std::uint32_t{0}, 255, 4, 5,
+                     ~std::uint32_t{0}, 0});
+  return records;
+}
+
+static void expectSame(const HistoryRecord &a, const HistoryRecord &b) {
+  EXPECT_EQ(a.hand, b.hand);
+  EXPECT_EQ(a.player, b.player);
+  EXPECT_EQ(a.seat, b.seat);
+  EXPECT_EQ(a.street, b.street);
+  EXPECT_EQ(a.action, b.action);
+  EXPECT_EQ(a.bet, b.bet);
+  EXPECT_EQ(a.round, b.round);
+}
+
+TEST(HandHistoryTest, RoundTripOverSeveralBlocks) {
+  const std::string path = tempLog("handHistory_roundtrip.bin");
+  std::vector<HistoryRecord> records = randomRecords(10000);
+  {
+    HandHistoryWriter writer(path, 1024);
+    for (const auto &record : records) {
+      writer.append(record);
+    }
+    EXPECT_EQ(writer.size(), records.size());
+  }
+
+  HandHistoryReader reader(path);
+  ASSERT_EQ(reader.size(), records.size());
+  EXPECT_EQ(reader.blockCount(), 10u);
+  std::size_t i = 0;
+  reader.forEach([&](const HistoryRecord &record) {
+    expectSame(record, records[i++]);
+  });
+  EXPECT_EQ(i, records.size());
+
+  // Packed far below the 29 bytes of the unpacked fields.
+  EXPECT_LT(std::filesystem::file_size(path), records.size() * 8);
+  std::filesystem::remove(path);
+}
+
+TEST(HandHistoryTest, ReadsSingleColumns) {
+  const std::string path = tempLog("handHistory_column.bin");
+  std::vector<HistoryRecord> records = randomRecords(3000);
+  {
+    HandHistoryWriter writer(path, 2048);
+    for (const auto &record : records) {
+      writer.append(record);
+    }
+  }
+
+  HandHistoryReader reader(path);
+  std::vector<std::uint64_t> bets(reader.blockSize(1));
+  reader.readColumn(1, HistoryColumn::bet, bets.data());
+  for (std::size_t i = 0; i < bets.size(); i++) {
+    EXPECT_EQ(bets[i], records[2048 + i].bet);
+  }
+  std::filesystem::remove(path);
+}
+
+TEST(HandHistoryTest, RejectsBrokenLogs) {
+  const std::string path = tempLog("handHistory_broken.bin");
+  {
+    std::ofstream file(path, std::ios::binary);
+    file << "PKHX and some more bytes";
+  }
+  EXPECT_THROW(HandHistoryReader reader(path), std::runtime_error);
+
+  {
+    HandHistoryWriter writer(path);
+    for (const auto &record : randomRecords(100)) {
+      writer.append(record);
+    }
+  }
+  std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+  EXPECT_THROW(HandHistoryReader reader(path), std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+TEST(HandHistoryTest, GameLogsEveryAction) {
+  const std::string path = tempLog("handHistory_game.bin");
+  gameSettings settings;
+  playersPool players = makePlayers(3, settings.startingChips);
+  positions pos{0, 2, 1};
+
+  std::size_t decisions = 0;
+  {
+    HandHistoryWriter writer(path);
+    for (int hand = 0; hand < 2; hand++) {
+      HeadlessGame game(players, settings, pos, 99);
+      game.setHandHistory(&writer);
+      for (position seat = 0; seat < 3; seat++) {
+        game.setStrategy(seat, [&decisions](const turnInfo &) {
+          decisions++;
+          return Action{actions::fold, 0, 0};
+        });
+      }
+      game.simulateHand();
+    }
+  }
+
+  // Both blinds plus every decision, every record knows its hand.
+  HandHistoryReader reader(path);
+  EXPECT_EQ(reader.size(), 2 * 2 + decisions);
+  std::vector<HistoryRecord> records;
+  reader.readBlock(0, records);
+  EXPECT_EQ(records.front().hand, 0u);
+  EXPECT_EQ(records.back().hand, 1u);
+  EXPECT_EQ(records.front().action, static_cast<std::uint8_t>(actions::bet));
+  EXPECT_EQ(records.back().action, static_cast<std::uint8_t>(actions::fold));
+  std::filesystem::remove(path);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,85 @@
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+import logger;
+
+#include <gtest/gtest.h>
+
+// Points the logger at a string for one test and back at std::clog after.
+class LoggerTest : public ::testing::Test {
+protected:
+  std::ostringstream out;
+
+  void SetUp() override { Logger::instance().setSink(out); }
+  void TearDown() override { Logger::instance().setSink(std::clog); }
+
+  std::string written() {
+    Logger::instance().flush();
+    return out.str();
+  }
+};
+
+TEST_F(LoggerTest, FormatsArgumentsIntoThePlaceholders) {
+  const std::string name = "Alice";
+  Logger::instance().write(LogLevel::info, "seat {} ({}) bet {}, all in {}",
+                           3, name, 1250u, false);
+  const std::string line = written();
+  EXPECT_NE(line.find("[INFO "), std::string::npos);
+  EXPECT_NE(line.find("us] seat 3 (Alice) bet 1250, all in false\n"),
+            std::string::npos);
+}
+
+TEST_F(LoggerTest, CutsLongStrings) {
+  const std::string longName(100, 'x');
+  Logger::instance().write(LogLevel::warn, "{}|", longName);
+  EXPECT_NE(written().find(std::string(LOG_TEXT_BYTES, 'x') + "|\n"),
+            std::string::npos);
+}
+
+TEST_F(LoggerTest, LevelsBelowTheCompiledLevelWriteNothing) {
+  Logger::instance().flush();
+  const std::uint64_t before = Logger::instance().written();
+  logTrace("trace {}", 1);
+  logDebug("debug {}", 2);
+  logError("error {}", 3);
+  Logger::instance().flush();
+  const std::uint64_t expected = logEnabled(LogLevel::trace) +
+                                 logEnabled(LogLevel::debug) +
+                                 logEnabled(LogLevel::error);
+  EXPECT_EQ(Logger::instance().written() - before, expected);
+  if constexpr (not logEnabled(LogLevel::debug)) {
+    EXPECT_EQ(out.str().find("debug"), std::string::npos);
+  }
+}
+
+TEST_F(LoggerTest, EveryThreadsRecordsArrive) {
+  constexpr int THREADS = 4;
+  constexpr int RECORDS = 500;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; t++) {
+    threads.emplace_back([t] {
+      for (int i = 0; i < RECORDS; i++) {
+        Logger::instance().write(LogLevel::info, "thread {} record {}", t, i);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  const std::string lines = written();
+  std::size_t count = 0;
+  for (std::size_t at = lines.find("thread "); at != std::string::npos;
+       at = lines.find("thread ", at + 1)) {
+    count++;
+  }
+  EXPECT_EQ(count + Logger::instance().dropped(), THREADS * RECORDS);
+  EXPECT_NE(lines.find("thread 3 record 499\n"), std::string::npos);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
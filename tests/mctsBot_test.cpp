@@ -0,0 +1,155 @@
+#include <chrono>
+#include <cstdint>
+#include <memory>
+import cards;
+import player;
+import game;
+import mctsBot;
+
+#include <gtest/gtest.h>
+#include "testHelpers.hpp"
+
+/* The state of the small blind after the dealer went all in, three seats:
+ * dealer 0, small blind 1, big blind 2.
+ */
+static GameState facingAllIn() {
+  playersPool players = makePlayers(3);
+  gameSettings settings;
+  HeadlessGame game(players, settings, positions{0, 2, 1}, 4);
+  GameState state;
+  game.setStrategy(0, [](const turnInfo &info) {
+    return Action{actions::allIn, info.validMoves.minAmount(actions::allIn),
+                  info.currentRound};
+  });
+  for (position seat = 1; seat < 3; seat++) {
+    game.setStrategy(seat, [&](const turnInfo &info) {
+      if (state.isTerminal()) {
+        state = info.state();
+      }
+      return Action{actions::fold, 0, info.currentRound};
+    });
+  }
+  game.simulateHand();
+  return state;
+}
+
+static MctsSettings fixedIterations(std::uint64_t iterations) {
+  MctsSettings settings;
+  settings.budget = std::chrono::seconds(60);
+  settings.iterations = iterations;
+  settings.seed = 7;
+  return settings;
+}
+
+TEST(MctsBotTest, SearchMovesFollowTheLegalMoves) {
+  GameState state = facingAllIn();
+  ASSERT_EQ(state.actor, 1);
+  const SearchMoves facing = searchMoves(state);
+  // Fold, call the all in or go all in, the raises are above the stack.
+  ASSERT_EQ(facing.count, 3);
+  EXPECT_EQ(facing.moves[0].action, actions::fold);
+  EXPECT_EQ(facing.moves[1].action, actions::call);
+  EXPECT_EQ(facing.moves[1].bet, 100u);
+  EXPECT_EQ(facing.moves[2].action, actions::allIn);
+
+  // Before anyone acts the dealer may also raise the minimum or the pot.
+  playersPool players = makePlayers(3);
+  gameSettings settings;
+  HeadlessGame game(players, settings, positions{0, 2, 1}, 4);
+  SearchMoves first;
+  for (position seat = 0; seat < 3; seat++) {
+    game.setStrategy(seat, [&](const turnInfo &info) {
+      if (first.count == 0) {
+        first = searchMoves(info.state());
+      }
+      return Action{actions::fold, 0, info.currentRound};
+    });
+  }
+  game.simulateHand();
+  ASSERT_EQ(first.count, 5);
+  EXPECT_EQ(first.moves[0].action, actions::fold);
+  EXPECT_EQ(first.moves[1].action, actions::call);
+  EXPECT_EQ(first.moves[2].action, actions::raise);
+  EXPECT_EQ(first.moves[2].bet, 20u);
+  EXPECT_EQ(first.moves[3].action, actions::raise);
+  EXPECT_EQ(first.moves[3].bet, 35u); // 10 to call, then the pot of 25.
+  EXPECT_EQ(first.moves[4].action, actions::allIn);
+}
+
+TEST(MctsBotTest, CallsWithAcesAndFoldsTrash) {
+  MctsBot bot(fixedIterations(4000), 1);
+  GameState state = facingAllIn();
+  state.holeCards[1] = {Card(Suit::Spades, Rank::Ace),
+                        Card(Suit::Hearts, Rank::Ace)};
+  // Calling and going all in put in the same chips.
+  EXPECT_NE(bot.decide(state).action, actions::fold);
+
+  state.holeCards[1] = {Card(Suit::Spades, Rank::Seven),
+                        Card(Suit::Hearts, Rank::Two)};
+  EXPECT_EQ(bot.decide(state).action, actions::fold);
+}
+
+TEST(MctsBotTest, DoesNotLookAtTheCardsOfOthers) {
+  // A strategy gets the hand without the cards of the other seats.
+  GameState state = facingAllIn();
+  const CardSet own(state.holeCards[1]);
+  EXPECT_EQ(own.size(), 2);
+  EXPECT_EQ(state.deck.size(), 52u - 2u);
+  for (int seat : {0, 2}) {
+    for (const Card &card : state.holeCards[seat]) {
+      EXPECT_EQ(card.toIndex(), Card().toIndex());
+    }
+  }
+
+  GameState swapped = state;
+  swapped.holeCards[0] = {Card(Suit::Clubs, Rank::Two),
+                          Card(Suit::Diamonds, Rank::Three)};
+  swapped.holeCards[2] = {Card(Suit::Clubs, Rank::King),
+                          Card(Suit::Diamonds, Rank::King)};
+  MctsBot bot(fixedIterations(500), 1);
+  MctsBot other(fixedIterations(500), 1);
+  const MctsResult result = bot.search(state);
+  const MctsResult swappedResult = other.search(swapped);
+  EXPECT_EQ(result.visits, swappedResult.visits);
+  EXPECT_EQ(result.iterations, 500u);
+}
+
+TEST(MctsBotTest, ReturnsWhenTheBudgetRunsOut) {
+  MctsSettings settings;
+  settings.budget = std::chrono::milliseconds(20);
+  MctsBot bot(settings, 2);
+  const auto start = std::chrono::steady_clock::now();
+  const MctsResult result = bot.search(facingAllIn());
+  const auto took = std::chrono::steady_clock::now() - start;
+  EXPECT_GT(result.iterations, 0u);
+  EXPECT_GE(took, std::chrono::milliseconds(20));
+}
+
+TEST(MctsBotTest, PlaysHandsAsAStrategy) {
+  MctsSettings settings;
+  settings.budget = std::chrono::milliseconds(1);
+  auto bot = std::make_shared<MctsBot>(settings, 1);
+  playersPool players = makePlayers(4);
+  gameSettings gameRules;
+  HeadlessGame game(players, gameRules, positions{}, 0);
+  for (position seat = 0; seat < 4; seat++) {
+    game.setStrategy(seat, mctsStrategy(bot));
+  }
+  for (std::uint64_t hand = 0; hand < 5; hand++) {
+    game.newHand({static_cast<position>(hand % 4),
+                  static_cast<position>((hand + 2) % 4),
+                  static_cast<position>((hand + 1) % 4)},
+                 hand);
+    game.simulateHand();
+  }
+  money total = 0;
+  for (const auto &player : players) {
+    total += player->getChips();
+  }
+  EXPECT_EQ(total, 400u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,120 @@
+#include <array>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+import cards;
+import prng;
+import threadPool;
+import preflopTable;
+
+#include <gtest/gtest.h>
+
+static const std::string TABLE_PATH = "preflopTable_test.bin";
+
+static int hand(Rank high, Rank low, bool suited) {
+  return startingHand(Card(Suit::Spades, high),
+                      Card(suited ? Suit::Spades : Suit::Hearts, low));
+}
+
+TEST(PreflopTableTest, StartingHandsCoverEveryCombination) {
+  std::array<int, STARTING_HANDS> combos{};
+  for (int a = 0; a < DECK_SIZE; a++) {
+    for (int b = a + 1; b < DECK_SIZE; b++) {
+      int index = startingHand(Card::fromIndex(a), Card::fromIndex(b));
+      ASSERT_GE(index, 0);
+      ASSERT_LT(index, STARTING_HANDS);
+      EXPECT_EQ(index, startingHand(Card::fromIndex(b), Card::fromIndex(a)));
+      combos[index]++;
+    }
+  }
+  for (int index = 0; index < STARTING_HANDS; index++) {
+    EXPECT_EQ(combos[index], startingHandCombos(index));
+  }
+  EXPECT_EQ(startingHandName(hand(Rank::Ace, Rank::Ace, false)), "AA");
+  EXPECT_EQ(startingHandName(hand(Rank::Ace, Rank::King, true)), "AKs");
+  EXPECT_EQ(startingHandName(hand(Rank::King, Rank::Ace, false)), "AKo");
+  EXPECT_EQ(startingHandName(hand(Rank::Seven, Rank::Two, false)), "72o");
+}
+
+TEST(PreflopTableTest, SamplesKnownEquities) {
+  Xoshiro256 rng(3);
+  const int aces = hand(Rank::Ace, Rank::Ace, false);
+  const int kings = hand(Rank::King, Rank::King, false);
+  EXPECT_NEAR(sampleHeadsUp(aces, kings, 50000, rng), 0.82, 0.01);
+  EXPECT_NEAR(sampleHeadsUp(kings, aces, 50000, rng), 0.18, 0.01);
+  EXPECT_NEAR(sampleVersusRandom(aces, 2, 50000, rng), 0.85, 0.01);
+  EXPECT_NEAR(sampleVersusRandom(aces, 6, 50000, rng), 0.49, 0.01);
+}
+
+TEST(PreflopTableTest, WritesAndMapsTheTable) {
+  ThreadPool pool(2);
+  PreflopTableData data = generatePreflopTable(pool, 100, 9);
+  writePreflopTable(TABLE_PATH, data);
+
+  PreflopTable table(TABLE_PATH);
+  EXPECT_EQ(table.samples(), 100u);
+  EXPECT_EQ(table.seed(), 9u);
+  for (int hero = 0; hero < STARTING_HANDS; hero++) {
+    for (int villain = 0; villain < STARTING_HANDS; villain++) {
+      ASSERT_EQ(table.headsUp(hero, villain),
+                data.headsUp[hero * STARTING_HANDS + villain]);
+      ASSERT_NEAR(table.headsUp(hero, villain) + table.headsUp(villain, hero),
+                  1.0f, 1e-6);
+    }
+    for (int players = MIN_TABLE_PLAYERS; players <= MAX_TABLE_PLAYERS;
+         players++) {
+      ASSERT_EQ(table.versusRandom(hero, players),
+                data.versusRandom[hero * TABLE_PLAYER_COUNTS + players - 2]);
+    }
+  }
+  const Card ace(Suit::Clubs, Rank::Ace);
+  const Card otherAce(Suit::Hearts, Rank::Ace);
+  EXPECT_EQ(table.versusRandom(ace, otherAce, 3),
+            table.versusRandom(hand(Rank::Ace, Rank::Ace, false), 3));
+
+  // Same seed, same table.
+  PreflopTableData again = generatePreflopTable(pool, 100, 9);
+  EXPECT_EQ(again.headsUp, data.headsUp);
+  EXPECT_EQ(again.versusRandom, data.versusRandom);
+  std::remove(TABLE_PATH.c_str());
+}
+
+TEST(PreflopTableTest, RejectsBrokenFiles) {
+  EXPECT_THROW(PreflopTable("does_not_exist.bin"), std::runtime_error);
+
+  ThreadPool pool(1);
+  writePreflopTable(TABLE_PATH, generatePreflopTable(pool, 1, 1));
+  std::string bytes;
+  {
+    std::ifstream in(TABLE_PATH, std::ios::binary);
+    bytes.assign(std::istreambuf_iterator<char>(in), {});
+  }
+  auto writeBytes = [](const std::string &content) {
+    std::ofstream out(TABLE_PATH, std::ios::binary | std::ios::trunc);
+    out << content;
+  };
+
+  std::string flipped = bytes;
+  flipped[1000] ^= 1;
+  writeBytes(flipped);
+  EXPECT_THROW(PreflopTable table(TABLE_PATH), std::runtime_error);
+
+  writeBytes(bytes.substr(0, bytes.size() - 4));
+  EXPECT_THROW(PreflopTable table(TABLE_PATH), std::runtime_error);
+
+  std::string newer = bytes;
+  newer[4] = 2;
+  writeBytes(newer);
+  EXPECT_THROW(PreflopTable table(TABLE_PATH), std::runtime_error);
+
+  writeBytes("PKHH");
+  EXPECT_THROW(PreflopTable table(TABLE_PATH), std::runtime_error);
+  std::remove(TABLE_PATH.c_str());
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,53 @@
+#include <cstdint>
+#include <set>
+import prng;
+
+#include <gtest/gtest.h>
+
+// Reference outputs published with the original implementations.
+TEST(PrngTest, SplitMix64ReferenceOutput) {
+  SplitMix64 g(0);
+  EXPECT_EQ(g(), 0xE220A8397B1DCDAFull);
+}
+
+TEST(PrngTest, Xoshiro256ReferenceOutput) {
+  Xoshiro256 g = Xoshiro256::fromState(1, 2, 3, 4);
+  EXPECT_EQ(g(), 11520u);
+  EXPECT_EQ(g(), 0u);
+  EXPECT_EQ(g(), 1509978240u);
+}
+
+TEST(PrngTest, Pcg32ReferenceOutput) {
+  Pcg32 g(42, 54);
+  EXPECT_EQ(g(), 0xA15C02B7u);
+  EXPECT_EQ(g(), 0x7B47F409u);
+  EXPECT_EQ(g(), 0xBA1D3330u);
+}
+
+TEST(PrngTest, StreamsDiffer) {
+  Xoshiro256 first(9, 0);
+  Xoshiro256 second(9, 1);
+  Xoshiro256 again(9, 0);
+  std::uint64_t a = first();
+  EXPECT_NE(a, second());
+  EXPECT_EQ(a, again());
+}
+
+TEST(PrngTest, UniformBelowStaysInRange) {
+  Xoshiro256 g64(3);
+  Pcg32 g32(3);
+  std::set<std::uint32_t> seen;
+  for (int i = 0; i < 10000; i++) {
+    std::uint32_t a = uniformBelow(g64, 52);
+    std::uint32_t b = uniformBelow(g32, 52);
+    ASSERT_LT(a, 52u);
+    ASSERT_LT(b, 52u);
+    seen.insert(a);
+  }
+  EXPECT_EQ(seen.size(), 52u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
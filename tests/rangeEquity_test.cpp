@@ -0,0 +1,131 @@
+#include <stdexcept>
+#include <vector>
+import cards;
+import threadPool;
+import equity;
+import rangeEquity;
+
+#include <gtest/gtest.h>
+
+static const std::vector<Card> FLOP = {Card(Suit::Spades, Rank::Two),
+                                       Card(Suit::Hearts, Rank::Seven),
+                                       Card(Suit::Diamonds, Rank::Jack)};
+
+TEST(RangeEquityTest, CombosRoundTrip) {
+  for (int combo = 0; combo < COMBOS; combo++) {
+    const auto [first, second] = comboCards(combo);
+    ASSERT_LT(first.toIndex(), second.toIndex());
+    EXPECT_EQ(comboIndex(first, second), combo);
+    EXPECT_EQ(comboIndex(second, first), combo);
+  }
+}
+
+TEST(RangeEquityTest, ParsesHands) {
+  EXPECT_DOUBLE_EQ(Range::parse("AA").totalWeight(), 6);
+  EXPECT_DOUBLE_EQ(Range::parse("AKs").totalWeight(), 4);
+  EXPECT_DOUBLE_EQ(Range::parse("AKo").totalWeight(), 12);
+  EXPECT_DOUBLE_EQ(Range::parse("AK, QQ:0.5, 7h2c").totalWeight(), 20);
+  EXPECT_DOUBLE_EQ(Range::full().totalWeight(), COMBOS);
+
+  Range range = Range::parse("T9s");
+  EXPECT_EQ(range.weight(Card(Suit::Hearts, Rank::Ten),
+                         Card(Suit::Hearts, Rank::Nine)),
+            1.0f);
+  EXPECT_EQ(range.weight(Card(Suit::Hearts, Rank::Ten),
+                         Card(Suit::Spades, Rank::Nine)),
+            0.0f);
+
+  EXPECT_THROW(Range::parse("AX"), std::invalid_argument);
+  EXPECT_THROW(Range::parse("AAs"), std::invalid_argument);
+  EXPECT_THROW(Range::parse("AK:2"), std::invalid_argument);
+  EXPECT_THROW(Range::parse("AhAh"), std::invalid_argument);
+}
+
+TEST(RangeEquityTest, DeadCardsRemoveCombos) {
+  const Range aces = Range::parse("AA");
+  const CardSet dead{Card(Suit::Spades, Rank::Ace)};
+  EXPECT_DOUBLE_EQ(aces.withoutDead(dead).totalWeight(), 3);
+  EXPECT_DOUBLE_EQ(Range::full().withoutDead(CardSet(FLOP)).totalWeight(),
+                   1176); // 49 choose 2
+}
+
+TEST(RangeEquityTest, MatchesHandAgainstHand) {
+  ThreadPool pool(2);
+  const std::vector<Card> hero = {Card(Suit::Hearts, Rank::Ace),
+                                  Card(Suit::Spades, Rank::King)};
+  const std::vector<Card> villain = {Card(Suit::Clubs, Rank::Jack),
+                                     Card(Suit::Hearts, Rank::Ten)};
+  Range heroRange;
+  heroRange.set(hero[0], hero[1], 1.0f);
+  Range villainRange;
+  villainRange.set(villain[0], villain[1], 0.25f);
+
+  const RangeEquityResult ranged =
+      rangeEquity(heroRange, villainRange, FLOP, pool);
+  const EquityResult exact = exactEquity({hero, villain}, FLOP);
+  // 49 choose 2, exactEquity only visits the 990 without the hole cards.
+  EXPECT_EQ(ranged.runouts, 1176u);
+  EXPECT_NEAR(ranged.equity, exact.equity[0], 1e-6);
+  EXPECT_NEAR(ranged.win, exact.win[0], 1e-6);
+  EXPECT_NEAR(ranged.comboEquity[comboIndex(hero[0], hero[1])],
+              exact.equity[0], 1e-6);
+}
+
+TEST(RangeEquityTest, WeightsAverageOverCombos) {
+  ThreadPool pool(2);
+  std::vector<Card> turn = FLOP;
+  turn.push_back(Card(Suit::Clubs, Rank::Four));
+  const Range hero = Range::parse("QQ, AJs:0.5");
+  const Range villain = Range::parse("JT, 77:0.25");
+
+  const RangeEquityResult result = rangeEquity(hero, villain, turn, pool);
+
+  // Every pair of combos that can be dealt together, by exact equity.
+  const CardSet known(turn);
+  double share = 0;
+  double weight = 0;
+  for (int h = 0; h < COMBOS; h++) {
+    for (int v = 0; v < COMBOS; v++) {
+      const auto [h1, h2] = comboCards(h);
+      const auto [v1, v2] = comboCards(v);
+      const double w = hero.weight(h) * villain.weight(v);
+      const CardSet cards{h1, h2, v1, v2};
+      if (w == 0 or cards.size() != 4 or !(cards & known).empty()) {
+        continue;
+      }
+      share += w * exactEquity({{h1, h2}, {v1, v2}}, turn).equity[0];
+      weight += w;
+    }
+  }
+  ASSERT_GT(weight, 0);
+  EXPECT_NEAR(result.equity, share / weight, 1e-5);
+
+  const RangeEquityResult back = rangeEquity(villain, hero, turn, pool);
+  EXPECT_NEAR(result.equity + back.equity, 1.0, 1e-5);
+}
+
+TEST(RangeEquityTest, IndependentOfThreads) {
+  const Range hero = Range::parse("AA, KK, AK, 98s");
+  const Range villain = Range::full();
+  ThreadPool one(1);
+  ThreadPool four(4);
+  const RangeEquityResult a = rangeEquity(hero, villain, FLOP, one);
+  const RangeEquityResult b = rangeEquity(hero, villain, FLOP, four);
+  EXPECT_EQ(a.equity, b.equity);
+  EXPECT_EQ(a.comboEquity, b.comboEquity);
+  EXPECT_GT(a.equity, 0.5);
+}
+
+TEST(RangeEquityTest, RejectsInvalidBoards) {
+  ThreadPool pool(1);
+  const Range range = Range::full();
+  EXPECT_THROW(rangeEquity(range, range, {FLOP[0]}, pool),
+               std::invalid_argument);
+  EXPECT_THROW(rangeEquity(range, range, FLOP, pool, {FLOP[1]}),
+               std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+import player;
+import game;
+import prng;
+import replay;
+
+#include <gtest/gtest.h>
+#include "testHelpers.hpp"
+
+// Records `hands` random hands at a six handed table.
+static std::vector<HandRecord> recordRandomHands(int hands,
+                                                 std::uint64_t seed) {
+  gameSettings settings;
+  playersPool players = makePlayers(6, settings.startingChips);
+
+  Xoshiro256 decisions(seed);
+  std::vector<HandRecord> records;
+  for (int hand = 0; hand < hands; hand++) {
+    for (auto &player : players) {
+      player->setChips(settings.startingChips + 10 * (hand % 7));
+    }
+    positions pos;
+    pos.dealerPosition = hand % 6;
+    pos.posSB = (hand + 1) % 6;
+    pos.posBB = (hand + 2) % 6;
+
+    HeadlessGame game(players, settings, pos, seed + hand);
+    for (position seat = 0; seat < 6; seat++) {
+      game.setStrategy(seat, randomStrategy(decisions));
+    }
+    records.push_back(recordHand(game));
+  }
+  return records;
+}
+
+TEST(ReplayTest, ReplaysRecordedHands) {
+  for (const auto &record : recordRandomHands(2000, 11)) {
+    ASSERT_FALSE(record.actions.empty());
+    ASSERT_EQ(replayHand(record), record.endStacks);
+  }
+}
+
+TEST(ReplayTest, LogRoundTrip) {
+  std::vector<HandRecord> records = recordRandomHands(500, 3);
+  std::stringstream log;
+  ReplayWriter writer(log);
+  for (const auto &record : records) {
+    writer.write(record);
+  }
+
+  ReplayReader reader(log);
+  HandRecord read;
+  for (const auto &record : records) {
+    ASSERT_TRUE(reader.next(read));
+    EXPECT_EQ(read.seed, record.seed);
+    EXPECT_EQ(read.minBet, record.minBet);
+    EXPECT_EQ(read.pos.dealerPosition, record.pos.dealerPosition);
+    EXPECT_EQ(read.activeSeats, record.activeSeats);
+    EXPECT_EQ(read.startStacks, record.startStacks);
+    EXPECT_EQ(read.endStacks, record.endStacks);
+    ASSERT_EQ(read.actions.size(), record.actions.size());
+    for (std::size_t i = 0; i < read.actions.size(); i++) {
+      EXPECT_EQ(read.actions[i].seat, record.actions[i].seat);
+      EXPECT_EQ(read.actions[i].action, record.actions[i].action);
+      EXPECT_EQ(read.actions[i].bet, record.actions[i].bet);
+    }
+    EXPECT_EQ(replayHand(read), record.endStacks);
+  }
+  EXPECT_FALSE(reader.next(read));
+}
+
+TEST(ReplayTest, DetectsDivergence) {
+  HandRecord record = recordRandomHands(1, 5).front();
+
+  HandRecord missing = record;
+  missing.actions.pop_back();
+  EXPECT_THROW(replayHand(missing), ReplayMismatch);
+
+  HandRecord otherSeed = record;
+  otherSeed.seed++;
+  otherSeed.actions.push_back(record.actions.back());
+  otherSeed.endStacks.front() += 1;
+  EXPECT_THROW(replayHand(otherSeed), ReplayMismatch);
+}
+
+TEST(ReplayTest, RejectsBrokenLogs) {
+  std::stringstream notALog("PKRX\x01");
+  EXPECT_THROW(ReplayReader reader(notALog), std::runtime_error);
+
+  std::stringstream log;
+  ReplayWriter writer(log);
+  writer.write(recordRandomHands(1, 8).front());
+  std::string truncated = log.str();
+  truncated.pop_back();
+
+  std::stringstream truncatedLog(truncated);
+  ReplayReader reader(truncatedLog);
+  HandRecord record;
+  EXPECT_THROW(reader.next(record), std::runtime_error);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+import cards;
+import player;
+import game;
+import ruleBot;
+
+#include <gtest/gtest.h>
+#include "testHelpers.hpp"
+
+// Made once, sampling the tables takes a moment.
+static const std::shared_ptr<const RuleBot> &sharedBot() {
+  static const auto bot = std::make_shared<const RuleBot>();
+  return bot;
+}
+
+static Player heroWith(Card first, Card second) {
+  Player hero("Hero", 100);
+  hero.receiveCards(first);
+  hero.receiveCards(second);
+  return hero;
+}
+
+/* Heads-up preflop, the hero on the button facing a raise to 40. */
+static turnInfo facingRaise(const Player &hero, const LegalMoves &moves) {
+  return turnInfo{hero,   0, moves, std::span<const Card>{}, 50, 40,
+                  gameStates::preFlop, 1, positions{0, 1, 0}, 2, 2};
+}
+
+static LegalMoves raiseMoves() {
+  LegalMoves moves;
+  moves.allow(actions::fold, 0, 0);
+  moves.allow(actions::call, 40, 40);
+  moves.allow(actions::raise, 50, 100);
+  moves.allow(actions::allIn, 100, 100);
+  return moves;
+}
+
+TEST(RuleBotTest, EquityOrdersHands) {
+  const RuleBot &bot = *sharedBot();
+  const std::vector<Card> aces = {Card(Suit::Spades, Rank::Ace),
+                                  Card(Suit::Hearts, Rank::Ace)};
+  const std::vector<Card> trash = {Card(Suit::Spades, Rank::Seven),
+                                   Card(Suit::Hearts, Rank::Two)};
+  EXPECT_NEAR(bot.equity(aces, {}, 2), 0.85, 0.05);
+  EXPECT_LT(bot.equity(trash, {}, 2), 0.4);
+  EXPECT_LT(bot.equity(aces, {}, 6), bot.equity(aces, {}, 2));
+
+  const std::vector<Card> board = {Card(Suit::Clubs, Rank::Ace),
+                                   Card(Suit::Diamonds, Rank::Ace),
+                                   Card(Suit::Clubs, Rank::Nine)};
+  EXPECT_GT(bot.equity(aces, board, 2), 0.99);
+  EXPECT_LT(bot.equity(trash, board, 2), bot.equity(aces, board, 2));
+  EXPECT_LT(bot.equity(aces, board, 4), bot.equity(aces, board, 2));
+}
+
+TEST(RuleBotTest, RaisesAcesAndFoldsTrash) {
+  const RuleBot &bot = *sharedBot();
+  const LegalMoves moves = raiseMoves();
+
+  Player aces = heroWith(Card(Suit::Spades, Rank::Ace),
+                         Card(Suit::Hearts, Rank::Ace));
+  const Action raise = bot.decide(facingRaise(aces, moves));
+  EXPECT_EQ(raise.action, actions::raise);
+  EXPECT_GE(raise.bet, 50u);
+  EXPECT_LE(raise.bet, 100u);
+
+  Player trash = heroWith(Card(Suit::Spades, Rank::Seven),
+                          Card(Suit::Hearts, Rank::Two));
+  EXPECT_EQ(bot.decide(facingRaise(trash, moves)).action, actions::fold);
+}
+
+TEST(RuleBotTest, ChecksInsteadOfFolding) {
+  LegalMoves moves;
+  moves.allow(actions::fold, 0, 0);
+  moves.allow(actions::check, 0, 0);
+  moves.allow(actions::bet, 10, 100);
+  moves.allow(actions::allIn, 100, 100);
+  Player trash = heroWith(Card(Suit::Spades, Rank::Seven),
+                          Card(Suit::Hearts, Rank::Two));
+  const std::vector<Card> board = {Card(Suit::Clubs, Rank::Ace),
+                                   Card(Suit::Diamonds, Rank::King),
+                                   Card(Suit::Clubs, Rank::Nine)};
+  turnInfo info{trash, 1, moves, board, 40, 0, gameStates::flop, 2,
+                positions{0, 1, 0}, 2, 2};
+  EXPECT_EQ(sharedBot()->decide(info).action, actions::check);
+}
+
+/* Quads or a royal flush on the river are what every hand plays, holding
+ * them is no reason to bet or raise.
+ */
+TEST(RuleBotTest, DoesNotValueBetAPlayedBoard) {
+  const RuleBot &bot = *sharedBot();
+  const std::vector<Card> royal = {
+      Card(Suit::Spades, Rank::Ace), Card(Suit::Spades, Rank::King),
+      Card(Suit::Spades, Rank::Queen), Card(Suit::Spades, Rank::Jack),
+      Card(Suit::Spades, Rank::Ten)};
+  const std::vector<Card> quads = {
+      Card(Suit::Spades, Rank::Nine), Card(Suit::Hearts, Rank::Nine),
+      Card(Suit::Diamonds, Rank::Nine), Card(Suit::Clubs, Rank::Nine),
+      Card(Suit::Hearts, Rank::Two)};
+  Player hero = heroWith(Card(Suit::Clubs, Rank::Five),
+                         Card(Suit::Diamonds, Rank::Three));
+  EXPECT_NEAR(bot.equity(hero.getHand(), royal, 2), 0.5, 1e-6);
+  EXPECT_LT(bot.equity(hero.getHand(), quads, 2), 0.5);
+
+  LegalMoves checked;
+  checked.allow(actions::check, 0, 0);
+  checked.allow(actions::bet, 10, 100);
+  checked.allow(actions::allIn, 100, 100);
+  for (const std::vector<Card> *board : {&royal, &quads}) {
+    const turnInfo facing{hero, 0, raiseMoves(), *board, 50, 40,
+                          gameStates::river, 1, positions{0, 1, 0}, 2, 2};
+    EXPECT_NE(bot.decide(facing).action, actions::raise);
+    const turnInfo first{hero, 0, checked, *board, 50, 0,
+                         gameStates::river, 1, positions{0, 1, 0}, 2, 2};
+    EXPECT_EQ(bot.decide(first).action, actions::check);
+  }
+}
+
+/* Four hearts on the turn don't make a flush for everyone, a set without a
+ * heart still beats most hands and doesn't fold to a small bet.
+ */
+TEST(RuleBotTest, KeepsASetOnAFourFlushBoard) {
+  const std::vector<Card> turn = {
+      Card(Suit::Hearts, Rank::Nine), Card(Suit::Hearts, Rank::Six),
+      Card(Suit::Hearts, Rank::Three), Card(Suit::Hearts, Rank::King)};
+  Player hero = heroWith(Card(Suit::Clubs, Rank::Nine),
+                         Card(Suit::Diamonds, Rank::Nine));
+  LegalMoves moves;
+  moves.allow(actions::fold, 0, 0);
+  moves.allow(actions::call, 10, 10);
+  moves.allow(actions::raise, 20, 100);
+  moves.allow(actions::allIn, 100, 100);
+  const turnInfo info{hero, 0, moves, turn, 100, 10,
+                      gameStates::turn, 1, positions{0, 1, 0}, 2, 2};
+  const actions act = sharedBot()->decide(info).action;
+  EXPECT_TRUE(act == actions::call or act == actions::raise);
+  EXPECT_GT(sharedBot()->equity(hero.getHand(), turn, 2), 0.5);
+}
+
+TEST(RuleBotTest, PlaysLegalMovesAtFullTables) {
+  const strategy rules = ruleStrategy(sharedBot());
+  playersPool players = makePlayers(6, 200);
+  gameSettings settings;
+  HeadlessGame game(players, settings, positions{}, 0);
+  int illegal = 0;
+  for (position seat = 0; seat < 6; seat++) {
+    game.setStrategy(seat, [&](const turnInfo &info) {
+      const Action action = rules(info);
+      const LegalMoves &moves = info.validMoves;
+      illegal += !moves.isLegal(action.action) or
+                 action.bet < moves.minAmount(action.action) or
+                 action.bet > moves.maxAmount(action.action);
+      return action;
+    });
+  }
+  for (std::uint64_t hand = 0; hand < 300; hand++) {
+    for (auto &player : players) {
+      player->setChips(200);
+    }
+    game.newHand({static_cast<position>(hand % 6),
+                  static_cast<position>((hand + 2) % 6),
+                  static_cast<position>((hand + 1) % 6)},
+                 hand);
+    game.simulateHand();
+    money total = 0;
+    for (const auto &player : players) {
+      total += player->getChips();
+    }
+    ASSERT_EQ(total, 1200u);
+  }
+  EXPECT_EQ(illegal, 0);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
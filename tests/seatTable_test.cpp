@@ -0,0 +1,68 @@
+#include <stdexcept>
+import player;
+import seatTable;
+
+#include <gtest/gtest.h>
+#include "testHelpers.hpp"
+
+TEST(SeatTableTest, CountsAndNextSeatFollowTheMasks) {
+  auto players = makePlayers(6);
+  players[2]->setIsActive(false);
+  players[4]->setHasFolded(true);
+
+  SeatTable seats;
+  seats.load(players);
+  EXPECT_EQ(seats.size(), 6);
+  EXPECT_EQ(seats.activeCount(), 5);
+  EXPECT_EQ(seats.inHandCount(), 4);
+  EXPECT_EQ(seats.inHandSeats(), 0b101011u);
+
+  EXPECT_EQ(seats.nextInHand(1), 3);
+  EXPECT_EQ(seats.nextInHand(3), 5);
+  EXPECT_EQ(seats.nextInHand(5), 0);
+  EXPECT_EQ(seats.firstInHandFrom(4), 5);
+
+  seats.fold(0);
+  seats.fold(1);
+  seats.fold(3);
+  EXPECT_EQ(seats.nextInHand(5), 5);
+  seats.fold(5);
+  EXPECT_EQ(seats.nextInHand(5), -1);
+}
+
+TEST(SeatTableTest, BettingMatchesPlayer) {
+  auto players = makePlayers(2);
+  SeatTable seats;
+  seats.load(players);
+
+  EXPECT_EQ(seats.bet(0, 10), 10u);
+  EXPECT_EQ(seats.raise(0, 30), 20u);
+  EXPECT_EQ(seats.betOf(0), 30u);
+  EXPECT_EQ(seats.chipsOf(0), 70u);
+  EXPECT_THROW(seats.bet(0, 71), std::invalid_argument);
+  EXPECT_THROW(seats.raise(0, 101), std::invalid_argument);
+
+  EXPECT_EQ(seats.call(1, 30), 30u);
+  EXPECT_EQ(seats.call(1, 500), 70u);
+  EXPECT_EQ(seats.chipsOf(1), 0u);
+
+  EXPECT_EQ(seats.committedOf(0), 30u);
+  EXPECT_EQ(seats.committedOf(1), 100u);
+  seats.fold(0);
+  seats.addChips(1, 130);
+  seats.store(players);
+  EXPECT_TRUE(players[0]->hasPlayerFolded());
+  EXPECT_FALSE(players[1]->hasPlayerFolded());
+  EXPECT_EQ(players[1]->getChips(), 130u);
+  EXPECT_EQ(players[1]->getCurrentBet(), 100u);
+
+  seats.resetHand();
+  EXPECT_EQ(seats.inHandCount(), 2);
+  EXPECT_EQ(seats.betOf(1), 0u);
+  EXPECT_EQ(seats.committedOf(1), 0u);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
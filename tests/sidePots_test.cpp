@@ -0,0 +1,144 @@
+#include <array>
+#include <vector>
+import player;
+import bestHand;
+import game;
+import prng;
+import seatTable;
+import sidePots;
+
+#include <gtest/gtest.h>
+#include "testHelpers.hpp"
+
+// Three all-ins of different size and a caller make a main and 2 side pots.
+TEST(SidePotsTest, BuildsMainAndSidePots) {
+  auto players = makePlayers({50, 100, 300, 300});
+  SeatTable seats;
+  seats.load(players);
+  seats.bet(0, 50);
+  seats.bet(1, 100);
+  seats.bet(2, 300);
+  seats.call(3, 300);
+
+  SidePots pots;
+  pots.build(seats);
+  ASSERT_EQ(pots.size(), 3);
+  EXPECT_EQ(pots[0].total, 200u);
+  EXPECT_EQ(pots[0].contributors, 0b1111u);
+  EXPECT_EQ(pots[1].total, 150u);
+  EXPECT_EQ(pots[1].contributors, 0b1110u);
+  EXPECT_EQ(pots[2].total, 400u);
+  EXPECT_EQ(pots[2].contributors, 0b1100u);
+  EXPECT_EQ(pots.total(), 750u);
+
+  // The short stack has the best hand, seat 2 the second best.
+  std::array<HandValue, MAX_SEATS> values{};
+  values[0] = 7000;
+  values[1] = 10;
+  values[2] = 5000;
+  values[3] = 4000;
+  pots.settle(seats, values, 0);
+  EXPECT_EQ(seats.chipsOf(0), 200u);
+  EXPECT_EQ(seats.chipsOf(1), 0u);
+  EXPECT_EQ(seats.chipsOf(2), 550u);
+  EXPECT_EQ(seats.chipsOf(3), 0u);
+}
+
+// Folded chips stay in the pots, they just can't be won by the folder.
+TEST(SidePotsTest, FoldedChipsGoToThePotsTheyReach) {
+  auto players = makePlayers({100, 100, 40, 100});
+  SeatTable seats;
+  seats.load(players);
+  seats.bet(0, 80);
+  seats.fold(0);
+  seats.bet(1, 100);
+  seats.bet(2, 40);
+  seats.call(3, 100);
+
+  SidePots pots;
+  pots.build(seats);
+  ASSERT_EQ(pots.size(), 2);
+  EXPECT_EQ(pots[0].total, 160u);
+  EXPECT_EQ(pots[0].contributors, 0b1110u);
+  EXPECT_EQ(pots[1].total, 160u);
+  EXPECT_EQ(pots[1].contributors, 0b1010u);
+}
+
+// 3 winners of a 100 chip pot: 33 each, the odd chip left of the button.
+TEST(SidePotsTest, SplitsExactlyWithOddChips) {
+  auto players = makePlayers({25, 25, 25, 25});
+  SeatTable seats;
+  seats.load(players);
+  for (int seat = 0; seat < 4; seat++) {
+    seats.bet(seat, 25);
+  }
+
+  std::array<HandValue, MAX_SEATS> values{};
+  values[0] = 100;
+  values[1] = 3000;
+  values[2] = 3000;
+  values[3] = 3000;
+
+  SidePots pots;
+  pots.build(seats);
+  pots.settle(seats, values, 2);
+  EXPECT_EQ(seats.chipsOf(0), 0u);
+  EXPECT_EQ(seats.chipsOf(1), 33u);
+  EXPECT_EQ(seats.chipsOf(2), 33u);
+  EXPECT_EQ(seats.chipsOf(3), 34u);
+}
+
+TEST(SidePotsTest, LastPlayerTakesEverything) {
+  auto players = makePlayers({100, 100, 100});
+  SeatTable seats;
+  seats.load(players);
+  seats.bet(0, 5);
+  seats.bet(1, 10);
+  seats.bet(2, 60);
+  seats.fold(0);
+  seats.fold(1);
+
+  SidePots pots;
+  pots.build(seats);
+  pots.settle(seats, {}, 0);
+  EXPECT_EQ(pots.total(), 75u);
+  EXPECT_EQ(seats.chipsOf(2), 115u);
+}
+
+// Uneven stacks make all-ins common, no hand may create or destroy chips.
+TEST(SidePotsTest, GamesConserveChips) {
+  Xoshiro256 rng(21);
+  gameSettings settings;
+  std::vector<money> stacks = {20, 300, 45, 100, 7, 150};
+  auto players = makePlayers(stacks);
+
+  for (int hand = 0; hand < 5000; hand++) {
+    money total = 0;
+    for (std::size_t i = 0; i < players.size(); i++) {
+      money chips = stacks[(i + hand) % stacks.size()];
+      players[i]->setChips(chips);
+      total += chips;
+    }
+    positions pos;
+    pos.dealerPosition = hand % 6;
+    pos.posSB = (hand + 1) % 6;
+    pos.posBB = (hand + 2) % 6;
+
+    HeadlessGame game(players, settings, pos, hand);
+    for (position seat = 0; seat < 6; seat++) {
+      game.setStrategy(seat, randomStrategy(rng));
+    }
+    game.simulateHand();
+
+    money after = 0;
+    for (const auto &player : players) {
+      after += player->getChips();
+    }
+    ASSERT_EQ(after, total) << "hand " << hand;
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,24 @@
+#pragma once
+// Fixtures shared by the tests and poker_bench.
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+import player;
+import game;
+
+// "Player 0", "Player 1", ... with the given stacks, one per seat.
+inline playersPool makePlayers(const std::vector<money> &stacks) {
+  playersPool players;
+  for (std::size_t i = 0; i < stacks.size(); i++) {
+    players.push_back(
+        std::make_shared<Player>("Player " + std::to_string(i), stacks[i]));
+  }
+  return players;
+}
+
+// amount players with chips each.
+inline playersPool makePlayers(int amount, money chips = 100) {
+  return makePlayers(
+      std::vector<money>(static_cast<std::size_t>(amount), chips));
+}
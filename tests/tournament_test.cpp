@@ -0,0 +1,90 @@
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+import player;
+import game;
+import prng;
+import threadPool;
+import tournament;
+
+#include <gtest/gtest.h>
+#include "testHelpers.hpp"
+
+static TournamentResults run(std::size_t threads, std::size_t tables,
+                             std::uint64_t seed) {
+  gameSettings settings;
+  settings.maximumRounds = 200;
+  ThreadPool pool(threads);
+  return runTournaments(
+      pool, tables, seed, settings,
+      [](position, Xoshiro256 &rng) { return randomStrategy(rng); });
+}
+
+TEST(TournamentTest, ResultsDontDependOnThreads) {
+  TournamentResults single = run(1, 40, 7);
+  TournamentResults several = run(4, 40, 7);
+  ASSERT_EQ(single.tables.size(), 40u);
+  ASSERT_EQ(several.tables.size(), 40u);
+  for (std::size_t table = 0; table < 40; table++) {
+    EXPECT_EQ(single.tables[table].seed, tableSeed(7, table));
+    EXPECT_EQ(single.tables[table].seed, several.tables[table].seed);
+    EXPECT_EQ(single.tables[table].hands, several.tables[table].hands);
+    EXPECT_EQ(single.tables[table].stacks, several.tables[table].stacks);
+  }
+  EXPECT_EQ(single.hands, several.hands);
+  EXPECT_EQ(single.wins, several.wins);
+}
+
+TEST(TournamentTest, AggregatesTables) {
+  gameSettings settings;
+  TournamentResults results = run(3, 25, 1);
+
+  std::size_t hands = 0;
+  std::size_t wins = 0;
+  for (const auto &table : results.tables) {
+    EXPECT_GT(table.hands, 0u);
+    EXPECT_LE(table.hands, 200u);
+    money chips = 0;
+    for (money stack : table.stacks) {
+      chips += stack;
+      EXPECT_LE(stack, table.stacks[table.winner]);
+    }
+    EXPECT_EQ(chips, settings.startingChips * table.stacks.size());
+    hands += table.hands;
+  }
+  for (std::size_t won : results.wins) {
+    wins += won;
+  }
+  EXPECT_EQ(results.hands, hands);
+  EXPECT_EQ(wins, 25u);
+  EXPECT_GT(results.tablesPerSecond(), 0);
+}
+
+TEST(TournamentTest, DifferentSeedsPlayDifferently) {
+  EXPECT_NE(run(2, 10, 1).hands, run(2, 10, 2).hands);
+}
+
+// Every index runs exactly once, also when a few tasks take much longer.
+TEST(TournamentTest, ThreadPoolStealsUnevenWork) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> runs(1000);
+  std::atomic<std::uint64_t> sink{0};
+  pool.parallelFor(runs.size(), [&](std::size_t task) {
+    std::uint64_t work = task < 10 ? 200000 : 10;
+    std::uint64_t sum = 0;
+    for (std::uint64_t i = 0; i < work; i++) {
+      sum += i * task;
+    }
+    sink += sum;
+    runs[task]++;
+  });
+  for (const auto &count : runs) {
+    EXPECT_EQ(count.load(), 1);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}